@@ -0,0 +1,155 @@
+/**
+ * \file Poly2D_test.cc
+ *
+ * \brief Checks and times the Poly2D overlap tests on the polygons of poly2d_polygons.txt
+ *
+ * PolyOverlap must agree with PolyOverlapSegments on every pair, except for pairs
+ * listed as touching, which PolyOverlap does not count as overlapping.
+ * Contained and Overlap must agree with their vertex-by-vertex definitions.
+ */
+
+#include "ubreco/ShowerReco/TwoDimTools/Poly2D.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using twodimtools::Poly2D;
+
+namespace {
+
+  // number of times all pairs are tested for the timing
+  const int kRepeat = 200;
+
+  // every vertex of poly2 inside poly1
+  bool ContainedByVertices(const Poly2D& poly1, const Poly2D& poly2)
+  {
+    for (unsigned int i = 0; i < poly2.Size(); i++)
+      if ( !poly1.PointInside(poly2.Point(i)) ) return false;
+    return true;
+  }
+
+  // any vertex of poly2 inside poly1
+  bool OverlapByVertices(const Poly2D& poly1, const Poly2D& poly2)
+  {
+    for (unsigned int i = 0; i < poly2.Size(); i++)
+      if ( poly1.PointInside(poly2.Point(i)) ) return true;
+    return false;
+  }
+
+  template<typename F>
+  double TimePairs(const std::vector<Poly2D>& poly_v, F f)
+  {
+    size_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRepeat; r++)
+      for (auto const& poly1 : poly_v)
+	for (auto const& poly2 : poly_v)
+	  count += f(poly1, poly2);
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    // keep the loop from being optimised away
+    if (count == size_t(-1)) std::cout << count << std::endl;
+    return t.count() * 1.e9 / (kRepeat * poly_v.size() * poly_v.size());
+  }
+
+}
+
+int main(int argc, char** argv)
+{
+  std::string fname = (argc > 1 ? argv[1] : "poly2d_polygons.txt");
+  std::ifstream in(fname);
+  if (!in) {
+    std::cerr << "cannot open " << fname << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> name_v;
+  std::vector<Poly2D> poly_v;
+  std::map<std::string, size_t> index;
+  std::set< std::pair<size_t, size_t> > touch;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    if ( !(ss >> key) || key[0] == '#' ) continue;
+    if (key == "poly") {
+      std::string name;
+      ss >> name;
+      std::vector< std::pair<float, float> > points;
+      float x, y;
+      while (ss >> x >> y) points.emplace_back(x, y);
+      index[name] = poly_v.size();
+      name_v.push_back(name);
+      poly_v.emplace_back(points);
+    }
+    else if (key == "touch") {
+      std::string name1, name2;
+      ss >> name1 >> name2;
+      if ( !index.count(name1) || !index.count(name2) ) {
+	std::cerr << "unknown polygon in: " << line << std::endl;
+	return 1;
+      }
+      touch.emplace(index[name1], index[name2]);
+      touch.emplace(index[name2], index[name1]);
+    }
+  }
+
+  int nfail = 0;
+  size_t noverlap = 0;
+  for (size_t i = 0; i < poly_v.size(); i++) {
+    for (size_t j = 0; j < poly_v.size(); j++) {
+      if (i == j) continue;
+      auto const& poly1 = poly_v[i];
+      auto const& poly2 = poly_v[j];
+      std::string pair = name_v[i] + " / " + name_v[j];
+
+      bool fast  = poly1.PolyOverlap(poly2);
+      bool exact = poly1.PolyOverlapSegments(poly2);
+      noverlap += fast;
+      if ( touch.count(std::make_pair(i, j)) ) {
+	if (fast) {
+	  std::cerr << "PolyOverlap true for touching polygons " << pair << std::endl;
+	  nfail++;
+	}
+      }
+      else if (fast != exact) {
+	std::cerr << "PolyOverlap " << fast << " PolyOverlapSegments " << exact
+		  << " for " << pair << std::endl;
+	nfail++;
+      }
+
+      if ( poly1.Contained(poly2) != ContainedByVertices(poly1, poly2) ) {
+	std::cerr << "Contained disagrees with its vertices for " << pair << std::endl;
+	nfail++;
+      }
+      if ( poly1.Overlap(poly2) != OverlapByVertices(poly1, poly2) ) {
+	std::cerr << "Overlap disagrees with its vertices for " << pair << std::endl;
+	nfail++;
+      }
+    }
+  }
+
+  std::cout << poly_v.size() << " polygons, " << noverlap << " overlapping ordered pairs" << std::endl;
+  std::cout << "PolyOverlap         : "
+	    << TimePairs(poly_v, [](const Poly2D& a, const Poly2D& b){ return a.PolyOverlap(b); })
+	    << " ns/pair" << std::endl;
+  std::cout << "PolyOverlapSegments : "
+	    << TimePairs(poly_v, [](const Poly2D& a, const Poly2D& b){ return a.PolyOverlapSegments(b); })
+	    << " ns/pair" << std::endl;
+  std::cout << "Contained           : "
+	    << TimePairs(poly_v, [](const Poly2D& a, const Poly2D& b){ return a.Contained(b); })
+	    << " ns/pair" << std::endl;
+
+  if (nfail) {
+    std::cerr << nfail << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * \file FixedBinHistogram_test.cc
+ *
+ * \brief Checks and times wcopreco::FixedBinHistogram against TH1F
+ *
+ * The histograms are filled the way Saturation_Merger::findBaselineLg,
+ * Deconvolver::Remove_Baseline_Secondary and Deconvolver::cal_mean_rms fill
+ * them, and the mode and quantiles they read back must be the same as with TH1F.
+ */
+
+#include "ubreco/wcopreco/data/FixedBinHistogram.h"
+
+#include "TH1F.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using wcopreco::FixedBinHistogram;
+
+namespace {
+
+  int nfail = 0;
+
+  void Check(bool ok, const std::string& what, int trial, double fixed, double th1)
+  {
+    if (ok) return;
+    std::cerr << what << " differs in trial " << trial << ": FixedBinHistogram "
+	      << fixed << " TH1F " << th1 << std::endl;
+    nfail++;
+  }
+
+  // findBaselineLg: low gain ADC counts in the baseline search window
+  void TestBaselineLg(std::mt19937& rng, int trial)
+  {
+    const double low = 1500, high = 2500;
+    std::normal_distribution<double> adc(2050, 3);
+    FixedBinHistogram<1000> h(low-0.5, high-0.5);
+    TH1F th1("hlg", "", 1000, low-0.5, high-0.5);
+    for (int i = 0; i < 20; i++) {
+      double content = std::round(adc(rng));
+      if (trial % 5 == 0 && i % 7 == 3) content += 800; // pulse in the window
+      if (content > low && content < high) { h.Fill(content); th1.Fill(content); }
+    }
+    double fixed = h.GetBinCenter(h.GetMaximumBin()+1);
+    double ref   = th1.GetBinCenter(th1.GetMaximumBin()+1);
+    Check(fixed == ref, "findBaselineLg baseline", trial, fixed, ref);
+  }
+
+  // Remove_Baseline_Secondary: first bins of a deconvolved waveform, some outside the range
+  void TestBaselineSecondary(std::mt19937& rng, int trial)
+  {
+    std::normal_distribution<double> noise(trial % 11 - 5, 4);
+    FixedBinHistogram<200> h(-100, 100);
+    TH1F th1("hsec", "", 200, -100, 100);
+    for (int j = 0; j < 20; j++) {
+      double content = noise(rng);
+      if (trial % 4 == 0 && j % 6 == 1) content *= 40; // under/overflow
+      h.Fill(content);
+      th1.Fill(content);
+    }
+    Check(h.GetMaximumBin() == th1.GetMaximumBin(), "Remove_Baseline_Secondary maximum bin",
+	  trial, h.GetMaximumBin(), th1.GetMaximumBin());
+  }
+
+  // cal_mean_rms: waveform values within 10 of zero, mode and the xq, xq -/+ xq_diff quantiles
+  void TestMeanRms(std::mt19937& rng, int trial)
+  {
+    const double xq = 0.5, xq_diff = 0.34;
+    int nbin = 20 + (trial * 37) % 1500;
+    std::normal_distribution<double> noise(0.1 * (trial % 7), 0.2 + 0.1 * (trial % 30));
+    FixedBinHistogram<2000> h(-10, 10);
+    TH1F th1("hrms", "", 2000, -10, 10);
+    for (int i = 0; i < nbin; i++) {
+      double content = noise(rng);
+      // quantised waveforms put many entries on the same bins
+      if (trial % 3 == 0) content = std::round(content * 4) / 4;
+      if (std::fabs(content) < 10) { h.Fill(content); th1.Fill(content); }
+    }
+    double fixed = h.GetBinCenter(h.GetMaximumBin()+1);
+    double ref   = th1.GetBinCenter(th1.GetMaximumBin()+1);
+    Check(fixed == ref, "cal_mean_rms mean", trial, fixed, ref);
+    Check(h.Integral() == th1.Integral(), "cal_mean_rms integral", trial, h.Integral(), th1.Integral());
+    if (th1.Integral() == 0.) return;
+
+    double prob[3] = { xq - xq_diff, xq, xq + xq_diff };
+    for (auto p : prob) {
+      double qfixed = 0, qth1 = 0;
+      h.GetQuantiles(1, &qfixed, &p);
+      th1.GetQuantiles(1, &qth1, &p);
+      Check(std::fabs(qfixed - qth1) < 1.e-12, "cal_mean_rms quantile " + std::to_string(p), trial, qfixed, qth1);
+    }
+  }
+
+  // fill and read back a cal_mean_rms histogram n times, return the time per waveform in us
+  template<typename H>
+  double TimeMeanRms(const std::vector<double>& wfm, int n, H make)
+  {
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < n; r++) {
+      auto h = make();
+      for (auto content : wfm)
+	if (std::fabs(content) < 10) h->Fill(content);
+      double arg = 0.5, q = 0;
+      h->GetQuantiles(1, &q, &arg);
+      sum += h->GetBinCenter(h->GetMaximumBin()+1) + q;
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    // keep the loop from being optimised away
+    if (std::isnan(sum)) std::cout << sum << std::endl;
+    return t.count() * 1.e6 / n;
+  }
+
+}
+
+int main()
+{
+  TH1::AddDirectory(false);
+
+  std::mt19937 rng(2003);
+  for (int trial = 0; trial < 500; trial++) {
+    TestBaselineLg(rng, trial);
+    TestBaselineSecondary(rng, trial);
+    TestMeanRms(rng, trial);
+  }
+
+  std::normal_distribution<double> noise(0, 1.5);
+  std::vector<double> wfm(1500);
+  for (auto& content : wfm) content = noise(rng);
+  const int n = 2000;
+  std::cout << "cal_mean_rms histogram, 1500 entries" << std::endl;
+  std::cout << "FixedBinHistogram : "
+	    << TimeMeanRms(wfm, n, [](){ return std::make_unique< FixedBinHistogram<2000> >(-10, 10); })
+	    << " us" << std::endl;
+  std::cout << "TH1F              : "
+	    << TimeMeanRms(wfm, n, [](){ return std::make_unique<TH1F>("h4", "h4", 2000, -10, 10); })
+	    << " us" << std::endl;
+
+  if (nfail) {
+    std::cerr << nfail << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include <fstream>
+#include <algorithm>
 #include "ubreco/BlipReco/Alg/BlipRecoAlg.h"
 
 #include "larcore/Geometry/WireReadout.h"
@@ -564,7 +565,12 @@ namespace blip {
     // Hit clustering
     // ---------------------------------------------------
     std::map<int,std::map<int,std::vector<int>>> tpc_planeclustsMap;
+    std::vector<int> hitGroup, hitBorder;
+    std::vector<int> hitTouch(hitlist.size(),-1);
+    std::vector<int> hitVisit(hitlist.size(),-1);
+    PlaneHitIndex planeIndex;
     for(auto const& planehits : planehitsMap){
+      BuildPlaneHitIndex(planehits.second, planeIndex);
       for(auto const& hi : planehits.second ){
         
         // select a new seed hit;
@@ -574,61 +580,36 @@ namespace blip {
         // initialize a new cluster with this hit as seed
         std::set<int> hitIDs;
         hitIDs        .insert(hi);
-        int startWire = hitinfo[hi].wire;
-        int endWire   = hitinfo[hi].wire;
         hitIsClustered[hi] = true;
         bool clustIsValid = true;
 
-        // see if we can add other hits to it; continue until 
-        // no new hits can be lumped in with this clust
-        int hitsAdded;
-        do{
-          hitsAdded = 0;  
-          for(auto const& hj : planehits.second ) {
-            
-            // skip hits already clustered
-            if( hitIsClustered[hj] ) continue;
-
-            // skip hits outside overall cluster wire range
-            int w1 = hitinfo[hj].wire - fHitClustWireRange;
-            int w2 = hitinfo[hj].wire + fHitClustWireRange;
-            if( w2 < startWire    || w1 > endWire ) continue;
-            
-            // check for proximity with every other hit added
-            // to this cluster so far
-            for(auto const& hii : hitIDs ) {
-
-              if( hitinfo[hii].wire > w2 ) continue;
-              if( hitinfo[hii].wire < w1 ) continue;
-              float t1 = hitinfo[hj].driftTime;
-              float t2 = hitinfo[hii].driftTime;
-              float rms_sum = (hitinfo[hii].rms + hitinfo[hj].rms);
-              if( fabs(t1-t2) > fHitClustWidthFact * rms_sum ) continue;
-              
-              // If a single bad hit is attempted to be added,
-              // the entire cluster is tainted! Throw it out!
-              if( hitIsBad[hj] ) { clustIsValid = false; break; }
-      
-              // if the hit we are checking is touching a track
-              // take note of this so we can encode this info into
-              // the cluster later on for delta-ray ID
-              if( hitIsTracked[hj] ) {
-                hitinfo[hii].touchTrk   = true;
-                hitinfo[hii].touchTrkID = hitinfo[hj].trkid;
-                continue;
-              }
-            
-              startWire = std::min( hitinfo[hj].wire, startWire );
-              endWire   = std::max( hitinfo[hj].wire, endWire );
-              hitIDs.insert(hj);
-              hitIsClustered[hj] = true;
-              hitsAdded++;
-              break;
+        // find all unclustered hits connected to the seed, plus the
+        // bad/tracked hits bordering them, using the wire-time index
+        bool touchesBad = FindHitGroup(hi, planeIndex, hitIsClustered, hitIsBad, hitIsTracked, 
+                                       hitGroup, hitBorder, hitTouch, hitVisit);
+        if( !touchesBad ) {
+          // the cluster grows into exactly this group
+          for(auto const& hj : hitGroup ) {
+            hitIDs.insert(hj);
+            hitIsClustered[hj] = true;
+          }
+          // flag hits touching a track (delta-ray ID); the last
+          // tracked hit in the plane's hit order sets the track ID
+          for(auto const& hj : hitIDs ) {
+            if( hitTouch[hj] >= 0 ) {
+              hitinfo[hj].touchTrk   = true;
+              hitinfo[hj].touchTrkID = hitinfo[hitTouch[hj]].trkid;
             }
-          
-            if( !clustIsValid ) break;
           }
-        } while ( hitsAdded!=0 && clustIsValid );
+        } else {
+          // A bad hit taints the cluster at the point the growth reaches it,
+          // leaving behind however many hits were absorbed until then. Redo
+          // the hit-by-hit growth on this neighborhood to get that right.
+          std::vector<int> neighborhood(hitGroup);
+          neighborhood.insert(neighborhood.end(),hitBorder.begin(),hitBorder.end());
+          std::sort(neighborhood.begin(),neighborhood.end());
+          clustIsValid = GrowHitClust(neighborhood, hitIDs, hitIsClustered, hitIsBad, hitIsTracked);
+        }
         
         if( !clustIsValid ) continue;
 
@@ -719,6 +700,13 @@ namespace blip {
     
     float _matchQDiffLimit= (fMatchQDiffLimit <= 0 ) ? std::numeric_limits<float>::max() : fMatchQDiffLimit;
     float _matchMaxQRatio = (fMatchMaxQRatio  <= 0 ) ? std::numeric_limits<float>::max() : fMatchMaxQRatio;
+
+    // Clusters that don't overlap in time have overlap fraction -1, so unless
+    // the overlap cut lets those through, only clusters within the time window
+    // of the seed need to be checked. The window is widened by a tick so that
+    // float round-off in CalcOverlap can never matter.
+    bool  useTimeWindow   = ( fMatchMinOverlap > -1 );
+    float windowTol       = 1.;
      
     for(auto& tpcMap : tpc_planeclustsMap ) { // loop on TPCs
      
@@ -726,6 +714,25 @@ namespace blip {
       if( planeMap.find(fCaloPlane) != planeMap.end() ){
         int   planeA              = fCaloPlane;
         auto&  hitclusts_planeA   = planeMap[planeA];
+
+        // index clusters on each plane by start time
+        PlaneClustIndex clustIndex[kNplanes];
+        for(auto& hitclusts_plane : planeMap ) {
+          auto& index = clustIndex[hitclusts_plane.first];
+          index.clusts.reserve(hitclusts_plane.second.size());
+          for(auto const& j : hitclusts_plane.second ) {
+            auto& hc = hitclust[j];
+            index.clusts.emplace_back(hc.StartTime,j);
+            index.maxSpan = std::max(index.maxSpan, hc.EndTime - hc.StartTime);
+            if( hc.EndTime < hc.StartTime ) index.ordered = false;
+            if( !hc.isMatched ) index.nUnmatched++;
+          }
+          std::sort(index.clusts.begin(),index.clusts.end());
+        }
+        
+        // candidate matches on each of the other planes
+        std::vector<MatchCand> cands[kNplanes];
+        std::vector<int> clustsInWindow;
         
         for(auto& i : hitclusts_planeA ) {
           auto& hcA = hitclust[i];
@@ -734,14 +741,7 @@ namespace blip {
           std::vector<blip::HitClust> hcGroup;
           hcGroup.push_back(hcA);
 
-          // for each of the other planes, make a map of potential matches
-          std::map<int, std::set<int>> cands;
-         
-          // map of cluster ID <--> match metrics
-          std::map<int, float> map_clust_dtfrac;
-          std::map<int, float> map_clust_dt;
-          std::map<int, float> map_clust_overlap;
-          std::map<int, float> map_clust_score;
+          for(auto& c : cands ) c.clear();
 
           // ---------------------------------------------------
           // loop over other planes
@@ -749,10 +749,30 @@ namespace blip {
             int planeB = hitclusts_planeB.first;
             if( planeB == planeA ) continue;
 
+            // restrict to clusters starting within [start - max span, end] of hcA
+            auto& index = clustIndex[planeB];
+            auto  first = index.clusts.cbegin();
+            auto  last  = index.clusts.cend();
+            bool  windowed = ( useTimeWindow && index.ordered );
+            if( windowed ) {
+              float tmin = hcA.StartTime - windowTol - index.maxSpan;
+              float tmax = hcA.EndTime   + windowTol;
+              first = std::lower_bound(first,last,std::make_pair(tmin,std::numeric_limits<int>::min()));
+              last  = std::upper_bound(first,last,std::make_pair(tmax,std::numeric_limits<int>::max()));
+            }
+            
+            // keep the original cluster order so histograms and ties come out the same
+            clustsInWindow.clear();
+            for(auto it = first; it != last; ++it ) clustsInWindow.push_back(it->second);
+            std::sort(clustsInWindow.begin(),clustsInWindow.end());
+            
             // Loop over all non-matched clusts on this plane
-            for(auto const& j : hitclusts_planeB.second ) {
+            int nChecked = 0;
+            for(auto const& j : clustsInWindow ) {
               auto& hcB = hitclust[j];
               if( hcB.isMatched ) continue;
+              if( windowed && hcB.EndTime < hcA.StartTime - windowTol ) continue;
+              nChecked++;
               
               // ***********************************
               // Calculate the cluster overlap
@@ -764,11 +784,11 @@ namespace blip {
               // *******************************************
               // Check that the two central wires intersect
               // *******************************************
-              auto intersection = wireReadout.ChannelsIntersect(hcA.CenterChan, hcB.CenterChan);
-              if( !intersection ) continue;
+              auto const& intersection = GetChanIntersect(wireReadout, hcA.CenterChan, hcB.CenterChan);
+              if( !intersection.valid ) continue;
               // Save intersect location, so we don't have to
               // make another call to the Geometry service later
-              TVector3 xloc(0,intersection->y,intersection->z);
+              TVector3 xloc(0,intersection.y,intersection.z);
               hcA.IntersectLocations[hcB.ID] = xloc;
               hcB.IntersectLocations[hcA.ID] = xloc;
               
@@ -803,29 +823,32 @@ namespace blip {
               // we can use later in the case of degenerate matches.
               // **************************************************
               float score = overlapFrac * exp(-fabs(ratio-1.)) * exp(-fabs(dt)/float(fMatchMaxTicks));
-              map_clust_dt[j]       = dt;
-              map_clust_dtfrac[j]   = dtfrac;
-              map_clust_overlap[j]  = overlapFrac;
-              map_clust_score[j]    = score;
-              cands[planeB]         .insert(j);
+              cands[planeB].push_back({j, dt, dtfrac, overlapFrac, score});
             
             }
+            
+            // clusters skipped by the time window would have been
+            // filled with overlap fraction -1 (underflow)
+            AddUnderflow(h_clust_overlap[planeB], index.nUnmatched - nChecked);
               
           }//endloop over other planes
           
           // ---------------------------------------------------
           // loop over the candidates found on each plane
           // and select the one with the largest score
-          if( cands.size() ) {
-            for(auto& c : cands ) {
-              int plane = c.first;
-              h_nmatches[plane]->Fill(c.second.size());
+          bool hasCands = false;
+          for(auto& c : cands ) hasCands |= !c.empty();
+          if( hasCands ) {
+            for(int plane = 0; plane < kNplanes; plane++ ) {
+              auto& c = cands[plane];
+              if( c.empty() ) continue;
+              h_nmatches[plane]->Fill(c.size());
               float bestScore   = -9;
               int   bestID      = -9;
-              for(auto cid : c.second) {
-                if( map_clust_score[cid] > bestScore ) {
-                  bestScore = map_clust_score[cid];
-                  bestID = cid;
+              for(auto const& cand : c ) {
+                if( cand.score > bestScore ) {
+                  bestScore = cand.score;
+                  bestID = cand.id;
                 }
               }
               if( bestID >= 0 ) hcGroup.push_back(hitclust[bestID]);
@@ -844,6 +867,7 @@ namespace blip {
             // ----------------------------------------
             // save matching information
             for(auto& hc : hcGroup ) {
+              if( !hitclust[hc.ID].isMatched ) clustIndex[hc.Plane].nUnmatched--;
               hitclust[hc.ID].isMatched = true;
               for(auto hit : hitclust[hc.ID].HitIDs) hitinfo[hit].ismatch = true;
             
@@ -853,9 +877,10 @@ namespace blip {
                 if( ipl == fCaloPlane ) continue;
                 float q1 = (float)newBlip.clusters[fCaloPlane].Charge;
                 float q2 = (float)newBlip.clusters[ipl].Charge;
-                h_clust_picky_overlap[ipl]->Fill(map_clust_overlap[hc.ID]);
-                h_clust_picky_dtfrac[ipl] ->Fill(map_clust_dtfrac[hc.ID]);
-                h_clust_picky_dt[ipl]     ->Fill(map_clust_dt[hc.ID]);
+                auto cand = FindMatchCand(cands[ipl],hc.ID);
+                h_clust_picky_overlap[ipl]->Fill(cand->overlap);
+                h_clust_picky_dtfrac[ipl] ->Fill(cand->dtfrac);
+                h_clust_picky_dt[ipl]     ->Fill(cand->dt);
                 h_clust_picky_q[ipl]  ->Fill(0.001*q1,0.001*q2);
               }
             }
@@ -1039,6 +1064,182 @@ namespace blip {
  
   
   
+  //###########################################################
+  // Hit clustering helpers
+  //###########################################################
+  void BlipRecoAlg::BuildPlaneHitIndex(const std::vector<int>& planehits, PlaneHitIndex& index) const {
+    index.hits = planehits;
+    index.maxRMS = 0;
+    int maxWire = -1;
+    for(auto const& h : planehits ) {
+      maxWire = std::max( hitinfo[h].wire, maxWire );
+      index.maxRMS = std::max( hitinfo[h].rms, index.maxRMS );
+    }
+    std::sort(index.hits.begin(), index.hits.end(), [this](int a, int b) {
+      if( hitinfo[a].wire != hitinfo[b].wire ) return hitinfo[a].wire < hitinfo[b].wire;
+      if( hitinfo[a].driftTime != hitinfo[b].driftTime ) return hitinfo[a].driftTime < hitinfo[b].driftTime;
+      return a < b;
+    });
+    index.wireStart.assign(maxWire+2,0);
+    for(auto const& h : index.hits ) index.wireStart[hitinfo[h].wire+1]++;
+    for(size_t w=1; w<index.wireStart.size(); w++) index.wireStart[w] += index.wireStart[w-1];
+  }
+
+  // proximity criterion of two hits (symmetric)
+  bool BlipRecoAlg::HitsAreClose(int hii, int hj) const {
+    int w1 = hitinfo[hj].wire - fHitClustWireRange;
+    int w2 = hitinfo[hj].wire + fHitClustWireRange;
+    if( hitinfo[hii].wire > w2 ) return false;
+    if( hitinfo[hii].wire < w1 ) return false;
+    float t1 = hitinfo[hj].driftTime;
+    float t2 = hitinfo[hii].driftTime;
+    float rms_sum = (hitinfo[hii].rms + hitinfo[hj].rms);
+    if( fabs(t1-t2) > fHitClustWidthFact * rms_sum ) return false;
+    return true;
+  }
+
+  // Flood-fill from the seed through unclustered good hits. Returns true if any
+  // bad hit borders the group. 'group' gets the connected hits (seed excluded),
+  // 'border' the bad/tracked hits next to them, and touch[h] the highest-ID
+  // tracked hit next to each group hit h (-1 if none).
+  bool BlipRecoAlg::FindHitGroup(int seed, const PlaneHitIndex& index, 
+                                 const std::vector<bool>& hitIsClustered,
+                                 const std::vector<bool>& hitIsBad,
+                                 const std::vector<bool>& hitIsTracked,
+                                 std::vector<int>& group, std::vector<int>& border,
+                                 std::vector<int>& touch, std::vector<int>& visit) {
+    group.clear();
+    border.clear();
+    bool touchesBad = false;
+    int  maxWire    = (int)index.wireStart.size()-2;
+    visit[seed]     = seed;
+    touch[seed]     = -1;
+    for(size_t n=0; n<=group.size(); n++){
+      int hii = ( n == 0 ) ? seed : group[n-1];
+      float t = hitinfo[hii].driftTime;
+      // generous window in time, the exact cut is applied by HitsAreClose
+      double dtmax = fHitClustWidthFact * (hitinfo[hii].rms + index.maxRMS) * (1.+1e-4) + 1e-3;
+      int wmin = std::max( hitinfo[hii].wire - fHitClustWireRange, 0 );
+      int wmax = std::min( hitinfo[hii].wire + fHitClustWireRange, maxWire );
+      for(int w = wmin; w <= wmax; w++) {
+        auto first = index.hits.begin() + index.wireStart[w];
+        auto last  = index.hits.begin() + index.wireStart[w+1];
+        auto it    = std::lower_bound(first, last, t - dtmax, 
+          [this](int h, double tt) { return hitinfo[h].driftTime < tt; });
+        for(; it != last && hitinfo[*it].driftTime <= t + dtmax; ++it) {
+          int hj = *it;
+          if( hitIsClustered[hj] ) continue;
+          if( !HitsAreClose(hii,hj) ) continue;
+          if( hitIsBad[hj] ) {
+            touchesBad = true;
+          } else if( hitIsTracked[hj] ) {
+            touch[hii] = std::max( hj, touch[hii] );
+          } else if( visit[hj] != seed ) {
+            visit[hj] = seed;
+            touch[hj] = -1;
+            group.push_back(hj);
+            continue;
+          } else {
+            continue;
+          }
+          if( visit[hj] != seed ) {
+            visit[hj] = seed;
+            border.push_back(hj);
+          }
+        }
+      }
+    }
+    return touchesBad;
+  }
+
+  // Hit-by-hit cluster growth, scanning 'hits' in order until nothing can be added.
+  // Returns false if the cluster was tainted by a bad hit.
+  bool BlipRecoAlg::GrowHitClust(const std::vector<int>& hits, std::set<int>& hitIDs,
+                                 std::vector<bool>& hitIsClustered,
+                                 const std::vector<bool>& hitIsBad,
+                                 const std::vector<bool>& hitIsTracked) {
+    int startWire = hitinfo[*hitIDs.begin()].wire;
+    int endWire   = startWire;
+    bool clustIsValid = true;
+
+    // see if we can add other hits to it; continue until 
+    // no new hits can be lumped in with this clust
+    int hitsAdded;
+    do{
+      hitsAdded = 0;  
+      for(auto const& hj : hits ) {
+        
+        // skip hits already clustered
+        if( hitIsClustered[hj] ) continue;
+
+        // skip hits outside overall cluster wire range
+        int w1 = hitinfo[hj].wire - fHitClustWireRange;
+        int w2 = hitinfo[hj].wire + fHitClustWireRange;
+        if( w2 < startWire    || w1 > endWire ) continue;
+        
+        // check for proximity with every other hit added
+        // to this cluster so far
+        for(auto const& hii : hitIDs ) {
+
+          if( !HitsAreClose(hii,hj) ) continue;
+          
+          // If a single bad hit is attempted to be added,
+          // the entire cluster is tainted! Throw it out!
+          if( hitIsBad[hj] ) { clustIsValid = false; break; }
+  
+          // if the hit we are checking is touching a track
+          // take note of this so we can encode this info into
+          // the cluster later on for delta-ray ID
+          if( hitIsTracked[hj] ) {
+            hitinfo[hii].touchTrk   = true;
+            hitinfo[hii].touchTrkID = hitinfo[hj].trkid;
+            continue;
+          }
+        
+          startWire = std::min( hitinfo[hj].wire, startWire );
+          endWire   = std::max( hitinfo[hj].wire, endWire );
+          hitIDs.insert(hj);
+          hitIsClustered[hj] = true;
+          hitsAdded++;
+          break;
+        }
+      
+        if( !clustIsValid ) break;
+      }
+    } while ( hitsAdded!=0 && clustIsValid );
+
+    return clustIsValid;
+  }
+
+  // Central-wire intersection of two channels, computed once per channel pair
+  const BlipRecoAlg::ChanIntersect& BlipRecoAlg::GetChanIntersect(geo::WireReadoutGeom const& wireReadout,
+                                                                  int chA, int chB) {
+    uint64_t key = (uint64_t(uint32_t(chA)) << 32) | uint32_t(chB);
+    auto it = fChanIntersectCache.find(key);
+    if( it != fChanIntersectCache.end() ) return it->second;
+    ChanIntersect xing{false,0.,0.};
+    if( auto intersection = wireReadout.ChannelsIntersect(chA,chB) ) {
+      xing.valid = true;
+      xing.y     = intersection->y;
+      xing.z     = intersection->z;
+    }
+    return fChanIntersectCache.emplace(key,xing).first->second;
+  }
+
+  // Match metrics of cluster 'id' in the candidate list (nullptr if absent)
+  const BlipRecoAlg::MatchCand* BlipRecoAlg::FindMatchCand(const std::vector<MatchCand>& cands, int id) const {
+    for(auto const& c : cands ) if( c.id == id ) return &c;
+    return nullptr;
+  }
+
+  // Same as calling h->Fill() 'n' times with a value below the axis range
+  void BlipRecoAlg::AddUnderflow(TH1D* h, int n) const {
+    if( n <= 0 ) return;
+    h->AddBinContent(0,n);
+    if( h->GetSumw2N() ) h->GetSumw2()->fArray[0] += n;
+    h->SetEntries(h->GetEntries()+n);
+  }
+  
   //###########################################################
   float BlipRecoAlg::ModBoxRecomb(float dEdx, float Efield) {
     float rho = detProp.Density();
@@ -35,6 +35,7 @@
 #include "lardataobj/AnalysisBase/BackTrackerMatchingData.h"
 #include "larsim/MCCheater/ParticleInventoryService.h"
 #include "larcore/Geometry/Geometry.h"
+#include "larcore/Geometry/WireReadout.h"
 #include "larreco/Calorimetry/CalorimetryAlg.h"
 
 // Microboone includes
@@ -58,6 +59,10 @@
 
 // c++
 #include <vector>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <math.h>
@@ -107,6 +112,47 @@ namespace blip {
    private:
     
     const detinfo::DetectorPropertiesData detProp;
+
+    // --- Hit clustering ---
+    // Hits on one plane sorted by (wire, drift time) for neighbor lookups
+    struct PlaneHitIndex {
+      std::vector<int>  hits;       // hit IDs sorted by wire, then drift time
+      std::vector<int>  wireStart;  // offset into 'hits' of each wire (size = max wire + 2)
+      float             maxRMS = 0;
+    };
+    void    BuildPlaneHitIndex(const std::vector<int>&, PlaneHitIndex&) const;
+    bool    HitsAreClose(int, int) const;
+    bool    FindHitGroup(int, const PlaneHitIndex&, const std::vector<bool>&, const std::vector<bool>&,
+                         const std::vector<bool>&, std::vector<int>&, std::vector<int>&, std::vector<int>&, std::vector<int>&);
+    bool    GrowHitClust(const std::vector<int>&, std::set<int>&, std::vector<bool>&,
+                         const std::vector<bool>&, const std::vector<bool>&);
+
+    // --- Plane matching ---
+    // Clusters on one plane sorted by start time for time-window lookups
+    struct PlaneClustIndex {
+      std::vector<std::pair<float,int>> clusts;   // (start time, cluster ID)
+      float             maxSpan     = 0;
+      int               nUnmatched  = 0;
+      bool              ordered     = true;       // false if any cluster has end < start
+    };
+    // Match metrics of a candidate cluster that passed all cuts
+    struct MatchCand {
+      int     id;
+      float   dt;
+      float   dtfrac;
+      float   overlap;
+      float   score;
+    };
+    // Intersection of two central channels (geometry is static, so cache it for the job)
+    struct ChanIntersect {
+      bool    valid;
+      double  y;
+      double  z;
+    };
+    const ChanIntersect& GetChanIntersect(geo::WireReadoutGeom const&, int, int);
+    const MatchCand*     FindMatchCand(const std::vector<MatchCand>&, int) const;
+    void    AddUnderflow(TH1D*, int) const;
+    std::unordered_map<uint64_t,ChanIntersect> fChanIntersectCache;
     
     float               mWion;
 
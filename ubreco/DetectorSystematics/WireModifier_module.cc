@@ -17,7 +17,9 @@
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include <array>
 #include <memory>
+#include <mutex>
 
 #include "lardataobj/RawData/RawDigit.h"
 #include "lardataobj/RecoBase/Wire.h"
@@ -26,6 +28,7 @@
 #include "larcoreobj/SimpleTypesAndConstants/PhysicalConstants.h"
 
 #include "lardata/Utilities/AssociationUtil.h"
+#include "ubreco/Utilities/ParallelFor.h"
 
 #include "TFile.h"
 #include "TSpline.h"
@@ -111,6 +114,16 @@ private:
   bool fApplyAdditionalTickOffset;
   bool fApplyAngleYZSigmaSpline;
 
+  size_t fNumThreads;     //wires modified in parallel
+  double fGaussianNSigma; //subROI gaussians are summed within +/- this many sigma (0: all ticks)
+
+  //TGraph2D interpolation caches its triangulation, so calls are serialised
+  std::mutex fGraph2DMutex;
+  double InterpolateYZ(TGraph2DErrors* graph, double z, double y){
+    std::lock_guard<std::mutex> lock(fGraph2DMutex);
+    return graph->Interpolate(z,y);
+  }
+
   //useful math things
   //static constexpr double ONE_OVER_SQRT_2PI = 1./std::sqrt(2*util::pi());
   double GAUSSIAN(double t, double mean,double sigma,double a=1.0){
@@ -127,8 +140,11 @@ private:
   static constexpr double PI_OVER_TWO = util::pi()/2.;
 
   typedef std::pair<unsigned int,unsigned int> ROI_Key_t;
-  std::map< ROI_Key_t,std::vector<size_t> > fROIMatchedEdepMap;
-  std::map< ROI_Key_t,std::vector<size_t> > fROIMatchedHitMap;
+
+  //matched edeps/hits per ROI, flat over all ROIs: the ROIs of wire i_w start at fROIOffset[i_w]
+  std::vector<size_t> fROIOffset;
+  std::vector< std::vector<size_t> > fROIMatchedEdeps;
+  std::vector< std::vector<size_t> > fROIMatchedHits;
   
   typedef struct ROIProperties{
     ROI_Key_t key;
@@ -179,6 +195,12 @@ private:
 
   } TruthProperties_t;
 
+  //ntuple entries made while modifying one wire, filled in wire order after the wire loop
+  typedef struct NtupleRows{
+    std::vector< std::array<float,2> > nt;
+    std::vector< std::array<float,13> > scale_check;
+  } NtupleRows_t;
+
   double FoldAngle(double theta)
   {
     double th = std::abs(theta);
@@ -227,22 +249,33 @@ private:
   std::vector< std::pair<unsigned int, unsigned int> > GetTargetROIs(sim::SimEnergyDeposit const&, double offset);
   std::vector< std::pair<unsigned int, unsigned int> > GetHitTargetROIs(recob::Hit const&);
   
+  void FillROIOffsets(std::vector<recob::Wire> const&);
   void FillROIMatchedEdepMap(std::vector<sim::SimEnergyDeposit> const&, std::vector<recob::Wire> const&, double offset);
   void FillROIMatchedHitMap(std::vector<recob::Hit> const&, std::vector<recob::Wire> const&);
 
   std::vector<SubROIProperties_t> CalcSubROIProperties(ROIProperties_t const&, std::vector<const recob::Hit*> const&);
 
-  std::map<SubROI_Key_t, std::vector<const sim::SimEnergyDeposit*>> MatchEdepsToSubROIs(std::vector<SubROIProperties_t> const&, std::vector<const sim::SimEnergyDeposit*> const&, double offset);
+  std::map<SubROI_Key_t, std::vector<const sim::SimEnergyDeposit*>> MatchEdepsToSubROIs(std::vector<SubROIProperties_t> const&, std::vector<const sim::SimEnergyDeposit*> const&, double offset, NtupleRows_t&);
 
-  TruthProperties_t CalcPropertiesFromEdeps(std::vector<const sim::SimEnergyDeposit*> const&, double offset);
+  TruthProperties_t CalcPropertiesFromEdeps(std::vector<const sim::SimEnergyDeposit*> const&, double offset, NtupleRows_t&);
 
   ScaleValues_t GetScaleValues(TruthProperties_t const&,ROIProperties_t const&);
   ScaleValues_t GetScaleValues(TruthProperties_t const&,unsigned int const&);
 
+  void AddGaussian(std::vector<double> &, float begin, size_t i_min, size_t i_max,
+		   double mean, double sigma, double a);
+
   void ModifyROI(std::vector<float> &,
 		 ROIProperties_t const &, 
 		 std::vector<SubROIProperties_t> const&,
-		 std::map<SubROI_Key_t, ScaleValues_t> const&);
+		 std::vector<ScaleValues_t> const&);
+
+  recob::Wire::RegionsOfInterest_t ModifyWire(size_t i_w,
+					      std::vector<recob::Wire> const&,
+					      std::vector<sim::SimEnergyDeposit> const& edepOrigVec,
+					      std::vector<sim::SimEnergyDeposit> const& edepShiftedVec,
+					      std::vector<recob::Hit> const&,
+					      double offset, NtupleRows_t&);
 
 };
 
@@ -322,10 +355,17 @@ sys::WireModifier::GetHitTargetROIs(recob::Hit const& hit)
   return target_roi_vec;
 }
 
+void sys::WireModifier::FillROIOffsets(std::vector<recob::Wire> const& wireVec)
+{
+  fROIOffset.assign(wireVec.size()+1,0);
+  for(size_t i_w=0; i_w<wireVec.size(); ++i_w)
+    fROIOffset[i_w+1] = fROIOffset[i_w] + wireVec[i_w].SignalROI().n_ranges();
+}
+
 void sys::WireModifier::FillROIMatchedEdepMap(std::vector<sim::SimEnergyDeposit> const& edepVec,
 					      std::vector<recob::Wire> const& wireVec, double offset)
 {
-  fROIMatchedEdepMap.clear();
+  fROIMatchedEdeps.assign(fROIOffset.back(),std::vector<size_t>());
 
   std::unordered_map<unsigned int,unsigned int> wireChannelMap;
   for(size_t i_w=0; i_w<wireVec.size(); ++i_w)
@@ -356,7 +396,7 @@ void sys::WireModifier::FillROIMatchedEdepMap(std::vector<sim::SimEnergyDeposit>
 
       auto range_number = target_wire.SignalROI().find_range_iterator(target_roi.second) - target_wire.SignalROI().begin_range();
 
-      fROIMatchedEdepMap[std::make_pair(target_wire.Channel(),range_number)].push_back(i_e);
+      fROIMatchedEdeps[fROIOffset[wireChannelMap[target_roi.first]]+range_number].push_back(i_e);
 
     }//end loop over target rois
 
@@ -367,7 +407,7 @@ void sys::WireModifier::FillROIMatchedEdepMap(std::vector<sim::SimEnergyDeposit>
 void sys::WireModifier::FillROIMatchedHitMap(std::vector<recob::Hit> const& hitVec,
 					     std::vector<recob::Wire> const& wireVec)
 {
-  fROIMatchedHitMap.clear();
+  fROIMatchedHits.assign(fROIOffset.back(),std::vector<size_t>());
   
   std::unordered_map<unsigned int,unsigned int> wireChannelMap;
   for(size_t i_w=0; i_w<wireVec.size(); ++i_w)
@@ -389,7 +429,7 @@ void sys::WireModifier::FillROIMatchedHitMap(std::vector<recob::Hit> const& hitV
 
       auto range_number = target_wire.SignalROI().find_range_iterator(target_roi.second) - target_wire.SignalROI().begin_range();
       
-      fROIMatchedHitMap[std::make_pair(target_wire.Channel(),range_number)].push_back(i_h);
+      fROIMatchedHits[fROIOffset[wireChannelMap[target_roi.first]]+range_number].push_back(i_h);
       
     }//end loop over target rois
     
@@ -431,7 +471,8 @@ sys::WireModifier::CalcSubROIProperties(sys::WireModifier::ROIProperties_t const
 
 std::map<sys::WireModifier::SubROI_Key_t, std::vector<const sim::SimEnergyDeposit*>>
 sys::WireModifier::MatchEdepsToSubROIs(std::vector<sys::WireModifier::SubROIProperties_t> const& subROIPropVec,
-				       std::vector<const sim::SimEnergyDeposit*> const& edepPtrVec, double offset) {
+				       std::vector<const sim::SimEnergyDeposit*> const& edepPtrVec, double offset,
+				       NtupleRows_t& ntuple_rows) {
 
   // for each TrackID, which EDeps are associated with it? keys are TrackIDs
   std::map<int, std::vector<const sim::SimEnergyDeposit*>> TrackIDMatchedEDepMap;
@@ -444,7 +485,7 @@ sys::WireModifier::MatchEdepsToSubROIs(std::vector<sys::WireModifier::SubROIProp
   }
   // calculate EDep properties by TrackID
   std::map<int, sys::WireModifier::TruthProperties_t> TrackIDMatchedPropertyMap;
-  for ( auto const& track_edeps : TrackIDMatchedEDepMap ) { TrackIDMatchedPropertyMap[track_edeps.first] = CalcPropertiesFromEdeps(track_edeps.second, offset); }
+  for ( auto const& track_edeps : TrackIDMatchedEDepMap ) { TrackIDMatchedPropertyMap[track_edeps.first] = CalcPropertiesFromEdeps(track_edeps.second, offset, ntuple_rows); }
 
   // for each EDep, which subROI(s) (if any) is it plausibly matched to? based on whether the EDep's projected tick is within +/-1sigma of the subROI center
   std::map<unsigned int, std::vector<unsigned int>> EDepMatchedSubROIMap;   // keys are indexes of edepPtrVec, values are vectors of indexes of subROIPropVec
@@ -502,7 +543,8 @@ sys::WireModifier::MatchEdepsToSubROIs(std::vector<sys::WireModifier::SubROIProp
 }
 
 sys::WireModifier::TruthProperties_t 
-sys::WireModifier::CalcPropertiesFromEdeps(std::vector<const sim::SimEnergyDeposit*> const& edepPtrVec, double offset){
+sys::WireModifier::CalcPropertiesFromEdeps(std::vector<const sim::SimEnergyDeposit*> const& edepPtrVec, double offset,
+					   NtupleRows_t& ntuple_rows){
   
   //split the edeps by TrackID
   std::map< int, std::vector<const sim::SimEnergyDeposit*> > edepptrs_by_trkid;
@@ -563,27 +605,24 @@ sys::WireModifier::CalcPropertiesFromEdeps(std::vector<const sim::SimEnergyDepos
       //std::cout << scales.r_Q << " " << scales.r_sigma << " ";
 
       if(fFillScaleCheckTree){
-	if(i_p==0)
-	  fNtScaleCheck->Fill(i_p,edep_ptr->E(),edep_ptr->X(),edep_ptr->Y(),edep_ptr->Z(),
-			      edep_props.dxdr,edep_props.dydr,edep_props.dzdr,
-			      ThetaXZ_U(edep_props.dxdr,edep_props.dydr,edep_props.dzdr),
-			      ThetaYZ_U(edep_props.dxdr,edep_props.dydr,edep_props.dzdr),
-			      edep_props.dedr,
-			      scales.r_Q,scales.r_sigma);
-	else if(i_p==1)
-	  fNtScaleCheck->Fill(i_p,edep_ptr->E(),edep_ptr->X(),edep_ptr->Y(),edep_ptr->Z(),
-			      edep_props.dxdr,edep_props.dydr,edep_props.dzdr,
-			      ThetaXZ_V(edep_props.dxdr,edep_props.dydr,edep_props.dzdr),
-			      ThetaYZ_V(edep_props.dxdr,edep_props.dydr,edep_props.dzdr),
-			      edep_props.dedr,
-			      scales.r_Q,scales.r_sigma);
-	else if(i_p==2)
-	  fNtScaleCheck->Fill(i_p,edep_ptr->E(),edep_ptr->X(),edep_ptr->Y(),edep_ptr->Z(),
-			      edep_props.dxdr,edep_props.dydr,edep_props.dzdr,
-			      ThetaXZ_Y(edep_props.dxdr,edep_props.dydr,edep_props.dzdr),
-			      ThetaYZ_Y(edep_props.dxdr,edep_props.dydr,edep_props.dzdr),
-			      edep_props.dedr,
-			      scales.r_Q,scales.r_sigma);
+	double theta_xz = 0., theta_yz = 0.;
+	if(i_p==0){
+	  theta_xz = ThetaXZ_U(edep_props.dxdr,edep_props.dydr,edep_props.dzdr);
+	  theta_yz = ThetaYZ_U(edep_props.dxdr,edep_props.dydr,edep_props.dzdr);
+	}
+	else if(i_p==1){
+	  theta_xz = ThetaXZ_V(edep_props.dxdr,edep_props.dydr,edep_props.dzdr);
+	  theta_yz = ThetaYZ_V(edep_props.dxdr,edep_props.dydr,edep_props.dzdr);
+	}
+	else if(i_p==2){
+	  theta_xz = ThetaXZ_Y(edep_props.dxdr,edep_props.dydr,edep_props.dzdr);
+	  theta_yz = ThetaYZ_Y(edep_props.dxdr,edep_props.dydr,edep_props.dzdr);
+	}
+	ntuple_rows.scale_check.push_back({(float)i_p,(float)edep_ptr->E(),(float)edep_ptr->X(),(float)edep_ptr->Y(),(float)edep_ptr->Z(),
+					   (float)edep_props.dxdr,(float)edep_props.dydr,(float)edep_props.dzdr,
+					   (float)theta_xz,(float)theta_yz,
+					   (float)edep_props.dedr,
+					   (float)scales.r_Q,(float)scales.r_sigma});
       }
 
     }
@@ -757,10 +796,10 @@ sys::WireModifier::GetScaleValues(sys::WireModifier::TruthProperties_t const& tr
     if(fApplyZScale){    
     }
     if(fApplyYZScale){    
-      temp_scale = fTGraph2Ds_Charge_YZ[plane]->Interpolate(truth_props.z,truth_props.y); //confirmed order is (z,y) by Aruturo, 1/24/20
+      temp_scale = InterpolateYZ(fTGraph2Ds_Charge_YZ[plane],truth_props.z,truth_props.y); //confirmed order is (z,y) by Aruturo, 1/24/20
       if(temp_scale>0.001) scales.r_Q *= temp_scale;
 
-      temp_scale = fTGraph2Ds_Sigma_YZ[plane]->Interpolate(truth_props.z,truth_props.y);
+      temp_scale = InterpolateYZ(fTGraph2Ds_Sigma_YZ[plane],truth_props.z,truth_props.y);
       if(temp_scale>0.001) scales.r_sigma *= temp_scale;
     }
     if(fApplyXZAngleScale){    
@@ -791,10 +830,10 @@ sys::WireModifier::GetScaleValues(sys::WireModifier::TruthProperties_t const& tr
     if(fApplyZScale){    
     }
     if(fApplyYZScale){    
-      temp_scale = fTGraph2Ds_Charge_YZ[plane]->Interpolate(truth_props.z,truth_props.y);
+      temp_scale = InterpolateYZ(fTGraph2Ds_Charge_YZ[plane],truth_props.z,truth_props.y);
       if(temp_scale>0.001) scales.r_Q *= temp_scale;
 
-      temp_scale = fTGraph2Ds_Sigma_YZ[plane]->Interpolate(truth_props.z,truth_props.y);
+      temp_scale = InterpolateYZ(fTGraph2Ds_Sigma_YZ[plane],truth_props.z,truth_props.y);
       if(temp_scale>0.001) scales.r_sigma *= temp_scale;
     }
     if(fApplyXZAngleScale){    
@@ -824,10 +863,10 @@ sys::WireModifier::GetScaleValues(sys::WireModifier::TruthProperties_t const& tr
     if(fApplyZScale){    
     }
     if(fApplyYZScale){    
-      temp_scale = fTGraph2Ds_Charge_YZ[plane]->Interpolate(truth_props.z,truth_props.y);
+      temp_scale = InterpolateYZ(fTGraph2Ds_Charge_YZ[plane],truth_props.z,truth_props.y);
       if(temp_scale>0.001) scales.r_Q *= temp_scale;
 
-      temp_scale = fTGraph2Ds_Sigma_YZ[plane]->Interpolate(truth_props.z,truth_props.y);
+      temp_scale = InterpolateYZ(fTGraph2Ds_Sigma_YZ[plane],truth_props.z,truth_props.y);
       if(temp_scale>0.001) scales.r_sigma *= temp_scale;
     }
     if(fApplyXZAngleScale){    
@@ -854,58 +893,69 @@ sys::WireModifier::GetScaleValues(sys::WireModifier::TruthProperties_t const& tr
   return scales;
 }
 
+void sys::WireModifier::AddGaussian(std::vector<double> & q,
+				    float begin, size_t i_min, size_t i_max,
+				    double mean, double sigma, double a)
+{
+  //same expression as GAUSSIAN, with the normalisation taken out of the tick loop
+  const double norm = a/sigma /std::sqrt(2*util::pi());
+  for(size_t i_t=i_min; i_t<i_max; i_t++) {
+    double t = i_t+begin;
+    q[i_t] += norm * std::exp( -1.*(t-mean)*(t-mean)*0.5/sigma/sigma);
+  }
+}
+
 void sys::WireModifier::ModifyROI(std::vector<float> & roi_data,
 				  sys::WireModifier::ROIProperties_t const& roi_prop,
 				  std::vector<sys::WireModifier::SubROIProperties_t> const& subROIPropVec, 
-				  std::map<sys::WireModifier::SubROI_Key_t, sys::WireModifier::ScaleValues_t> const& subROIScaleMap)
+				  std::vector<sys::WireModifier::ScaleValues_t> const& subROIScaleVec)
 {
   
-  bool verbose=false;
-  //if(roi_data.size()>100) verbose=true;
-  //if(roi_data.size()==1) verbose=true;
+  //q_orig and q_mod for all ticks, summed subROI by subROI in the same order as per tick
+  std::vector<double> q_orig_v(roi_data.size(),0.);
+  std::vector<double> q_mod_v(roi_data.size(),0.);
   
+  for(size_t i_s=0; i_s < subROIPropVec.size(); i_s++) {
+    auto const& subroi_prop = subROIPropVec[i_s];
+    auto const& scale_vals = subROIScaleVec[i_s];
+
+    double sigma_mod = scale_vals.r_sigma * subroi_prop.sigma;
+
+    //ticks where the subROI contributes, all of them if the gaussians are not truncated
+    size_t i_min = 0;
+    size_t i_max = roi_data.size();
+    double half_width = fGaussianNSigma * std::max((double)subroi_prop.sigma, sigma_mod);
+    if(fGaussianNSigma>0 && half_width>0 && std::isfinite(half_width) && std::isfinite(subroi_prop.center)) {
+      double t_min = std::ceil(subroi_prop.center - half_width - roi_prop.begin);
+      double t_max = std::floor(subroi_prop.center + half_width - roi_prop.begin) + 1;
+      i_min = (size_t)std::min(std::max(t_min,0.),(double)roi_data.size());
+      i_max = (size_t)std::min(std::max(t_max,0.),(double)roi_data.size());
+      if(i_max<i_min) i_max = i_min;
+    }
+
+    AddGaussian( q_orig_v, roi_prop.begin, i_min, i_max,
+		 subroi_prop.center,
+		 subroi_prop.sigma,
+		 subroi_prop.total_q );
+
+    AddGaussian( q_mod_v, roi_prop.begin, i_min, i_max,
+		 subroi_prop.center,
+		 sigma_mod,
+		 scale_vals.r_Q     * subroi_prop.total_q );
+  }
+
   double q_orig = 0.;
   double q_mod = 0.;
   double scale_ratio = 1.;
   
   for(size_t i_t=0; i_t < roi_data.size(); i_t++) {
     
-    // reset q_orig, q_mod, scale_ratio
-    q_orig = 0.;
-    q_mod = 0.;
+    q_orig = q_orig_v[i_t];
+    q_mod = q_mod_v[i_t];
     scale_ratio = 1.;
-    
-    // calculate q_orig, q_mod for this tick
-    for ( auto const& subroi_prop : subROIPropVec ) {
-      auto scale_vals = subROIScaleMap.find(subroi_prop.key)->second;
-
-      q_orig += GAUSSIAN( i_t+roi_prop.begin,
-			  subroi_prop.center,
-			  subroi_prop.sigma,
-			  subroi_prop.total_q );
-
-      if ( verbose ) std::cout << "    Incrementing q_orig by GAUSSIAN( " << i_t+roi_prop.begin << ", " << subroi_prop.center << ", " << subroi_prop.sigma 
-			       << ", " << subroi_prop.total_q << ") = " 
-			       << GAUSSIAN( i_t+roi_prop.begin,
-					    subroi_prop.center,
-					    subroi_prop.sigma,
-					    subroi_prop.total_q )
-			       << std::endl;
-
-      q_mod  += GAUSSIAN( i_t+roi_prop.begin,
-			  subroi_prop.center,
-			  scale_vals.r_sigma * subroi_prop.sigma, 
-			  scale_vals.r_Q     * subroi_prop.total_q );
-
-      if (verbose ) std::cout << "    Incrementing q_mod by GAUSSIAN( " << i_t+roi_prop.begin << ", " << subroi_prop.center << ", " << scale_vals.r_sigma 
-			      << " * " << subroi_prop.sigma << ", " << scale_vals.r_Q << " * " << subroi_prop.total_q << ") = " 
-			      << GAUSSIAN( i_t+roi_prop.begin,
-					   subroi_prop.center,
-					   scale_vals.r_sigma * subroi_prop.sigma,
-					   scale_vals.r_Q     * subroi_prop.total_q )
-			      << std::endl;
-      
-    }
+
+    //with truncated gaussians, ticks away from all subROIs are left as they are
+    if(fGaussianNSigma>0 && q_orig==0. && q_mod==0.) continue;
     
     if(isnan(q_orig)) {
       std::cout << "WARNING: obtained q_orig = NaN... setting to zero" << std::endl;
@@ -934,19 +984,147 @@ void sys::WireModifier::ModifyROI(std::vector<float> & roi_data,
 
     roi_data[i_t] = scale_ratio * roi_data[i_t];
     
-    if(verbose)
-      std::cout << "\t tick " << i_t << ":"
-		<< " data=" << roi_data[i_t]
-		<< ", q_orig=" << q_orig
-		<< ", q_mod=" << q_mod
-		<< ", ratio=" << scale_ratio
-		<< std::endl;
   }
   
   return;
   
 }
 
+recob::Wire::RegionsOfInterest_t
+sys::WireModifier::ModifyWire(size_t i_w,
+			      std::vector<recob::Wire> const& wireVec,
+			      std::vector<sim::SimEnergyDeposit> const& edepOrigVec,
+			      std::vector<sim::SimEnergyDeposit> const& edepShiftedVec,
+			      std::vector<recob::Hit> const& hitVec,
+			      double offset, NtupleRows_t& ntuple_rows)
+{
+  auto const& wire = wireVec[i_w];
+
+  //make a new roi list
+  recob::Wire::RegionsOfInterest_t new_rois;
+  new_rois.resize(wire.SignalROI().size());
+
+  unsigned int my_plane=wire.View();
+
+  for(size_t i_r=0; i_r<wire.SignalROI().get_ranges().size(); ++i_r){
+
+    auto const& range = wire.SignalROI().get_ranges()[i_r];
+    ROI_Key_t roi_key(wire.Channel(),i_r);
+
+
+    std::vector<float> modified_data(range.data());
+
+    if(fApplyOverallScale)
+	for(size_t i_t=0; i_t<modified_data.size(); ++i_t)
+	  modified_data[i_t] = modified_data[i_t]*fOverallScale[my_plane];
+    
+    //get the matching edeps
+    auto const& matchedEdepIdxVec = fROIMatchedEdeps[fROIOffset[i_w]+i_r];
+    if(matchedEdepIdxVec.size()==0){
+	new_rois.add_range(range.begin_index(),modified_data);
+	continue;
+    }
+    std::vector<const sim::SimEnergyDeposit*> matchedEdepPtrVec;
+    std::vector<const sim::SimEnergyDeposit*> matchedShiftedEdepPtrVec;
+    for(auto i_e : matchedEdepIdxVec) {
+	matchedEdepPtrVec.push_back(&edepOrigVec[i_e]);
+	matchedShiftedEdepPtrVec.push_back(&edepShiftedVec[i_e]);
+    }
+
+
+    // get the matching hits
+    std::vector<const recob::Hit*> matchedHitPtrVec;
+    for( auto i_h : fROIMatchedHits[fROIOffset[i_w]+i_r] ) {
+	matchedHitPtrVec.push_back(&hitVec[i_h]);
+    }
+
+    //calc roi properties
+    auto roi_properties = CalcROIProperties(range);
+    roi_properties.key   = roi_key;
+    roi_properties.plane = my_plane;
+
+    /*
+    std::cout << "DOING WIRE ROI (wire=" << wire.Channel() << ", roi_idx=" << i_r
+		<< ", roi_begin=" << roi_properties.begin << ", roi_size=" << roi_properties.end-roi_properties.begin << ")" << std::endl;
+    std::cout << "  Have " << matchedEdepPtrVec.size() << " matching Edeps" << std::endl;
+    std::cout << "  Have " << matchedHitPtrVec.size() << " matching hits" << std::endl;
+    */
+
+    // get the subROIs
+    auto subROIPropVec = CalcSubROIProperties(roi_properties, matchedHitPtrVec);
+    //std::cout << "  Have " << subROIPropVec.size() << " subROIs" << std::endl;
+
+    // get the edeps per subROI
+    auto SubROIMatchedShiftedEdepMap = MatchEdepsToSubROIs(subROIPropVec, matchedShiftedEdepPtrVec, offset, ntuple_rows);
+    // convert from shifted edep pointers to original edep pointers
+    std::map<SubROI_Key_t, std::vector<const sim::SimEnergyDeposit*>> SubROIMatchedEdepMap;
+    for ( auto const& key_edepPtrVec_pair : SubROIMatchedShiftedEdepMap ) {
+	auto key = key_edepPtrVec_pair.first;
+	for ( auto const& shifted_edep_ptr : key_edepPtrVec_pair.second ) {
+	  for ( unsigned int i_e=0; i_e < matchedShiftedEdepPtrVec.size(); i_e++ ) {
+	    if ( shifted_edep_ptr == matchedShiftedEdepPtrVec[i_e] ) {
+	      SubROIMatchedEdepMap[key].push_back(matchedEdepPtrVec[i_e]);
+	      break;
+	    }
+	  }
+	}
+    } // end conversion
+    //for ( auto const& pair : SubROIMatchedEdepMap ) std::cout << "  For subROI #" << pair.first.second << ", have " 
+    //<< pair.second.size() << " matching Edeps" << std::endl;
+
+    //get the scaling values, one per subROI
+    std::vector<ScaleValues_t> SubROIScaleVec;
+    for ( auto const& subroi_prop : subROIPropVec ) {
+	ScaleValues_t scale_vals;
+	auto key = subroi_prop.key;
+	auto key_it =  SubROIMatchedEdepMap.find(key);
+	
+	// if subROI has matched EDeps, use them to get the scale values
+	if ( key_it != SubROIMatchedEdepMap.end() && key_it->second.size() > 0 ) {
+	  auto truth_vals = CalcPropertiesFromEdeps(key_it->second, offset, ntuple_rows);
+	  
+	  // fill ntuple with total subROI total energy and total Q information
+	  ntuple_rows.nt.push_back({(float)truth_vals.total_energy,(float)subroi_prop.total_q});
+
+	  // if we have a large it with little energy, default to r_Q = r_sigma = 
+	  if ( truth_vals.total_energy < 0.3 && subroi_prop.total_q > 80 ) {
+	    scale_vals.r_Q     = 1.;
+	    scale_vals.r_sigma = 1.;
+	  }
+	  // otherwise, use scale factors based on EDep properties
+	  else {
+	    if(fUseCollectiveEdepsForScales) //use bulk properties of edeps to determine scale
+	      scale_vals = GetScaleValues(truth_vals, roi_properties);
+	    else //use the energy-weighted average scale values per edep
+	      scale_vals = truth_vals.scales_avg[roi_properties.plane];
+	  }
+	}
+	// otherwise, set scale values to 1
+	else {
+	  scale_vals.r_Q     = 1.;
+	  scale_vals.r_sigma = 1.;
+	}
+	SubROIScaleVec.push_back(scale_vals);
+    }
+    /*
+    for ( size_t i_s=0; i_s < SubROIScaleVec.size(); i_s++ ) {
+      std::cout << "  For subROI #" << i_s << ", have "
+                  << "scale factors r_Q = " << SubROIScaleVec[i_s].r_Q << " and r_sigma = " << SubROIScaleVec[i_s].r_sigma << std::endl;
+
+    }
+    */
+
+    //get modified ROI given scales
+    //std::vector<float> modified_data(range.data());
+    ModifyROI(modified_data, roi_properties, subROIPropVec, SubROIScaleVec);
+
+    new_rois.add_range(roi_properties.begin,modified_data);
+    
+  }//end loop over rois
+  
+  return new_rois;
+}
+
 sys::WireModifier::WireModifier(fhicl::ParameterSet const& p)
   : EDProducer{p},
   fWireInputTag(p.get<art::InputTag>("WireInputTag")),
@@ -979,7 +1157,9 @@ sys::WireModifier::WireModifier(fhicl::ParameterSet const& p)
   fOverallScale(p.get< std::vector<double> >("OverallScale",std::vector<double>(3,1.))),
   fFillScaleCheckTree(p.get<bool>("FillScaleCheckTree",false)),
   fApplyAdditionalTickOffset(p.get<bool>("ApplyAdditionalTickOffset", false)),
-  fApplyAngleYZSigmaSpline(p.get<bool>("ApplyAngleYZSigmaSpline", false))
+  fApplyAngleYZSigmaSpline(p.get<bool>("ApplyAngleYZSigmaSpline", false)),
+  fNumThreads(p.get<size_t>("NumThreads",1)),
+  fGaussianNSigma(p.get<double>("GaussianNSigmaCutoff",0.))
 {
   produces< std::vector< recob::Wire > >();
     
@@ -1111,148 +1291,30 @@ void sys::WireModifier::produce(art::Event& e)
   std::unique_ptr< art::Assns<raw::RawDigit,recob::Wire> > new_digit_assn(new art::Assns<raw::RawDigit,recob::Wire>());
 
   //first fill our roi to edep map
+  FillROIOffsets(wireVec);
   FillROIMatchedEdepMap(edepShiftedVec,wireVec,offset_ADC);
   // and fill our roi to hit map
   FillROIMatchedHitMap(hitVec,wireVec);
 
-  //loop through the wires and rois per wire...
-  for(size_t i_w=0; i_w<wireVec.size(); ++i_w){
-
-    auto const& wire = wireVec[i_w];
-
-    //make a new roi list
-    recob::Wire::RegionsOfInterest_t new_rois;
-    new_rois.resize(wire.SignalROI().size());
-
-    unsigned int my_plane=wire.View();
+  //modify the wires, in parallel if asked: each wire only writes its own rois and ntuple rows
+  std::vector<recob::Wire::RegionsOfInterest_t> new_rois_v(wireVec.size());
+  std::vector<NtupleRows_t> ntuple_rows_v(wireVec.size());
 
-    for(size_t i_r=0; i_r<wire.SignalROI().get_ranges().size(); ++i_r){
+  ubutil::ParallelFor(wireVec.size(), fNumThreads, [&](size_t i_w) {
+      new_rois_v[i_w] = ModifyWire(i_w, wireVec, edepOrigVec, edepShiftedVec, hitVec, offset_ADC, ntuple_rows_v[i_w]);
+    });
 
-      auto const& range = wire.SignalROI().get_ranges()[i_r];
-      ROI_Key_t roi_key(wire.Channel(),i_r);
-
-
-      std::vector<float> modified_data(range.data());
-
-      if(fApplyOverallScale)
-	for(size_t i_t=0; i_t<modified_data.size(); ++i_t)
-	  modified_data[i_t] = modified_data[i_t]*fOverallScale[my_plane];
-      
-      //get the matching edeps
-      auto it_map = fROIMatchedEdepMap.find(roi_key);
-      if(it_map==fROIMatchedEdepMap.end()){	
-	new_rois.add_range(range.begin_index(),modified_data);
-	continue;
-      }
-      std::vector<size_t> matchedEdepIdxVec = it_map->second;      
-      if(matchedEdepIdxVec.size()==0){
-	new_rois.add_range(range.begin_index(),modified_data);
-	continue;
-      }
-      std::vector<const sim::SimEnergyDeposit*> matchedEdepPtrVec;
-      std::vector<const sim::SimEnergyDeposit*> matchedShiftedEdepPtrVec;
-      for(auto i_e : matchedEdepIdxVec) {
-	matchedEdepPtrVec.push_back(&edepOrigVec[i_e]);
-	matchedShiftedEdepPtrVec.push_back(&edepShiftedVec[i_e]);
-      }
-
-
-      // get the matching hits
-      std::vector<const recob::Hit*> matchedHitPtrVec;
-      auto it_hit_map = fROIMatchedHitMap.find(roi_key);
-      if( it_hit_map != fROIMatchedHitMap.end() ) {
-	for( auto i_h : it_hit_map->second ) {
-	  matchedHitPtrVec.push_back(&hitVec[i_h]);
-	}
-      }
-
-      //calc roi properties
-      auto roi_properties = CalcROIProperties(range);
-      roi_properties.key   = roi_key;
-      roi_properties.plane = my_plane;
-
-      /*
-      std::cout << "DOING WIRE ROI (wire=" << wire.Channel() << ", roi_idx=" << i_r
-		<< ", roi_begin=" << roi_properties.begin << ", roi_size=" << roi_properties.end-roi_properties.begin << ")" << std::endl;
-      std::cout << "  Have " << matchedEdepPtrVec.size() << " matching Edeps" << std::endl;
-      std::cout << "  Have " << matchedHitPtrVec.size() << " matching hits" << std::endl;
-      */
-
-      // get the subROIs
-      auto subROIPropVec = CalcSubROIProperties(roi_properties, matchedHitPtrVec);
-      //std::cout << "  Have " << subROIPropVec.size() << " subROIs" << std::endl;
-
-      // get the edeps per subROI
-      auto SubROIMatchedShiftedEdepMap = MatchEdepsToSubROIs(subROIPropVec, matchedShiftedEdepPtrVec, offset_ADC);
-      // convert from shifted edep pointers to original edep pointers
-      std::map<SubROI_Key_t, std::vector<const sim::SimEnergyDeposit*>> SubROIMatchedEdepMap;
-      for ( auto const& key_edepPtrVec_pair : SubROIMatchedShiftedEdepMap ) {
-	auto key = key_edepPtrVec_pair.first;
-	for ( auto const& shifted_edep_ptr : key_edepPtrVec_pair.second ) {
-	  for ( unsigned int i_e=0; i_e < matchedShiftedEdepPtrVec.size(); i_e++ ) {
-	    if ( shifted_edep_ptr == matchedShiftedEdepPtrVec[i_e] ) {
-	      SubROIMatchedEdepMap[key].push_back(matchedEdepPtrVec[i_e]);
-	      break;
-	    }
-	  }
-	}
-      } // end conversion
-      //for ( auto const& pair : SubROIMatchedEdepMap ) std::cout << "  For subROI #" << pair.first.second << ", have " 
-      //<< pair.second.size() << " matching Edeps" << std::endl;
-
-      //get the scaling values
-      std::map<SubROI_Key_t, ScaleValues_t> SubROIMatchedScalesMap;
-      for ( auto const& subroi_prop : subROIPropVec ) {
-	ScaleValues_t scale_vals;
-	auto key = subroi_prop.key;
-	auto key_it =  SubROIMatchedEdepMap.find(key);
-	
-	// if subROI has matched EDeps, use them to get the scale values
-	if ( key_it != SubROIMatchedEdepMap.end() && key_it->second.size() > 0 ) {
-	  auto truth_vals = CalcPropertiesFromEdeps(key_it->second, offset_ADC);
-	  
-	  // fill ntuple with total subROI total energy and total Q information
-	  fNt->Fill(truth_vals.total_energy,subroi_prop.total_q);
-
-	  // if we have a large it with little energy, default to r_Q = r_sigma = 
-	  if ( truth_vals.total_energy < 0.3 && subroi_prop.total_q > 80 ) {
-	    scale_vals.r_Q     = 1.;
-	    scale_vals.r_sigma = 1.;
-	  }
-	  // otherwise, use scale factors based on EDep properties
-	  else {
-	    if(fUseCollectiveEdepsForScales) //use bulk properties of edeps to determine scale
-	      scale_vals = GetScaleValues(truth_vals, roi_properties);
-	    else //use the energy-weighted average scale values per edep
-	      scale_vals = truth_vals.scales_avg[roi_properties.plane];
-	  }
-	}
-	// otherwise, set scale values to 1
-	else {
-	  scale_vals.r_Q     = 1.;
-	  scale_vals.r_sigma = 1.;
-	}
-	SubROIMatchedScalesMap[key] = scale_vals;
-      }
-      /*
-      for ( auto const& key_scale_pair : SubROIMatchedScalesMap ) {
-        std::cout << "  For subROI #" << key_scale_pair.first.second << ", have "
-                    << "scale factors r_Q = " << key_scale_pair.second.r_Q << " and r_sigma = " << key_scale_pair.second.r_sigma << std::endl;
+  //outputs and ntuples in wire order
+  for(size_t i_w=0; i_w<wireVec.size(); ++i_w){
 
-      }
-      */
+    auto const& wire = wireVec[i_w];
 
-      //get modified ROI given scales
-      //std::vector<float> modified_data(range.data());
-      ModifyROI(modified_data, roi_properties, subROIPropVec, SubROIMatchedScalesMap);
+    for(auto const& row : ntuple_rows_v[i_w].scale_check) fNtScaleCheck->Fill(row.data());
+    for(auto const& row : ntuple_rows_v[i_w].nt) fNt->Fill(row.data());
 
-      new_rois.add_range(roi_properties.begin,modified_data);
-      
-    }//end loop over rois
-    
     //make our new wire object
     //std::cout << "adding channel " << wire.Channel() << std::endl; 
-    new_wires->emplace_back(new_rois,wire.Channel(),wire.View());
+    new_wires->emplace_back(std::move(new_rois_v[i_w]),wire.Channel(),wire.View());
 
     
     //get the associated rawdigit
@@ -33,11 +33,14 @@
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 
 
+#include "ubreco/GammaCatcher/TrackProjectionIndex.h"
+
 #include "TTree.h"
 #include "art_root_io/TFileService.h"
 
 #include <memory>
 #include <tuple>
+#include <algorithm>
 
 class Gamma3D : public art::EDProducer {
 public:
@@ -80,9 +83,6 @@ private:
 
 
 
-  Double_t X_reco=0.0;
-  Double_t Y_reco=0.0;
-  Double_t Z_reco=0.0;
 
   //Double_t X_reco_nu=0.0;
   //Double_t Y_reco_nu=0.0;
@@ -126,7 +126,6 @@ private:
 
 
 
-  Double_t pointdistance=0;
   //Double_t pointdistance_nu=0;
 
   //Double_t pointdistance3d=0;
@@ -141,8 +140,6 @@ private:
 
   Int_t plane;
 
-  Double_t X_reco_smallest=0;
-  Double_t Z_reco_smallest=0;
 
   //Double_t X_reco_smallest_nu=0;
   //Double_t Z_reco_smallest_nu=0;
@@ -159,7 +156,6 @@ private:
   //Double_t Z_reco_smallest3d=0;
   //Double_t Y_reco_smallest3d=0;
 
-  Double_t pointdistance_smallest;
   //Double_t pointdistance_smallest_nu;
 
   //Double_t pointdistance_smallestV;
@@ -360,6 +356,22 @@ void Gamma3D::produce(art::Event & e)//START EVENT LOOP
   // std::cout<<"size_track: "<<recotrack_handle->size()<<std::endl;
 
   auto const& channelMap = art::ServiceHandle<geo::WireReadout>()->Get();
+
+  //Neutrino Correlated Tracks are skipped. So all activity close to a neutrino track will be reconstructed.
+  std::vector<bool> nu_track(recotrack_handle->size(),false);
+  std::vector<size_t> checked_tracks;
+  for (size_t i_t = 0, size_track = recotrack_handle->size(); i_t != size_track; ++i_t) {
+    auto const& track = recotrack_handle->at(i_t);
+    if ( (sqrt((pow(nuvtx.position().x()-track.Start().X(),2))+(pow(nuvtx.position().y()-track.Start().Y(),2))+ (pow(nuvtx.position().z()-track.Start().Z(),2))) <5.0) ||  (sqrt((pow(nuvtx.position().x()-track.End().X(),2))+(pow(nuvtx.position().y()-track.End().Y(),2))+ (pow(nuvtx.position().z()-track.End().Z(),2)))<5.0))
+    nu_track[i_t] = true;
+    else
+    checked_tracks.push_back(i_t);
+  }
+
+  // project the remaining track trajectory points on each plane once for all clusters
+  gammacatcher::TrackProjectionIndex trackIndex;
+  trackIndex.Fill(*recotrack_handle, channelMap, wire2cm, nu_track);
+
   for (size_t i_c = 0, size_cluster = cluster_handle->size(); i_c != size_cluster; ++i_c) { //start cluster FOR loop for calculating 2-D distance
 
     // std::cout<<"Cluster # "<<i_c<<std::endl;
@@ -444,123 +456,78 @@ void Gamma3D::produce(art::Event & e)//START EVENT LOOP
 
 
 
-    for (size_t i_t = 0, size_track = recotrack_handle->size(); i_t != size_track; ++i_t) {//START RECO TRACK FOR LOOP
-
-      auto hits = clus_hit_assn_v.at(i_c);
-      auto const& track = recotrack_handle->at(i_t);
-
-      //Neutrino Correlated Tracks are skipped. So all activity close to a neutrino track will be reconstructed.
-
-      if ( (sqrt((pow(nuvtx.position().x()-track.Start().X(),2))+(pow(nuvtx.position().y()-track.Start().Y(),2))+ (pow(nuvtx.position().z()-track.Start().Z(),2))) <5.0) ||  (sqrt((pow(nuvtx.position().x()-track.End().X(),2))+(pow(nuvtx.position().y()-track.End().Y(),2))+ (pow(nuvtx.position().z()-track.End().Z(),2)))<5.0))
-      continue;
-
-
-      pointdistance_smallest=1e10;////Variable for distance between a cluster hit and a reco track point, initialized to a large number for comparison
-
-      for(size_t m=0;m<(track.NumberTrajectoryPoints());m++){//START RECO POINT LOOP
-
-
-        auto const& track_loc = track.LocationAtPoint(m);
-        std::tie(X_reco, Y_reco, Z_reco) = std::make_tuple(track_loc.X(), track_loc.Y(), track_loc.Z());
-
-
-        auto V_wire_cm = channelMap.Plane(geo::PlaneID(0,0,1)).WireCoordinate(track_loc) * wire2cm;
-
-        auto V_time_cm = X_reco;
-
-        auto U_wire_cm = channelMap.Plane(geo::PlaneID(0,0,0)).WireCoordinate(track_loc) * wire2cm;
-
-        auto U_time_cm = X_reco;
-
-
-        for (auto const& hit : hits) {//START CLUSTER HIT LOOP
+    auto hits = clus_hit_assn_v.at(i_c);
+    size_t view = cluster[i_c].View();
 
-          cluster_hit_z = hit->WireID().Wire * wire2cm;//Also equal to Cluster_hit_wire_cm
-          cluster_hit_x = (hit->PeakTime() * time2cm)-44.575 ;//Also equal to Cluster_hit_time_cm
+    // first track (in track order) coming within the plane's distance cut of a cluster hit
+    size_t first_near = gammacatcher::TrackProjectionIndex::kNoTrack;
 
-          if(cluster[i_c].View()==2){
-            plane=2;
-            pointdistance=sqrt((pow(cluster_hit_z-Z_reco,2))+(pow(cluster_hit_x-X_reco,2)));
+    if ( (view <= 2) && (trackIndex.NumPoints(view) != 0) ) {
 
-          }
-          if (cluster[i_c].View()==1){
-            plane=1;
-
-            pointdistance=sqrt((pow(cluster_hit_z-V_wire_cm,2))+(pow(cluster_hit_x-V_time_cm,2)));
-          }
-
-          if (cluster[i_c].View()==0){
-            plane=0;
-            pointdistance=sqrt((pow(cluster_hit_z-U_wire_cm,2))+(pow(cluster_hit_x-U_time_cm,2)));
-          }
-
-          if(pointdistance<pointdistance_smallest){//comparison IF loop
+      double cut = (view == 2) ? f2DcutY : f2DcutUV;
+      size_t best_index = gammacatcher::TrackProjectionIndex::kNoTrack;
+      double best_dist  = 1e10;
 
-            pointdistance_smallest=pointdistance;
+      for (auto const& hit : hits) {//START CLUSTER HIT LOOP
 
-            X_reco_smallest=X_reco;
-            Z_reco_smallest=Z_reco;
-
-          }
-
-        }//END CLUSTER HIT LOOP
+        cluster_hit_z = hit->WireID().Wire * wire2cm;//Also equal to Cluster_hit_wire_cm
+        cluster_hit_x = (hit->PeakTime() * time2cm)-44.575 ;//Also equal to Cluster_hit_time_cm
+        plane = view;
 
+        // nearest reco track point to this hit
+        double pointdist;
+        size_t index;
+        if ( trackIndex.Nearest(view, cluster_hit_z, cluster_hit_x, pointdist, index) &&
+             ( (pointdist < best_dist) || ((pointdist == best_dist) && (index < best_index)) ) ) {
+          best_dist  = pointdist;
+          best_index = index;
+        }
 
+        first_near = std::min(first_near, trackIndex.FirstTrackWithin(view, cluster_hit_z, cluster_hit_x, cut));
 
-      }//END RECO POINT LOOP
+      }//END CLUSTER HIT LOOP
 
-      // std::cout<<"distance_nu_smallest: "<<distance_nu_smallest<<std::endl;
-      if(pointdistance_smallest<distance_smallest){
-        distance_smallest=pointdistance_smallest;
-        X_reco_best=X_reco_smallest; //variables for the coordinates of the nearest reco track
-        Z_reco_best=Z_reco_smallest; //variables for the coordinates of the nearest reco track
+      if (best_index != gammacatcher::TrackProjectionIndex::kNoTrack) {
+        auto const& best_point = trackIndex.GetPoint(view, best_index);
+        distance_smallest=best_dist;
+        X_reco_best=best_point.x; //variables for the coordinates of the nearest reco track
+        Z_reco_best=best_point.z; //variables for the coordinates of the nearest reco track
       }
+    }
 
+    // The cluster is added to its plane's list once for every (non neutrino) track
+    // looked at while no track had yet come within the distance cut
+    size_t n_far_tracks = std::lower_bound(checked_tracks.begin(), checked_tracks.end(), first_near) - checked_tracks.begin();
 
-      //}//END RECO TRACK FOR LOOP
-
-
-
-
-
-
+    for (size_t n = 0; n < n_far_tracks; n++) {
 
-      // if(cluster[i_c].View()==2 && (distance_smallest > f2DcutY || (distance_smallest_nu > 2.0 && track_point_length_smallest>4.0 ) || (distance_smallest_nu > (2.0*track_point_length_smallest/4.0) && track_point_length_smallest<4.0 )  )) {// IF LOOP TO CHECK WHAT PLANE A CLUSTER BELONGS TO
-      if(cluster[i_c].View()==2 && (distance_smallest > f2DcutY)){
+      if(cluster[i_c].View()==2){
 
 
         Start_Cluster2.push_back((cluster[i_c].StartTick ())-3.0);//added +- 3.0 time tick tolerances
         End_Cluster2.push_back((cluster[i_c].EndTick ())+3.0);
-        // Start_Cluster2.push_back((cluster[i_c].StartTick ()));//added +- 3.0 time tick tolerances
-        // End_Cluster2.push_back((cluster[i_c].EndTick ()));
         Y_clus_hitsize.push_back(clus_hit_assn_v.at(i_c).size());
         Y_index_vector.push_back(i_c); //Y Index vector to store the event index for a given cluster. Very important variable for getting cluster-hit associaton
       }
 
-      if(cluster[i_c].View()==1 && (distance_smallest > f2DcutUV )){//IF LOOP TO CHECK WHAT PLANE A CLUSTER BELONGS TO
+      if(cluster[i_c].View()==1){//IF LOOP TO CHECK WHAT PLANE A CLUSTER BELONGS TO
 
 
         Start_Cluster1.push_back((cluster[i_c].StartTick ())-3.0);
         End_Cluster1.push_back((cluster[i_c].EndTick ())+3.0);
         V_clus_hitsize.push_back(clus_hit_assn_v.at(i_c).size());
-        // Start_Cluster1.push_back((cluster[i_c].StartTick ()));
-        // End_Cluster1.push_back((cluster[i_c].EndTick ()));
         V_index_vector.push_back(i_c);//V Index vector to store the event index for a given cluster. Very important variable for getting cluster-hit associaton
       }
 
-      if(cluster[i_c].View()==0 && (distance_smallest > f2DcutUV )){//IF LOOP TO CHECK WHAT PLANE A CLUSTER BELONGS TO
+      if(cluster[i_c].View()==0){//IF LOOP TO CHECK WHAT PLANE A CLUSTER BELONGS TO
 
-        //
         Start_Cluster0.push_back((cluster[i_c].StartTick ())-3.0);
         End_Cluster0.push_back((cluster[i_c].EndTick ())+3.0);
         U_clus_hitsize.push_back(clus_hit_assn_v.at(i_c).size());
-        // Start_Cluster0.push_back((cluster[i_c].StartTick ()));
-        // End_Cluster0.push_back((cluster[i_c].EndTick ()));
         U_index_vector.push_back(i_c);//U Index vector to store the event index for a given cluster. Very important variable for getting cluster-hit associaton
       }
 
-
-    }//END RECO TRACK FOR LOOP (Thanks to Ivan Lepetic for pointing this out)
+    }
 
     Clustertree->Fill();
   }//end cluster FOR loop for calculating 2-D distance
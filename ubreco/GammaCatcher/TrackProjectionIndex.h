@@ -0,0 +1,232 @@
+/**
+ * \file TrackProjectionIndex.h
+ *
+ * \ingroup GammaCatcher
+ *
+ * \brief Reco track trajectory points projected on each plane, binned for fast lookup from hits
+ *
+ */
+
+/** \addtogroup GammaCatcher
+
+    @{*/
+
+#ifndef GAMMACATCHER_TRACKPROJECTIONINDEX_H
+#define GAMMACATCHER_TRACKPROJECTIONINDEX_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "lardataobj/RecoBase/Track.h"
+#include "larcore/Geometry/WireReadout.h"
+
+namespace gammacatcher {
+  /**
+     \class TrackProjectionIndex
+     Trajectory points of all reco tracks of an event, projected once on each plane
+     in the (wire [cm], x [cm]) coordinates used to compare with cluster hits
+     (the collection plane uses z directly) and binned in a uniform grid.
+     Points are kept in loop order (track, then trajectory point) and ties are
+     resolved towards the earlier point, so queries return what a full scan
+     over tracks and points with a strict "<" comparison would.
+   */
+  class TrackProjectionIndex {
+
+  public:
+
+    /// A projected trajectory point
+    struct Point {
+      double w, t; ///< projected coordinates [cm]
+      double x, z; ///< 3D coordinates of the trajectory point [cm]
+      size_t track; ///< index of the track in the input vector
+    };
+
+    static constexpr size_t kNoTrack = std::numeric_limits<size_t>::max();
+
+    TrackProjectionIndex(size_t nplanes = 3, double cellsize = 5.)
+      : _cellSize(cellsize), _planes(nplanes)
+    {}
+
+    /**
+       Project the trajectory points of all tracks with skip[track] == false
+       (an empty skip vector keeps all tracks) and build the grid of each plane.
+    */
+    void Fill(const std::vector<recob::Track>& tracks,
+	      const geo::WireReadoutGeom& channelMap,
+	      double wire2cm,
+	      const std::vector<bool>& skip = std::vector<bool>())
+    {
+      for (auto& plane : _planes) plane.points.clear();
+
+      for (size_t i_t = 0; i_t < tracks.size(); i_t++) {
+	if ( (i_t < skip.size()) && skip[i_t] ) continue;
+	auto const& track = tracks[i_t];
+	for (size_t m = 0; m < track.NumberTrajectoryPoints(); m++) {
+	  auto const& track_loc = track.LocationAtPoint(m);
+	  for (size_t pl = 0; pl < _planes.size(); pl++) {
+	    Point pt;
+	    pt.x = track_loc.X();
+	    pt.z = track_loc.Z();
+	    pt.t = pt.x;
+	    pt.w = (pl == 2) ? pt.z : channelMap.Plane(geo::PlaneID(0,0,pl)).WireCoordinate(track_loc) * wire2cm;
+	    pt.track = i_t;
+	    _planes[pl].points.push_back(pt);
+	  }
+	}
+      }
+
+      for (auto& plane : _planes) BuildGrid(plane);
+    }
+
+    /// number of points projected on a plane
+    size_t NumPoints(size_t plane) const { return _planes.at(plane).points.size(); }
+
+    /// projected point on a plane
+    const Point& GetPoint(size_t plane, size_t index) const { return _planes.at(plane).points.at(index); }
+
+    /// distance between a hit and a projected point, as computed by the analysis
+    static double Distance(double w, double t, const Point& pt)
+    { return sqrt((pow(w-pt.w,2))+(pow(t-pt.t,2))); }
+
+    /**
+       Nearest point to (w,t) on a plane. Returns false if the plane has no points.
+       Among points at the same distance the earliest one is returned.
+    */
+    bool Nearest(size_t plane, double w, double t, double& dist, size_t& index) const
+    {
+      auto const& pl = _planes.at(plane);
+      if (pl.points.empty()) return false;
+
+      dist  = std::numeric_limits<double>::max();
+      index = kNoTrack;
+
+      auto visit = [&](int i, int j) {
+	if ( (j < 0) || (j >= pl.nT) ) return;
+	size_t cell = i * pl.nT + j;
+	for (size_t n = pl.cellStart[cell]; n < pl.cellStart[cell+1]; n++) {
+	  size_t idx = pl.cells[n];
+	  double d = Distance(w,t,pl.points[idx]);
+	  if ( (d < dist) || ((d == dist) && (idx < index)) ) { dist = d; index = idx; }
+	}
+      };
+
+      // search rings of cells around the one containing (w,t),
+      // from the first ring touching the grid to the one covering all of it
+      int ci = CellW(pl,w);
+      int cj = CellT(pl,t);
+      int kmin = std::max( std::max(-ci, ci - (pl.nW - 1)), std::max(-cj, cj - (pl.nT - 1)) );
+      int kmax = std::max( std::max(ci, pl.nW - 1 - ci), std::max(cj, pl.nT - 1 - cj) );
+      kmin = std::max(kmin, 0);
+
+      for (int k = kmin; k <= kmax; k++) {
+	// points in ring k or beyond are at least k-1 cells away
+	if ( (index != kNoTrack) && (dist < (k-1)*pl.cellSize - kTolerance) ) break;
+	for (int i = std::max(ci - k, 0); i <= std::min(ci + k, pl.nW - 1); i++) {
+	  if ( (i == ci - k) || (i == ci + k) ) {
+	    for (int j = std::max(cj - k, 0); j <= std::min(cj + k, pl.nT - 1); j++) visit(i,j);
+	  }
+	  else {
+	    visit(i,cj - k);
+	    visit(i,cj + k);
+	  }
+	}
+      }
+      return (index != kNoTrack);
+    }
+
+    /**
+       Smallest track index with a point within distance r of (w,t) on a plane
+       (kNoTrack if there is none).
+    */
+    size_t FirstTrackWithin(size_t plane, double w, double t, double r) const
+    {
+      auto const& pl = _planes.at(plane);
+      size_t first = kNoTrack;
+      if (pl.points.empty()) return first;
+
+      int imin = std::max(CellW(pl,w-r-kTolerance), 0);
+      int imax = std::min(CellW(pl,w+r+kTolerance), pl.nW - 1);
+      int jmin = std::max(CellT(pl,t-r-kTolerance), 0);
+      int jmax = std::min(CellT(pl,t+r+kTolerance), pl.nT - 1);
+
+      for (int i = imin; i <= imax; i++) {
+	for (int j = jmin; j <= jmax; j++) {
+	  size_t cell = i * pl.nT + j;
+	  for (size_t n = pl.cellStart[cell]; n < pl.cellStart[cell+1]; n++) {
+	    auto const& pt = pl.points[pl.cells[n]];
+	    if ( (pt.track < first) && !(Distance(w,t,pt) > r) ) first = pt.track;
+	  }
+	}
+      }
+      return first;
+    }
+
+  private:
+
+    /// slack on grid bounds, to be safe against rounding in the distance
+    static constexpr double kTolerance = 1e-6;
+    /// cap on the number of grid cells per plane
+    static constexpr double kMaxCells = 1 << 20;
+
+    /// points of one plane and their grid, cells stored contiguously
+    struct PlaneIndex {
+      std::vector<Point> points;
+      double cellSize = 5.;
+      double wMin = 0, tMin = 0;
+      int nW = 0, nT = 0;
+      std::vector<size_t> cellStart;
+      std::vector<size_t> cells;
+    };
+
+    int CellW(const PlaneIndex& pl, double w) const
+    { return (int)std::floor(std::max(std::min((w - pl.wMin) / pl.cellSize, 1e9), -1e9)); }
+
+    int CellT(const PlaneIndex& pl, double t) const
+    { return (int)std::floor(std::max(std::min((t - pl.tMin) / pl.cellSize, 1e9), -1e9)); }
+
+    void BuildGrid(PlaneIndex& pl) const
+    {
+      pl.cellSize = _cellSize;
+      pl.nW = pl.nT = 0;
+      pl.cellStart.assign(1,0);
+      pl.cells.clear();
+      if (pl.points.empty()) return;
+
+      double wMax = pl.points[0].w, tMax = pl.points[0].t;
+      pl.wMin = wMax;
+      pl.tMin = tMax;
+      for (auto const& pt : pl.points) {
+	pl.wMin = std::min(pl.wMin, pt.w);
+	pl.tMin = std::min(pl.tMin, pt.t);
+	wMax = std::max(wMax, pt.w);
+	tMax = std::max(tMax, pt.t);
+      }
+      // grow the cells for very sparse events
+      while ( ((wMax - pl.wMin) / pl.cellSize + 1) * ((tMax - pl.tMin) / pl.cellSize + 1) > kMaxCells )
+	pl.cellSize *= 2;
+      pl.nW = CellW(pl,wMax) + 1;
+      pl.nT = CellT(pl,tMax) + 1;
+
+      // counting sort of the points into cells, keeping their order
+      pl.cellStart.assign(pl.nW * pl.nT + 1, 0);
+      for (auto const& pt : pl.points)
+	pl.cellStart[CellW(pl,pt.w) * pl.nT + CellT(pl,pt.t) + 1] += 1;
+      for (size_t c = 1; c < pl.cellStart.size(); c++)
+	pl.cellStart[c] += pl.cellStart[c-1];
+      std::vector<size_t> fill(pl.cellStart.begin(), pl.cellStart.end() - 1);
+      pl.cells.resize(pl.points.size());
+      for (size_t n = 0; n < pl.points.size(); n++) {
+	auto const& pt = pl.points[n];
+	pl.cells[ fill[CellW(pl,pt.w) * pl.nT + CellT(pl,pt.t)]++ ] = n;
+      }
+    }
+
+    double _cellSize;
+    std::vector<PlaneIndex> _planes;
+
+  };
+}
+#endif
+/** @} */ // end of doxygen group
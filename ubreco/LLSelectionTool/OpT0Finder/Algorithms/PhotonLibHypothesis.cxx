@@ -16,6 +16,9 @@ static PhotonLibHypothesisFactory __global_PhotonLibHypothesisFactory__;
 
 PhotonLibHypothesis::PhotonLibHypothesis(const std::string name)
     : BaseFlashHypothesis(name)
+    , _vis(nullptr)
+    , _use_cache(true)
+    , _max_cached_voxels(100000)
 {
 }
 
@@ -30,37 +33,156 @@ void PhotonLibHypothesis::_Configure_(const Config_t &pset)
                   << " != number of opdet (" << NOpDets() << ")!" << std::endl;
     throw OpT0FinderException();
   }
+
+  // The cache assumes the service returns the same visibility anywhere within a voxel
+  _use_cache = pset.get<bool>("UseVisibilityCache", true);
+  _max_cached_voxels = pset.get<size_t>("MaxCachedVoxels", 100000);
+
+  art::ServiceHandle<phot::PhotonVisibilityService> vis;
+  _vis = vis.get();
+
+  auto const &voxel_def = _vis->GetVoxelDef();
+  auto const lower = voxel_def.GetRegionLowerCorner();
+  auto const upper = voxel_def.GetRegionUpperCorner();
+  auto const steps = voxel_def.GetSteps();
+  _voxel_lower[0] = lower.X();
+  _voxel_lower[1] = lower.Y();
+  _voxel_lower[2] = lower.Z();
+  _voxel_range[0] = upper.X() - lower.X();
+  _voxel_range[1] = upper.Y() - lower.Y();
+  _voxel_range[2] = upper.Z() - lower.Z();
+  for (size_t i = 0; i < 3; ++i)
+    _voxel_steps[i] = steps[i];
+
+  ClearVisibilityCache();
+  _voxel_row_v.clear();
+}
+
+void PhotonLibHypothesis::ClearVisibilityCache() const
+{
+  for (auto const &voxel : _cached_voxel_v)
+    _voxel_row_v[voxel] = -1;
+  _cached_voxel_v.clear();
+  _row_table.clear();
+  _trk_y_v.clear();
+  _trk_z_v.clear();
+  _trk_yz_v.clear();
+}
+
+const double *PhotonLibHypothesis::VisibilityRow(const int voxel, const double *xyz) const
+{
+  size_t n_pmt = BaseAlgorithm::NOpDets();
+
+  if (_voxel_row_v.empty())
+    _voxel_row_v.resize((size_t)(_voxel_steps[0]) * _voxel_steps[1] * _voxel_steps[2], -1);
+
+  int row = _voxel_row_v[voxel];
+  if (row < 0)
+  {
+    if (_cached_voxel_v.size() >= _max_cached_voxels)
+    {
+      for (auto const &cached : _cached_voxel_v)
+        _voxel_row_v[cached] = -1;
+      _cached_voxel_v.clear();
+      _row_table.clear();
+    }
+    row = _cached_voxel_v.size();
+    _voxel_row_v[voxel] = row;
+    _cached_voxel_v.push_back(voxel);
+    _row_table.resize(_row_table.size() + n_pmt);
+    double *vis_row = &_row_table[row * n_pmt];
+    for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt)
+      vis_row[ipmt] = _vis->GetVisibility(xyz, ipmt) * _global_qe / _qe_v[ipmt];
+  }
+  return &_row_table[row * n_pmt];
+}
+
+void PhotonLibHypothesis::PrepareTrack(const QCluster_t &trk) const
+{
+  bool same = (trk.size() == _trk_yz_v.size());
+  for (size_t ipt = 0; same && ipt < trk.size(); ++ipt)
+    same = (trk[ipt].y == _trk_y_v[ipt] && trk[ipt].z == _trk_z_v[ipt]);
+  if (same)
+    return;
+
+  _trk_y_v.resize(trk.size());
+  _trk_z_v.resize(trk.size());
+  _trk_yz_v.resize(trk.size());
+  for (size_t ipt = 0; ipt < trk.size(); ++ipt)
+  {
+    auto const &pt = trk[ipt];
+    _trk_y_v[ipt] = pt.y;
+    _trk_z_v[ipt] = pt.z;
+    // same binning as phot::PhotonVoxelDef::GetVoxelID
+    double ystep = (pt.y - _voxel_lower[1]) / _voxel_range[1] * _voxel_steps[1];
+    double zstep = (pt.z - _voxel_lower[2]) / _voxel_range[2] * _voxel_steps[2];
+    if (!(ystep >= 0. && ystep < _voxel_steps[1] && zstep >= 0. && zstep < _voxel_steps[2]))
+      _trk_yz_v[ipt] = -1;
+    else
+      _trk_yz_v[ipt] = _voxel_steps[0] * (int(ystep) + _voxel_steps[1] * int(zstep));
+  }
+}
+
+void PhotonLibHypothesis::FillPoint(const double *xyz, const double q, Flash_t &flash) const
+{
+  size_t n_pmt = BaseAlgorithm::NOpDets();
+  for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt)
+    flash.pe_v[ipmt] += q * (_vis->GetVisibility(xyz, ipmt) * _global_qe / _qe_v[ipmt]);
 }
 
 void PhotonLibHypothesis::FillEstimate(const QCluster_t &trk,
                                        Flash_t &flash) const
 {
-  art::ServiceHandle<phot::PhotonVisibilityService> vis;
-  static double xyz[3] = {0.};
+  FillEstimate(trk, 0., flash);
+}
+
+void PhotonLibHypothesis::FillEstimate(const QCluster_t &trk,
+                                       const double xoffset,
+                                       Flash_t &flash) const
+{
+  double xyz[3] = {0.};
 
   size_t n_pmt = BaseAlgorithm::NOpDets(); //n_pmt returns 0 now, needs to be fixed
 
   for (auto &v : flash.pe_v)
     v = 0;
 
-  for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt)
+  if (!_use_cache)
   {
-
-    for (size_t ipt = 0; ipt < trk.size(); ++ipt)
+    for (auto const &pt : trk)
     {
+      xyz[0] = pt.x + xoffset;
+      xyz[1] = pt.y;
+      xyz[2] = pt.z;
+      FillPoint(xyz, pt.q, flash);
+    }
+    return;
+  }
 
-      auto const &pt = trk[ipt];
+  // Point-major: one voxel lookup per point, then one contiguous row over PMTs
+  PrepareTrack(trk);
 
-      double q = pt.q;
+  double *pe = flash.pe_v.data();
+  for (size_t ipt = 0; ipt < trk.size(); ++ipt)
+  {
+    auto const &pt = trk[ipt];
 
-      //q *= ::phot::PhotonVisibilityService::GetME().GetVisibility( pt.x, pt.y, pt.z, ipmt) * _global_qe / _qe_v[ipmt];
-      xyz[0] = pt.x;
-      xyz[1] = pt.y;
-      xyz[2] = pt.z;
-      q *= vis->GetVisibility(xyz, ipmt) * _global_qe / _qe_v[ipmt];
-      flash.pe_v[ipmt] += q;
-      //std::cout << "PMT : " << ipmt << " [x,y,z] -> [q] : [" << pt.x << ", " << pt.y << ", " << pt.z << "] -> [" << q << std::endl;
+    xyz[0] = pt.x + xoffset;
+    xyz[1] = pt.y;
+    xyz[2] = pt.z;
+
+    double xstep = (xyz[0] - _voxel_lower[0]) / _voxel_range[0] * _voxel_steps[0];
+    if (_trk_yz_v[ipt] < 0 || !(xstep >= 0. && xstep < _voxel_steps[0]))
+    {
+      // outside the voxelised region: let the service decide
+      FillPoint(xyz, pt.q, flash);
+      continue;
     }
+
+    const double q = pt.q;
+    const double *vis_row = VisibilityRow(int(xstep) + _trk_yz_v[ipt], xyz);
+    for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt)
+      pe[ipmt] += q * vis_row[ipmt];
   }
 
   return;
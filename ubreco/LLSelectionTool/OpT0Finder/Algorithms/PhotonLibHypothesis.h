@@ -19,6 +19,8 @@
 #include "ubreco/LLSelectionTool/OpT0Finder/Base/BaseFlashHypothesis.h"
 #include "ubreco/LLSelectionTool/OpT0Finder/Base/FlashHypothesisFactory.h"
 
+namespace phot { class PhotonVisibilityService; }
+
 namespace flashana {
   /**
      \class PhotonLibHypothesis
@@ -36,11 +38,43 @@ namespace flashana {
 
     void FillEstimate(const QCluster_t&, Flash_t&) const;
 
+    void FillEstimate(const QCluster_t&, const double xoffset, Flash_t&) const;
+
+    /// Drop all cached visibility rows
+    void ClearVisibilityCache() const;
+
   protected:
 
     void _Configure_(const Config_t &pset);
+
+    /// Add the light of one point using per-call service lookups
+    void FillPoint(const double* xyz, const double q, Flash_t& flash) const;
+
+    /// QE-scaled visibility of all PMTs for a voxel, looked up from the service on first use
+    const double* VisibilityRow(const int voxel, const double* xyz) const;
+
+    /// Cache the y/z part of the voxel index of each point (no-op if y/z did not change)
+    void PrepareTrack(const QCluster_t& trk) const;
+
     double _global_qe;         ///< Global QE
     std::vector<double> _qe_v; ///< PMT-wise relative QE
+
+    const phot::PhotonVisibilityService* _vis; ///< Photon visibility service (fetched at configuration)
+
+    bool   _use_cache;          ///< Use the voxel visibility cache (requires non-interpolated library lookups)
+    size_t _max_cached_voxels;  ///< Cache is flushed once this many voxels are stored
+
+    double _voxel_lower[3];     ///< Voxelised region lower corner
+    double _voxel_range[3];     ///< Voxelised region size
+    int    _voxel_steps[3];     ///< Number of voxels along x,y,z
+
+    mutable std::vector<int>    _voxel_row_v;     ///< Voxel ID => row index in _row_table (-1 if not cached)
+    mutable std::vector<int>    _cached_voxel_v;  ///< Cached voxel IDs (to reset _voxel_row_v on flush)
+    mutable std::vector<double> _row_table;       ///< Dense [row][pmt] QE-scaled visibilities
+
+    mutable std::vector<double> _trk_y_v;  ///< y of the track whose voxel offsets are cached
+    mutable std::vector<double> _trk_z_v;  ///< z of the track whose voxel offsets are cached
+    mutable std::vector<int>    _trk_yz_v; ///< y/z part of the voxel ID per point (-1 if outside)
   };
   
   /**
@@ -3,21 +3,17 @@
 
 #include "QLLMatch.h"
 #include "ubreco/LLSelectionTool/OpT0Finder/Base/OpT0FinderException.h"
-#include <TMinuit.h>
 #include <cmath>
 #include <numeric>
-#include <TMath.h>
+#include <algorithm>
 
 namespace flashana {
 
   static QLLMatchFactory __global_QLLMatchFactory__;
 
-  QLLMatch *__qll_global__ = nullptr; // A global pointer to be used for MINUIT
-
-  void MIN_vtx_qll(Int_t &, Double_t *, Double_t &, Double_t *, Int_t);
-  
   QLLMatch::QLLMatch(const std::string name)
-    : BaseFlashMatch(name), _mode(kChi2), _record(false), _normalize(false), _minuit_ptr(nullptr)
+    : BaseFlashMatch(name), _mode(kChi2), _record(false), _normalize(false)
+    , _minimizer_tolerance(1.e-2), _minimizer_max_iter(500)
   { _current_llhd = _current_chi2 = -1.0; }
 
   QLLMatch::QLLMatch()
@@ -37,6 +33,9 @@ namespace flashana {
     _onepmt_xdiff_threshold = pset.get<double>("OnePMTXDiffThreshold");
     _onepmt_pesum_threshold = pset.get<double>("OnePMTPESumThreshold");
     _onepmt_pefrac_threshold = pset.get<double>("OnePMTPEFracThreshold");
+
+    _minimizer_tolerance = pset.get<double>("MinimizerTolerance",_minimizer_tolerance);
+    _minimizer_max_iter  = pset.get<size_t>("MinimizerMaxIter",_minimizer_max_iter);
   }
   
   FlashMatch_t QLLMatch::Match(const QCluster_t &pt_v, const Flash_t &flash) {
@@ -143,8 +142,7 @@ namespace flashana {
 
   FlashMatch_t QLLMatch::PESpectrumMatch(const QCluster_t &pt_v, const Flash_t &flash, const bool init_x0) {
     
-    this->CallMinuit(pt_v, flash, init_x0);
-    // Shit happens line above in CallMinuit
+    this->Minimize(pt_v, flash, init_x0);
     
     // Estimate position
     FlashMatch_t res;
@@ -201,17 +199,8 @@ namespace flashana {
     
     for (auto &v : _hypothesis.pe_v) v = 0;
     
-    // Apply xoffset
-    _var_trk.resize(_raw_trk.size());
-    for (size_t pt_index = 0; pt_index < _raw_trk.size(); ++pt_index) {
-      //std::cout << "x point : " << _raw_trk[pt_index].x << "\t offset : " << xoffset << std::endl;
-      _var_trk[pt_index].x = _raw_trk[pt_index].x + xoffset;
-      _var_trk[pt_index].y = _raw_trk[pt_index].y;
-      _var_trk[pt_index].z = _raw_trk[pt_index].z;
-      _var_trk[pt_index].q = _raw_trk[pt_index].q;
-    }
-    
-    FillEstimate(_var_trk, _hypothesis);
+    // Apply xoffset (the hypothesis may reuse per-point information of _raw_trk across offsets)
+    FillEstimate(_raw_trk, xoffset, _hypothesis);
     
     if (_normalize) {
       double qsum = std::accumulate(std::begin(_hypothesis.pe_v),
@@ -228,64 +217,114 @@ namespace flashana {
   double QLLMatch::QLL(const Flash_t &hypothesis,
 		       const Flash_t &measurement) {
     
-    double nvalid_pmt = 0;
-    
-    /* neither PEtot_Hyp norPEtot_Obs are used
-    double PEtot_Hyp = 0;
-    for (auto const &pe : hypothesis.pe_v)
-      PEtot_Hyp += pe;
-    double PEtot_Obs = 0;
-    for (auto const &pe : measurement.pe_v)
-      PEtot_Obs += pe;
-    */
-    
-    _current_chi2 = _current_llhd = 0.;
-    
     if (measurement.pe_v.size() != hypothesis.pe_v.size())
       throw OpT0FinderException("Cannot compute QLL for unmatched length!");
     
-    double O, H, Error;
-    for (size_t pmt_index = 0; pmt_index < hypothesis.pe_v.size(); ++pmt_index) {
-      
-      O = measurement.pe_v[pmt_index]; // observation
-      H = hypothesis.pe_v[pmt_index];  // hypothesis
-      
-      if( H < 0 ) throw OpT0FinderException("Cannot have hypothesis value < 0!");
-      
-      if(O < 0) {
-	if(H < _penalty_threshold_v[pmt_index]) continue;
+    CacheMeasurement(measurement);
+
+    return QLLKernel(hypothesis.pe_v);
+  }
+
+  void QLLMatch::CacheMeasurement(const Flash_t &measurement) {
+
+    size_t npmt = measurement.pe_v.size();
+
+    if (_penalty_threshold_v.size() < npmt || _penalty_value_v.size() < npmt)
+      throw OpT0FinderException("Penalty arrays are shorter than the PMT array!");
+
+    _qll_obs_v.resize(npmt);
+    _qll_thres_v.resize(npmt);
+    _qll_inv_err_v.resize(npmt);
+    _qll_lnfact_v.resize(npmt);
+    _qll_term_v.resize(npmt);
+
+    for (size_t pmt_index = 0; pmt_index < npmt; ++pmt_index) {
+
+      double O = measurement.pe_v[pmt_index];
+      // A PMT w/o observation is only used if the hypothesis is above threshold (H>=0 otherwise)
+      double thres = -1.;
+      if (O < 0) {
+	thres = _penalty_threshold_v[pmt_index];
 	O = _penalty_value_v[pmt_index];
       }
-      
-      nvalid_pmt += 1;
-
-      if(_mode == kLLHD) {
-        /* Replaced block to be used in uboonecode
-        _current_llhd -= std::log10(TMath::Poisson(O,H));
-        if(std::isnan(_current_llhd) || isinf(_current_llhd)) _current_llhd = 1.e6;
-        */
-        // Updated block
-        double arg = TMath::Poisson(O,H);
-        if(arg > 0. && !std::isnan(arg))
-          _current_llhd -= std::log10(arg);
-        else
-          _current_llhd = 1.e6;
-	if(std::isinf(_current_llhd)) _current_llhd = 1.e6;
-        // Updated block ends
-      } else if (_mode == kChi2) {
-        Error = O;
-	if( Error < 1.0 ) Error = 1.0;
-        _current_chi2 += std::pow((O - H), 2) / (Error);
-      } else {
-        FLASH_ERROR() << "Unexpected mode" << std::endl;
-        throw OpT0FinderException();
+      _qll_obs_v[pmt_index]     = O;
+      _qll_thres_v[pmt_index]   = thres;
+      _qll_inv_err_v[pmt_index] = 1. / (O < 1.0 ? 1.0 : O);
+      _qll_lnfact_v[pmt_index]  = (O < 0 ? 0. : std::lgamma(O + 1.));
+    }
+  }
+
+  double QLLMatch::QLLKernel(const std::vector<double> &hypothesis) {
+
+    // Number of independent partial sums, lets the compiler vectorise the reductions
+    static const size_t kLanes = 4;
+    // exp() of anything below this underflows to 0, i.e. TMath::Poisson would return 0
+    static const double kMinLnPoisson = -745.13;
+    static const double kInvLn10 = 1. / std::log(10.);
+
+    if (hypothesis.size() != _qll_obs_v.size())
+      throw OpT0FinderException("Cannot compute QLL for unmatched length!");
+
+    const size_t npmt = hypothesis.size();
+    const double *H_v     = hypothesis.data();
+    const double *O_v     = _qll_obs_v.data();
+    const double *thres_v = _qll_thres_v.data();
+
+    double nvalid[kLanes] = {0.};
+    double sum[kLanes]    = {0.};
+    bool negative = false;
+
+    _current_chi2 = _current_llhd = 0.;
+
+    if (_mode == kChi2) {
+
+      const double *inv_err_v = _qll_inv_err_v.data();
+      for (size_t i = 0; i < npmt; ++i) {
+	const double H = H_v[i];
+	const double valid = (H < thres_v[i] ? 0. : 1.);
+	const double diff = O_v[i] - H;
+	negative = negative || (H < 0);
+	nvalid[i % kLanes] += valid;
+	sum[i % kLanes]    += valid * diff * diff * inv_err_v[i];
       }
+      if (negative) throw OpT0FinderException("Cannot have hypothesis value < 0!");
+
+      for (size_t l = 0; l < kLanes; ++l) _current_chi2 += sum[l];
       
-      //result += std::fabs(  ) * measurement.pe_v[pmt_index];
+    } else if (_mode == kLLHD) {
+
+      // -log10(Poisson(O,H)) per PMT. A PMT where the Poisson probability vanishes resets the
+      // running sum to 1e6 (as the sequential implementation did), so only the terms after the
+      // last such PMT are added on top of it.
+      const double *lnfact_v = _qll_lnfact_v.data();
+      double *term_v = _qll_term_v.data();
+      for (size_t i = 0; i < npmt; ++i) {
+	const double H = H_v[i];
+	const double O = O_v[i];
+	const bool valid = !(H < thres_v[i]);
+	const double lnp = (O > 0. ? O * std::log(H) : 0.) - H - lnfact_v[i];
+	const bool vanish = (O < 0. || !(lnp > kMinLnPoisson));
+	negative = negative || (H < 0);
+	nvalid[i % kLanes] += (valid ? 1. : 0.);
+	term_v[i] = (!valid ? 0. : (vanish ? std::nan("") : -lnp * kInvLn10));
+      }
+      if (negative) throw OpT0FinderException("Cannot have hypothesis value < 0!");
+
+      size_t start = 0;
+      for (size_t i = npmt; i > 0; --i) {
+	if (std::isnan(term_v[i-1])) { start = i; _current_llhd = 1.e6; break; }
+      }
+      for (size_t i = start; i < npmt; ++i) sum[i % kLanes] += term_v[i];
+      for (size_t l = 0; l < kLanes; ++l) _current_llhd += sum[l];
+      if (std::isinf(_current_llhd)) _current_llhd = 1.e6;
       
+    } else {
+      FLASH_ERROR() << "Unexpected mode" << std::endl;
+      throw OpT0FinderException();
     }
-    
-    //std::cout << "PE hyp : " << PEtot_Hyp << "\tPE Obs : " << PEtot_Obs << "\t Chi^2 : " << result << std::endl;
+
+    double nvalid_pmt = 0;
+    for (size_t l = 0; l < kLanes; ++l) nvalid_pmt += nvalid[l];
     
     _current_chi2 /= nvalid_pmt;
     _current_llhd /= (nvalid_pmt +1);
@@ -293,25 +332,16 @@ namespace flashana {
     return (_mode == kChi2 ? _current_chi2 : _current_llhd);
   }
   
-  void MIN_vtx_qll(Int_t & /*Npar*/,
-		   Double_t * /*Grad*/,
-		   Double_t &Fval,
-		   Double_t *Xval,
-		   Int_t /*Flag*/) {
-    
-    //std::cout << "minuit offset : " << Fval << std::endl;
-    ///std::cout << "minuit Xval?? : " << *Xval << std::endl;
-    
-    auto const &hypothesis = __qll_global__->ChargeHypothesis(*Xval);
-    auto const &measurement = __qll_global__->Measurement();
-    Fval = __qll_global__->QLL(hypothesis, measurement);
-    
-    __qll_global__->Record(Xval[0]);
-    
-    return;
+  double QLLMatch::Evaluate(const double xoffset) {
+
+    double qll = QLLKernel(ChargeHypothesis(xoffset).pe_v);
+
+    Record(xoffset);
+
+    return qll;
   }
   
-  double QLLMatch::CallMinuit(const QCluster_t &tpc, const Flash_t &pmt, const bool init_x0) {
+  double QLLMatch::Minimize(const QCluster_t &tpc, const Flash_t &pmt, const bool init_x0) {
     
     if (_measurement.pe_v.empty()) {
       _measurement.pe_v.resize(NOpDets(), 0.);
@@ -332,92 +362,126 @@ namespace flashana {
     //
     double max_pe = 1.;
 
-    // Debug: Print out expected PE spectrum
-    //for(size_t i=0; i<pmt.pe_v.size(); ++i) {
-    //std::cout << "PE meas: " << i << " " << pmt.pe_v[i] << std::endl;
-    //}
-    
     if (_normalize) {
       max_pe = 0;
       for (auto const &v : pmt.pe_v) if (v > max_pe) max_pe = v;
     }
     
     for (size_t i = 0; i < pmt.pe_v.size(); ++i)  _measurement.pe_v[i] = pmt.pe_v[i] / max_pe;
+
+    CacheMeasurement(_measurement);
     
     _minimizer_record_chi2_v.clear();
     _minimizer_record_llhd_v.clear();
     _minimizer_record_x_v.clear();
     
-    if (!_minuit_ptr) _minuit_ptr = new TMinuit(4);
-    
+    //
+    // Bracket the minimum going downhill from the initial point (same range as the former MINUIT limits)
+    //
+    static const double kGolden = 1.618034;
+    static const double kCGold  = 0.3819660;
+
+    const double xlow  = -1.0;
+    const double xhigh = ActiveXMax() - (_raw_xmax_pt.x - _raw_xmin_pt.x) + 20.0;
+    auto clamp = [xlow,xhigh](double x) { return (x < xlow ? xlow : (x > xhigh ? xhigh : x)); };
+
     double reco_x = 0.;
     if (!init_x0)
       reco_x = (ActiveXMax() - (_raw_xmax_pt.x - _raw_xmin_pt.x)) / 2.;
     double reco_x_err = (ActiveXMax() - (_raw_xmax_pt.x - _raw_xmin_pt.x)) / 2.;
-    double MinFval;
-    int ierrflag, npari, nparx, istat;
-    double arglist[4], Fmin, Fedm, Errdef;
-    ierrflag = npari = nparx = istat = 0;
-    
-    _minuit_ptr->SetPrintLevel(-1);
-    arglist[0] = 2.0;
-    _minuit_ptr->mnexcm("SET STR", arglist, 1, ierrflag);
-   
-    __qll_global__ = this;
+    double step = (reco_x_err > _minimizer_tolerance ? reco_x_err : 10. * _minimizer_tolerance);
 
-    _minuit_ptr->SetFCN(MIN_vtx_qll);
-    
-    _minuit_ptr->DefineParameter(0, "X", reco_x, reco_x_err, -1.0, ActiveXMax() - (_raw_xmax_pt.x - _raw_xmin_pt.x) + 20.0 );
-    
-    _minuit_ptr->Command("SET NOW");
-    
-    // use Migrad minimizer
-    
-    arglist[0] = 5000;
-    _minuit_ptr->mnexcm("MIGRAD", arglist, 1, ierrflag);
-    
-    //arglist[0]   = 5.0e+2;
-    //arglist[1]   = 1.0e-6;
-    //_minuit_ptr->mnexcm ("simplex",arglist,2,ierrflag);
-    
-    _minuit_ptr->GetParameter(0, reco_x, reco_x_err);
-    
-    _minuit_ptr->mnstat(Fmin, Fedm, Errdef, npari, nparx, istat);
-    
-    // use this for debugging, maybe uncomment the actual minimzing function (MIGRAD / simplex calls)
-    // scanning the parameter set
-    //arglist[0] = 0;       // Parameter No (in our case x is the only and therefore the 0th parameter)
-    //arglist[1] = 500;    // Number of points
-    //arglist[2] = 0;       // Start point of scan
-    //arglist[3] = 256;     // End point of scan
-    //_minuit_ptr->mnexcm("scan", arglist,4, ierrflag);
-    
-    MinFval = Fmin;
-    double *grad = 0;
-    int nPar = 1;
-    double fValue[1];
-    fValue[0] = reco_x;
-    // Transfer the minimization variables:
-    MIN_vtx_qll(nPar, grad, Fmin,
-		fValue, ierrflag);
-    //static bool show = true;
-    /*
-      if(show){
-      if(Fmin!=MinFval)std::cout<<"Fmin "<<Fmin<<" not equall to "<<MinFval<<std::endl;
-      show=false;
+    double ax = clamp(reco_x);
+    double fa = Evaluate(ax);
+    double bx = clamp(ax + step);
+    if (bx == ax) bx = clamp(ax - step);
+    double fb = Evaluate(bx);
+    if (fb > fa) { std::swap(ax,bx); std::swap(fa,fb); }
+
+    double cx = bx;
+    size_t iter = 0;
+    while (iter++ < _minimizer_max_iter) {
+      cx = clamp(bx + kGolden * (bx - ax));
+      if (cx == bx) break; // hit the boundary while going downhill
+      double fc = Evaluate(cx);
+      if (fc >= fb) break;
+      ax = bx; fa = fb;
+      bx = cx; fb = fc;
+    }
+
+    //
+    // Brent's method (parabolic interpolation + golden section) within [a,b]
+    //
+    double a = std::min(ax,cx);
+    double b = std::max(ax,cx);
+    double x = bx, w = bx, v = bx;
+    double fx = fb, fw = fb, fv = fb;
+    double d = 0., e = 0.;
+    for (iter = 0; iter < _minimizer_max_iter; ++iter) {
+      double xm = 0.5 * (a + b);
+      double tol1 = _minimizer_tolerance + 1.e-8 * std::fabs(x);
+      double tol2 = 2. * tol1;
+      if (std::fabs(x - xm) <= (tol2 - 0.5 * (b - a))) break;
+      if (std::fabs(e) > tol1) {
+	double r = (x - w) * (fx - fv);
+	double q = (x - v) * (fx - fw);
+	double p = (x - v) * q - (x - w) * r;
+	q = 2. * (q - r);
+	if (q > 0.) p = -p;
+	q = std::fabs(q);
+	double etemp = e;
+	e = d;
+	if (std::fabs(p) >= std::fabs(0.5 * q * etemp) || p <= q * (a - x) || p >= q * (b - x)) {
+	  e = (x >= xm ? a - x : b - x);
+	  d = kCGold * e;
+	}
+	else {
+	  d = p / q;
+	  double u = x + d;
+	  if (u - a < tol2 || b - u < tol2) d = (xm - x >= 0. ? tol1 : -tol1);
+	}
       }
-    */
-    
-    // Transfer the minimization variables:
+      else {
+	e = (x >= xm ? a - x : b - x);
+	d = kCGold * e;
+      }
+      double u = (std::fabs(d) >= tol1 ? x + d : x + (d >= 0. ? tol1 : -tol1));
+      double fu = Evaluate(u);
+      if (fu <= fx) {
+	if (u >= x) a = x; else b = x;
+	v = w; fv = fw;
+	w = x; fw = fx;
+	x = u; fx = fu;
+      }
+      else {
+	if (u < x) a = u; else b = u;
+	if (fu <= fw || w == x) {
+	  v = w; fv = fw;
+	  w = u; fw = fu;
+	}
+	else if (fu <= fv || v == x || v == w) {
+	  v = u; fv = fu;
+	}
+      }
+    }
+    reco_x = x;
+
+    //
+    // Parabolic error from the curvature at the minimum (as MINUIT with ERRDEF=1)
+    //
+    double xl = clamp(x - step * 0.01);
+    double xr = clamp(x + step * 0.01);
+    if (xl < x && x < xr) {
+      double fl = Evaluate(xl);
+      double fr = Evaluate(xr);
+      double curvature = 2. * ((fr - fx) / (xr - x) - (fx - fl) / (x - xl)) / (xr - xl);
+      if (curvature > 0.) reco_x_err = std::sqrt(2. / curvature);
+    }
+
+    // Transfer the minimization variables (also leaves _hypothesis at the minimum):
+    _qll = Evaluate(reco_x);
     _reco_x_offset = reco_x;
     _reco_x_offset_err = reco_x_err;
-    _qll = MinFval;
-    
-    // Clear:
-    _minuit_ptr->mnexcm("clear", arglist, 0, ierrflag);
-    
-    if (_minuit_ptr) delete _minuit_ptr;
-    _minuit_ptr = 0;
     
     return _qll;
   }
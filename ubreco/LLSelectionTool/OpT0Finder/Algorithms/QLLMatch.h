@@ -17,7 +17,6 @@
 #include <iostream>
 #include "ubreco/LLSelectionTool/OpT0Finder/Base/FlashMatchFactory.h"
 #include "ubreco/LLSelectionTool/OpT0Finder/Base/BaseFlashMatch.h"
-#include <TMinuit.h>
 namespace flashana {
   /**
      \class QLLMatch
@@ -44,12 +43,18 @@ namespace flashana {
     /// Core function: execute matching
     FlashMatch_t Match(const QCluster_t&, const Flash_t&);
 
+    /// All matching state is per instance
+    bool Reentrant() const { return true; }
+
     const Flash_t& ChargeHypothesis(const double);
     const Flash_t& Measurement() const;
 
     double QLL(const flashana::Flash_t&,
 	       const flashana::Flash_t&);
 
+    /// Evaluate the QLL of the hypothesis at a given x-offset against the cached measurement
+    double Evaluate(const double xoffset);
+
     void Record(const double x)
     {
       if(_record) {
@@ -59,9 +64,16 @@ namespace flashana {
       }
     }
 
+    /// 1-D bracketed Brent minimisation of the QLL over the x-offset
+    double Minimize(const QCluster_t& tpc,
+		    const Flash_t& pmt,
+		    const bool init_x0=true);
+
+    /// Kept for backward compatibility, calls Minimize (no MINUIT involved anymore)
     double CallMinuit(const QCluster_t& tpc,
 		      const Flash_t& pmt,
-		      const bool init_x0=true);
+		      const bool init_x0=true)
+    { return Minimize(tpc,pmt,init_x0); }
 
     const std::vector<double>& HistoryLLHD() const { return _minimizer_record_llhd_v; }
     const std::vector<double>& HistoryChi2() const { return _minimizer_record_chi2_v; }
@@ -77,8 +89,12 @@ namespace flashana {
 
     FlashMatch_t OnePMTMatch(const Flash_t &flash);
 
-    static QLLMatch* _me;
-    
+    /// Fill the per-PMT arrays used by QLLKernel from a measurement
+    void CacheMeasurement(const Flash_t& measurement);
+
+    /// Chi2/LLHD reduction over PMTs for a hypothesis against the cached measurement
+    double QLLKernel(const std::vector<double>& hypothesis);
+
     QLLMode_t _mode;   ///< Minimizer mode
     bool _record;      ///< Boolean switch to record minimizer history
     double _normalize; ///< Noramalize hypothesis PE spectrum
@@ -89,7 +105,6 @@ namespace flashana {
     flashana::QCluster_t _raw_trk;
     QPoint_t _raw_xmin_pt;
     QPoint_t _raw_xmax_pt;
-    flashana::QCluster_t _var_trk;
     flashana::Flash_t    _hypothesis;  ///< Hypothesis PE distribution over PMTs
     flashana::Flash_t    _measurement; ///< Flash PE distribution over PMTs
 
@@ -103,7 +118,14 @@ namespace flashana {
     double _reco_x_offset_err; ///< reconstructed X offset w/ error
     double _qll;               ///< Minimizer return value
 
-    TMinuit* _minuit_ptr;
+    double _minimizer_tolerance; ///< Absolute x tolerance [cm] of the Brent minimisation
+    size_t _minimizer_max_iter;  ///< Maximum number of bracketing/Brent iterations
+
+    std::vector<double> _qll_obs_v;     ///< Observed PE after penalty substitution
+    std::vector<double> _qll_thres_v;   ///< Hypothesis PE below which a PMT is skipped
+    std::vector<double> _qll_inv_err_v; ///< 1/Error for the chi2 mode
+    std::vector<double> _qll_lnfact_v;  ///< ln(O!) for the LLHD mode
+    std::vector<double> _qll_term_v;    ///< Per-PMT LLHD terms (scratch)
 
     double _recox_penalty_threshold;
     double _recoz_penalty_threshold;
@@ -14,5 +14,13 @@ namespace flashana {
     return res;
   }
 
+  void BaseFlashHypothesis::FillEstimate(const QCluster_t& tpc, const double xoffset, Flash_t& opdet) const
+  {
+    QCluster_t shifted(tpc);
+    for (auto& pt : shifted) pt.x += xoffset;
+
+    FillEstimate(shifted,opdet);
+  }
+
 }
 #endif
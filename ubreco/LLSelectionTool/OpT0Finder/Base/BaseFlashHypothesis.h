@@ -40,6 +40,13 @@ namespace flashana {
     /// Method to simply fill provided reference of flashana::Flash_t
     virtual void FillEstimate(const QCluster_t&, Flash_t&) const = 0;
 
+    /**
+       Method to fill provided reference of flashana::Flash_t for a TPC object shifted by xoffset \n
+       along x. Used while scanning/minimising over x: implementations may keep per-point information \n
+       of the TPC object across calls. The default shifts a copy and calls FillEstimate.
+    */
+    virtual void FillEstimate(const QCluster_t&, const double xoffset, Flash_t&) const;
+
   };
 }
 #endif
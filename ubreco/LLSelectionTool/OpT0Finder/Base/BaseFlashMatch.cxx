@@ -15,6 +15,11 @@ namespace flashana {
     _flash_hypothesis->FillEstimate(tpc,opdet);
   }
 
+  void BaseFlashMatch::FillEstimate(const QCluster_t& tpc, const double xoffset, Flash_t& opdet) const
+  {
+    _flash_hypothesis->FillEstimate(tpc,xoffset,opdet);
+  }
+
   void BaseFlashMatch::SetFlashHypothesis(flashana::BaseFlashHypothesis* alg)
   {
     _flash_hypothesis = alg;
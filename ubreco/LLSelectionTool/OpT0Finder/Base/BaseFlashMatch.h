@@ -60,6 +60,15 @@ namespace flashana {
     /// Method to simply fill provided reference of flashana::Flash_t
     void FillEstimate(const QCluster_t&, Flash_t&) const;
 
+    /// Method to fill provided reference of flashana::Flash_t for a TPC object shifted along x
+    void FillEstimate(const QCluster_t&, const double xoffset, Flash_t&) const;
+
+    /**
+       True if separate instances of the algorithm can run Match concurrently (no static/global \n
+       state). flashana::FlashMatchManager only scores pairs in parallel for such algorithms.
+    */
+    virtual bool Reentrant() const { return false; }
+
   private:
 
     void SetFlashHypothesis(flashana::BaseFlashHypothesis*);
@@ -4,6 +4,7 @@
 #include <sstream>
 #include <map>
 #include <set>
+#include <algorithm>
 #include "FlashMatchManager.h"
 #include "OpT0FinderException.h"
 #include "FlashFilterFactory.h"
@@ -14,6 +15,7 @@
 #include "CustomAlgoFactory.h"
 
 #include "larcore/Geometry/WireReadout.h"
+#include "ubreco/Utilities/ParallelFor.h"
 
 namespace flashana {
 
@@ -25,6 +27,8 @@ namespace flashana {
     , _alg_flash_hypothesis(nullptr)
     , _configured(false)
     , _name(name)
+    , _store_full(false)
+    , _num_threads(1)
   {
     _allow_reuse_flash = true;
   }
@@ -102,6 +106,8 @@ namespace flashana {
     _allow_reuse_flash = mgr_cfg.get<bool>("AllowReuseFlash");
     this->set_verbosity((msg::Level_t)(mgr_cfg.get<unsigned int>("Verbosity")));
     _store_full = mgr_cfg.get<bool>("StoreFullResult");
+    _num_threads = mgr_cfg.get<size_t>("NumThreads",1);
+    if(!_num_threads) _num_threads = 1;
 
     //auto const& detector_cfg = main_cfg.get<flashana::Config_t>("DetectorConfiguration");
     //auto const& pmt_pos_cfg = detector_cfg.get<flashana::Config_t>("PMTPosition");
@@ -211,6 +217,37 @@ namespace flashana {
       name_ptr.second->Configure(main_cfg.get<flashana::Config_t>(name_ptr.first));
     }
 
+    // Per-worker copies of the hypothesis & matching algorithms, created & configured the same way
+    _worker_flash_match_v.clear();
+    _worker_flash_hypothesis_v.clear();
+    if (_num_threads > 1 && _alg_flash_match && _alg_flash_hypothesis) {
+      if (!_alg_flash_match->Reentrant()) {
+	FLASH_WARNING() << "Match algorithm " << match_name
+			<< " is not re-entrant: scoring TPC/flash pairs in a single thread" << std::endl;
+	_num_threads = 1;
+      }
+      for (size_t worker = 1; worker < _num_threads; ++worker) {
+	BaseFlashHypothesis* hypothesis = FlashHypothesisFactory::get().create(hypothesis_name,hypothesis_name);
+	hypothesis->SetOpDetPositions(pmt_x_pos, pmt_y_pos, pmt_z_pos);
+	hypothesis->SetActiveVolume( det_xrange[0], det_xrange[1],
+				     det_yrange[0], det_yrange[1],
+				     det_zrange[0], det_zrange[1] );
+	hypothesis->SetDriftVelocity( drift_velocity );
+	hypothesis->Configure(main_cfg.get<flashana::Config_t>(hypothesis->AlgorithmName()));
+	_worker_flash_hypothesis_v.emplace_back(hypothesis);
+
+	BaseFlashMatch* match = FlashMatchFactory::get().create(match_name,match_name);
+	match->SetOpDetPositions(pmt_x_pos, pmt_y_pos, pmt_z_pos);
+	match->SetActiveVolume( det_xrange[0], det_xrange[1],
+				det_yrange[0], det_yrange[1],
+				det_zrange[0], det_zrange[1] );
+	match->SetFlashHypothesis(hypothesis);
+	match->SetDriftVelocity( drift_velocity );
+	match->Configure(main_cfg.get<flashana::Config_t>(match->AlgorithmName()));
+	_worker_flash_match_v.emplace_back(match);
+      }
+    }
+
     _configured = true;
   }
 
@@ -336,8 +373,11 @@ namespace flashana {
     // use multi-map for possible equally-scored matches
     std::multimap<double, FlashMatch_t> score_map;
 
-    // Double loop over a list of tpc object & flash
-    // Call matching function to inspect the compatibility.
+    // Double loop over a list of tpc object & flash to collect the candidate pairs
+    // (match-prohibit algo is run here, it is cheap and may not be re-entrant)
+    IDArray_t pair_tpc_v, pair_flash_v;
+    pair_tpc_v.reserve(tpc_index_v.size() * flash_index_v.size());
+    pair_flash_v.reserve(tpc_index_v.size() * flash_index_v.size());
     for (size_t tpc_index = 0; tpc_index < tpc_index_v.size(); ++tpc_index) {
       // Loop over flash list
       for (auto const& flash_index : flash_index_v) {
@@ -355,29 +395,42 @@ namespace flashana {
             continue;
         }
 
-        auto res = _alg_flash_match->Match( tpc, flash ); // Run matching
+	pair_tpc_v.push_back(tpc_index);
+	pair_flash_v.push_back(flash_index);
+      }
+    }
+
+    // Call matching function to inspect the compatibility (possibly in parallel)
+    std::vector<FlashMatch_t> pair_res_v;
+    ScorePairs(pair_tpc_v, pair_flash_v, pair_res_v);
 
-        // ignore this match if the score is <= 0
-        if (res.score <= 0) continue;
+    // Fill the score map in the pair order, so equally-scored matches keep the serial ordering
+    for (size_t pair_index = 0; pair_index < pair_res_v.size(); ++pair_index) {
 
-        // Else we store this match. Assign TPC & flash index info
-        res.tpc_id = tpc_index_v[tpc_index];//_index;
-        res.flash_id = flash_index;//_index;
+      auto& res = pair_res_v[pair_index];
+      auto const& tpc_index   = pair_tpc_v[pair_index];
+      auto const& flash_index = pair_flash_v[pair_index];
 
-	if(_store_full) {
-	  _res_tpc_flash_v[res.tpc_id][res.flash_id] = res;
-	  _res_flash_tpc_v[res.flash_id][res.tpc_id] = res;
-	}
-        // For ordering purpose, take an inverse of the score for sorting
-        score_map.emplace( 1. / res.score, res);
+      // ignore this match if the score is <= 0
+      if (res.score <= 0) continue;
 
-        FLASH_DEBUG() << "Candidate Match: "
-		      << " TPC=" << tpc_index << " @ " << tpc.time
-		      << " with Flash=" << flash_index << " @ " << flash.time
-		      << " ... Score=" << res.score
-		      << " ... PE=" << flash.TotalPE()
-		      << std::endl;
+      // Else we store this match. Assign TPC & flash index info
+      res.tpc_id = tpc_index_v[tpc_index];//_index;
+      res.flash_id = flash_index;//_index;
+
+      if(_store_full) {
+	_res_tpc_flash_v[res.tpc_id][res.flash_id] = res;
+	_res_flash_tpc_v[res.flash_id][res.tpc_id] = res;
       }
+      // For ordering purpose, take an inverse of the score for sorting
+      score_map.emplace( 1. / res.score, res);
+
+      FLASH_DEBUG() << "Candidate Match: "
+		    << " TPC=" << tpc_index << " @ " << _tpc_object_v[res.tpc_id].time
+		    << " with Flash=" << flash_index << " @ " << _flash_v[flash_index].time
+		    << " ... Score=" << res.score
+		    << " ... PE=" << _flash_v[flash_index].TotalPE()
+		    << std::endl;
     }
 
     // We have a score-ordered list of match information at this point.
@@ -420,10 +473,38 @@ namespace flashana {
 
   }
 
+  void FlashMatchManager::ScorePairs(const IDArray_t& tpc_v,
+				     const IDArray_t& flash_v,
+				     std::vector<flashana::FlashMatch_t>& res_v)
+  {
+    res_v.clear();
+    res_v.resize(tpc_v.size());
+    if (tpc_v.empty()) return;
+
+    // Run the first pair on this thread: services behind the hypothesis may load lazily on first use
+    res_v[0] = _alg_flash_match->Match( _tpc_object_v[tpc_v[0]], _flash_v[flash_v[0]] );
+
+    size_t nworkers = std::min(_worker_flash_match_v.size() + 1, tpc_v.size() - 1);
+
+    if (nworkers <= 1) {
+      for (size_t pair_index = 1; pair_index < tpc_v.size(); ++pair_index)
+	res_v[pair_index] = _alg_flash_match->Match( _tpc_object_v[tpc_v[pair_index]], _flash_v[flash_v[pair_index]] );
+      return;
+    }
+
+    // Worker w handles pairs 1+w, 1+w+nworkers, ... with its own algorithm instance
+    ::ubutil::RunWorkers(nworkers, [&](size_t worker) {
+	BaseFlashMatch* alg = (worker ? _worker_flash_match_v[worker-1].get() : _alg_flash_match);
+	for (size_t pair_index = 1 + worker; pair_index < tpc_v.size(); pair_index += nworkers)
+	  res_v[pair_index] = alg->Match( _tpc_object_v[tpc_v[pair_index]], _flash_v[flash_v[pair_index]] );
+      });
+  }
+
   void FlashMatchManager::PrintConfig() {
     
     std::cout << "---- FLASH MATCH MANAGER PRINTING CONFIG     ----" << std::endl
 	      << "_allow_reuse_flash = " << _allow_reuse_flash << std::endl
+	      << "_num_threads = " << _num_threads << std::endl
 	      << "_name = " << _name << std::endl
 	      << "_alg_flash_filter?" << std::endl;
     if (_alg_flash_filter)
@@ -27,6 +27,8 @@
 #include "larcore/Geometry/Geometry.h"
 #include "larcorealg/Geometry/TPCGeo.h"
 
+#include <memory>
+
 namespace flashana {
   /**
      \class FlashMatchManager
@@ -98,16 +100,29 @@ namespace flashana {
     const std::vector<std::vector<flashana::FlashMatch_t> > FullResultFlashTPC() const
     { return _res_flash_tpc_v; }
 
+    /// Number of threads used to score TPC object & flash pairs
+    size_t NumThreads() const { return _num_threads; }
+
   private:
 
     void AddCustomAlgo(BaseAlgorithm* alg);
 
+    /// Score the candidate pairs, res_v[i] is the result for (tpc_v[i], flash_v[i])
+    void ScorePairs(const IDArray_t& tpc_v,
+		    const IDArray_t& flash_v,
+		    std::vector<flashana::FlashMatch_t>& res_v);
+
     BaseFlashFilter*     _alg_flash_filter;     ///< Flash filter algorithm
     BaseTPCFilter*       _alg_tpc_filter;       ///< TPC filter algorithm
     BaseProhibitAlgo*    _alg_match_prohibit;   ///< Flash matchinig prohibit algorithm
     BaseFlashMatch*      _alg_flash_match;      ///< Flash matching algorithm
     BaseFlashHypothesis* _alg_flash_hypothesis; ///< Flash hypothesis algorithm
 
+    /// Per-worker flash matching algorithms (workers 1 ... _num_threads-1, worker 0 uses _alg_flash_match)
+    std::vector<std::unique_ptr<BaseFlashMatch> > _worker_flash_match_v;
+    /// Per-worker flash hypothesis algorithms, attached to _worker_flash_match_v
+    std::vector<std::unique_ptr<BaseFlashHypothesis> > _worker_flash_hypothesis_v;
+
     /**
        A set of custom algorithms (not to be executed but to be configured)
     */
@@ -127,6 +142,8 @@ namespace flashana {
     std::string _name;
     /// Request boolean to store full matching result (per Match function call)
     bool _store_full;
+    /// Number of threads used to score TPC object & flash pairs
+    size_t _num_threads;
     /// Full result container indexed by [tpc][flash]
     std::vector<std::vector<flashana::FlashMatch_t> > _res_tpc_flash_v;
     /// Full result container indexed by [flash][tpc]
@@ -4,6 +4,7 @@
 #include "ChiBoundary.h"
 #include "TGraphErrors.h"
 #include "TF1.h"
+#include "ubreco/Utilities/SlidingWindow.h"
 
 
 namespace michel {
@@ -49,9 +50,9 @@ namespace michel {
     
     std::vector<double> chi;
 
-    auto chi_data = get_windows(cluster._ordered_pts,window_size);
+    ::ubutil::SlidingWindow windows(cluster._ordered_pts.size(),window_size);
     
-    chi.reserve(chi_data.size());
+    chi.reserve(windows.Size());
     std::vector<double> x   (window_size,0.);
     std::vector<double> y   (window_size,0.);
     std::vector<double> xerr(window_size,0.3);
@@ -61,8 +62,8 @@ namespace michel {
 
     TF1 tf("aho","[0] + [1]*x");
   
-    for(const auto& cd : chi_data) {
-      if(cd.size() != window_size){
+    for(size_t w = 0; w < windows.Size(); ++w) {
+      if(windows.End(w) - windows.Begin(w) != window_size){
 	chi.push_back(0.0);
 	continue;
       }
@@ -88,42 +89,6 @@ namespace michel {
 
   }
   
-  //get_windows
-  
-  
-  template<typename T>
-  std::vector<std::vector<T> > ChiBoundary::get_windows(const std::vector<T>& the_thing,
-							const size_t window_size)
-  {
-  
-    std::vector<std::vector<T> > data;
-			  
-    auto w = window_size + 2;
-    w = (unsigned int)((w - 1)/2);
-    auto num = the_thing.size();
-
-    data.reserve(num);
-  
-    for(size_t i = 1; i <= num; ++i) {
-      std::vector<T> inner;
-      inner.reserve(20);
-      if(i < w) {
-	for(size_t j = 0; j < 2 * (i%w) - 1; ++j)
-	  inner.push_back(the_thing[j]);
-      }else if (i > num - w + 1){
-	for(size_t j = num - 2*((num - i)%w)-1 ; j < num; ++j)
-	  inner.push_back(the_thing[j]);
-      }else{
-	for(size_t j = i - w; j < i + w - 1; ++j)
-	  inner.push_back(the_thing[j]);
-      }
-      data.emplace_back(inner);
-    }
-
-    return data;
-  
-  }
-
   //find_max_pos
   std::vector<HitIdx_t> ChiBoundary::find_max_pos(const std::vector<double> chi,
 						  bool forward,
@@ -41,10 +41,6 @@ namespace michel {
     //other functions
     std::vector<double> do_chi(const MichelCluster& cluster, size_t window_size);
     
-    template<typename T>
-    std::vector<std::vector<T> > get_windows(const std::vector<T>& the_thing,
-					     const size_t window_size);
-    
     std::vector<HitIdx_t> find_max_pos(const std::vector<double> chi,
 				       bool forward,
 				       size_t window,
@@ -70,17 +70,23 @@ namespace michel {
       Print(msg::kINFO,this->Name(),ss.str());
     }
     
+    // hits already in the michel or in the muon cluster
+    HitIdSet used;
+    used.Insert(michel);
+    used.Insert(cluster._hits);
+
     // get a list of hits that is less than dMax away from either the start or end point
+    std::vector<size_t> candidate_v;
+    GetHitIndex(hits).Query(std::vector<HitPt>{start, end}, sqrt(dMax), candidate_v);
+
     std::vector<michel::HitPt> nearbyHits;
-    for (auto& h : hits){
+    for (auto const& idx : candidate_v){
 
-      if (h._pl != 2) continue;
+      auto const& h = hits[idx];
 
-      bool there = false;
-      for (auto& mh : michel) { if(mh._id == h._id) { there = true; break;} }
-      for (auto& ch : cluster._hits) { if(ch._id == h._id) { there = true; break;} }
+      if (h._pl != 2) continue;
 
-      if (there) continue;
+      if (used.Contains(h._id)) continue;
 
       if ( (start.SqDist(h) < dMax) or (end.SqDist(h) < dMax) )
 	nearbyHits.push_back(h);
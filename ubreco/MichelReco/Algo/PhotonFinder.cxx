@@ -85,17 +85,24 @@ namespace michel {
     // and pointing in the direction of the Michel
 
     // size_t ctr =0; // unused
+
+    // hits already in the michel or in the muon cluster
+    HitIdSet used;
+    used.Insert(michel);
+    used.Insert(cluster._hits);
+
+    std::vector<size_t> candidate_v;
+    GetHitIndex(hits).Query(start._w, start._t, 100., candidate_v);
     
-    for (auto& h : hits){
+    for (auto const& idx : candidate_v){
+
+      auto const& h = hits[idx];
 
       if (h._pl != 2)
 	continue;
 
       // if hit already in Michel or Muon cluster -> ignore
-      bool there = false;
-      for (auto& mh : michel) { if(mh._id == h._id) { there = true; break;} }
-      for (auto& ch : cluster._hits) { if(ch._id == h._id) { there = true; break;} }
-      if (there)
+      if (used.Contains(h._id))
 	continue;
       
       if (start.SqDist(h) > 100. * 100.)
@@ -117,6 +124,7 @@ namespace michel {
 	continue;
       
       michel.push_back(h);
+      used.Insert(h._id);
       // ctr += 1; // unused
     }
 
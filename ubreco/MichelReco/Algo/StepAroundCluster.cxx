@@ -22,9 +22,10 @@ namespace michel {
     auto michel_end  = michel[michel.size() - 1];
     auto max_step_sq = _max_step * _max_step;
     
-    std::vector<size_t> taken_hits;
-    taken_hits.reserve(hits.size());
+    HitIdSet taken_hits;
 
+    auto const& index = GetHitIndex(hits);
+    std::vector<size_t> candidate_v;
     
     /// Step around on the end point a bit, jumping to the nearest
     /// hit with cutoff < _max_step.
@@ -34,13 +35,16 @@ namespace michel {
       bool   done = true;
       double dist = kINVALID_DOUBLE;
       HitPt  close;
+
+      /// only hits around the end point can be within _max_step
+      index.Query(michel_end._w, michel_end._t, _max_step, candidate_v);
       
-      for (const auto& thishit: hits) {
+      for (auto const& idx : candidate_v) {
+
+	const auto& thishit = hits[idx];
 
-	/// if I already added this hit move on, std::find probably killer slow, oh well
-	if(std::find(taken_hits.begin(),
-		     taken_hits.end(),
-		     thishit._id) != taken_hits.end()) continue;
+	/// if I already added this hit move on
+	if(taken_hits.Contains(thishit._id)) continue;
 	
 	auto curr_dist = michel_end.SqDist(thishit);
 	if ( curr_dist < dist && curr_dist < max_step_sq) {
@@ -52,7 +56,7 @@ namespace michel {
 
       if(!done) {
 	michel    .push_back(close);
-	taken_hits.push_back(close._id);
+	taken_hits.Insert(close._id);
        
 	michel_end  = michel[michel.size() - 1];
       }
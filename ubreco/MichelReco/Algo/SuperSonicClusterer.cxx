@@ -71,17 +71,23 @@ namespace michel {
     }
 
 
+    // hits already in the michel or in the muon cluster
+    HitIdSet used;
+    used.Insert(michel);
+    used.Insert(cluster._hits);
+
     // get a list of hits that is less than dMax away from either the start or end point
+    std::vector<size_t> candidate_v;
+    GetHitIndex(hits).Query(std::vector<HitPt>{start, end}, sqrt(dMax), candidate_v);
+
     std::vector<michel::HitPt> nearbyHits;
-    for (auto& h : hits){
+    for (auto const& idx : candidate_v){
 
-      if (h._pl != 2) continue;
+      auto const& h = hits[idx];
 
-      bool there = false;
-      for (auto& mh : michel) { if(mh._id == h._id) { there = true; break;} }
-      for (auto& ch : cluster._hits) { if(ch._id == h._id) { there = true; break;} }
+      if (h._pl != 2) continue;
 
-      if (there) continue;
+      if (used.Contains(h._id)) continue;
 
       if ( (start.SqDist(h) < dMax) or (end.SqDist(h) < dMax) )
 	nearbyHits.push_back(h);
@@ -101,17 +107,11 @@ namespace michel {
       
       // get a list of hits that is less than dMax away from either the start or end point
       std::vector<michel::HitPt> nearbyHits_cpy;
-      bool there;
       for (auto& h : nearbyHits) {
 	
 	if (h._pl != 2) continue;
 	
-	there = false;
-	
-	for (auto& mh : michel) { if(mh._id == h._id) { there = true; break;} }
-	if(there) continue;
-	for (auto& ch : cluster._hits) { if(ch._id == h._id) { there = true; break;} }
-	if(there) continue;
+	if (used.Contains(h._id)) continue;
 	
 	if ( (start.SqDist(h) < dMax) or (end.SqDist(h) < dMax) )
 	  nearbyHits_cpy.push_back(h);
@@ -156,8 +156,10 @@ namespace michel {
       }
       
       // now that we found potential new hits, append them to the michel object
-      for (auto &h : newHits)
+      for (auto &h : newHits) {
 	michel.push_back(h);
+	used.Insert(h._id);
+      }
       
       
       // recalculte the michel's charge taking into account the new hits
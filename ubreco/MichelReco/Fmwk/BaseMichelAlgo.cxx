@@ -3,4 +3,15 @@
 
 #include "BaseMichelAlgo.h"
 
+namespace michel {
+
+  const HitSpatialIndex& BaseMichelAlgo::GetHitIndex(const std::vector<HitPt>& hits)
+  {
+    if (_hit_index && _hit_index->IsBuiltFor(hits)) return *_hit_index;
+    _local_hit_index.Build(hits);
+    return _local_hit_index;
+  }
+
+}
+
 #endif
@@ -17,6 +17,7 @@
 #include "ubreco/MichelReco/Fmwk/MichelTypes.h"
 #include "ubreco/MichelReco/Fmwk/MichelCluster.h"
 #include "ubreco/MichelReco/Fmwk/ColorPrint.h"
+#include "ubreco/MichelReco/Fmwk/HitSpatialIndex.h"
 namespace michel {
   /**
      \class BaseMichelAlgo
@@ -27,7 +28,7 @@ namespace michel {
     
     /// Default constructor
     BaseMichelAlgo()
-      { _verbosity = msg::kNORMAL; _name = "BaseMichelAlgo"; }
+      { _verbosity = msg::kNORMAL; _name = "BaseMichelAlgo"; _hit_index = nullptr; }
     
     /// Default destructor
     virtual ~BaseMichelAlgo(){}
@@ -53,10 +54,26 @@ namespace michel {
 
     virtual void Report(){}
 
+    /// Setter for the index of the event hits kept by the manager
+    void SetHitIndex(const HitSpatialIndex* index) { _hit_index = index; }
+
   protected:
+
+    /**
+       @brief Spatial index of the hits given to ProcessCluster
+       @details The manager's index if it was built on these hits,
+       otherwise one built here on them.
+     */
+    const HitSpatialIndex& GetHitIndex(const std::vector<HitPt>& hits);
     
     /// Name for algorithm
     std::string _name;
+
+    /// Index of the event hits, owned by the manager
+    const HitSpatialIndex* _hit_index;
+
+    /// Index built when the manager's one does not match the hits
+    HitSpatialIndex _local_hit_index;
     
   };
 }
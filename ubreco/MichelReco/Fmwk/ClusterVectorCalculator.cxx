@@ -3,6 +3,7 @@
 
 #include "ClusterVectorCalculator.h"
 #include "ubreco/MichelReco/Fmwk/MichelException.h"
+#include "ubreco/Utilities/SlidingWindow.h"
 #include <cmath>
 #include <algorithm>
 #include <functional>
@@ -95,101 +96,33 @@ namespace michel {
   {
 
     std::vector<double> truncatedQ;
-    
-    for(auto window : get_windows(dq,_n_window_size) ) {
-      if(window.size() > (size_t)window_cutoff) 
-	cut(window,p_above);
-      truncatedQ.push_back(calc_mean(window));
-    }
-    return truncatedQ;
-  }
-  
-  template<typename S>
-  S ClusterVectorCalculator::calc_mean(const std::vector<S>& data) const
-  {
-    if(!data.size())
-      Print(msg::kEXCEPTION,__FUNCTION__,"You have me nill to calc_mean");
-
-    auto sum = S{0.0};
-    for(const auto& d : data) sum += d;
-    return sum / ( (S) data.size() ); //hopefully this isn't int :)
-  }
-  
-  
-  template<typename W>
-  void ClusterVectorCalculator::cut(std::vector<W>& data, double frac) const
-  {
-    
-    auto size   = data.size();
-    // calcualte number of elements to be kept
-    int to_stay = floor(frac*size);
-  
-    // sort the array based on charge
-    // so that high-charge hits are removed
-    std::sort(data.begin(),data.end(),
-	      [](const W& a, const W& b) -> bool
-	      {
-		return a < b;	      
-	      });
-
-    // erase all elements after the last one to be kept
-    data.erase(data.begin(), data.begin() + to_stay);
-    data.erase(data.end() - to_stay, data.end());
-    //data.erase(data.begin() + to_stay, data.end());
-  }
-  
-  
-
-  
-  template<typename T>
-  std::vector<std::vector<T> > ClusterVectorCalculator::get_windows(const std::vector<T>& the_thing,
-								    const size_t window_size) const
-  {
+    truncatedQ.reserve(dq.size());
+
+    ::ubutil::SlidingWindow windows(dq.size(), (size_t)_n_window_size);
+    ::ubutil::SortedWindow  sorted;
+    auto charge = [](double q) { return q; };
+
+    for(size_t i = 0; i < windows.Size(); ++i) {
+      size_t begin = windows.Begin(i);
+      size_t end   = windows.End(i);
+      size_t size  = end - begin;
+
+      if(size <= (size_t)window_cutoff) {
+	if(!size)
+	  Print(msg::kEXCEPTION,__FUNCTION__,"You have me nill to calc_mean");
+	truncatedQ.push_back(::ubutil::window_mean(dq,begin,end,charge));
+	continue;
+      }
 
-    // given a vector of values return a vector of the same length
-    // with each element being a vector of the values of the local neighbors
-    // of the element at position i in the original vector
-    // input  : [0,1,2,3,4,5,6,...,...,N-3,N-2,N-1] (input vector of size N)
-    // output  (assuming a value of 'w' below == 3):
-    // 0th element: [0]
-    // 1st element: [0,1,2]
-    // 2nd element: [0,1,2,3,4]
-    // jth element: [j-w,j-w+1,..,j+w-2,j+w-1]
-    
-    std::vector<std::vector<T> > data;
-    
-    auto w = window_size + 2;
-    w = (unsigned int)((w - 1)/2);
-    auto num = the_thing.size();
-    
-    data.reserve(num);
-    
-    for(size_t i = 1; i <= num; ++i) {
-      std::vector<T> inner;
-      inner.reserve(20);
-      // if we are at the beginning of the vector (and risk accessing -1 elements)
-      if(i < w)
-	{
-	  for(size_t j = 0; j < 2 * (i%w) - 1; ++j)
-	    inner.push_back(the_thing[j]);
-	}
-      // if we are at the end of the vector (and risk going past it)
-      else if (i > num - w + 1)
-	{
-	  for(size_t j = num - 2*((num - i)%w)-1 ; j < num; ++j)
-	    inner.push_back(the_thing[j]);
-	}
-      // if we are in the middle of the waveform
-      else
-	{
-	  for(size_t j = i - w; j < i + w - 1; ++j)
-	    inner.push_back(the_thing[j]);
-	}
-      data.emplace_back(inner);
+      // drop the same number of lowest and highest charges
+      // and average the rest in increasing order
+      sorted.Update(dq,begin,end,charge);
+      size_t to_stay = (size_t)floor(p_above*size);
+      if(2*to_stay >= size)
+	Print(msg::kEXCEPTION,__FUNCTION__,"You have me nill to calc_mean");
+      truncatedQ.push_back(sorted.Mean(to_stay,size - to_stay));
     }
-
-    return data;
-  
+    return truncatedQ;
   }
   
   size_t ClusterVectorCalculator::find_max(const std::vector<double>& data) const
@@ -230,24 +163,23 @@ namespace michel {
     std::vector<double> S;
     S.reserve(hits.size());
 
-    std::vector<double> X;
-    std::vector<double> Y;
-    X.reserve(_n_window_size);
-    Y.reserve(_n_window_size);
+    auto wire = [](const ::michel::HitPt& h) { return h._w; };
+    auto time = [](const ::michel::HitPt& h) { return h._t; };
 
-    for(const auto& window : get_windows(hits,_n_window_size) ) { 
-      for(const auto& hit : window) {
-	X.push_back(hit._w); Y.push_back(hit._t);
-      }
+    ::ubutil::SlidingWindow windows(hits.size(), _n_window_size);
+
+    for(size_t i = 0; i < windows.Size(); ++i) {
+      if(windows.Begin(i) == windows.End(i))
+	Print(msg::kEXCEPTION,__FUNCTION__,"You have me nill to cov");
+      auto m   = ::ubutil::window_moments(hits,windows.Begin(i),windows.End(i),wire,time);
       
       //http://mathworld.wolfram.com/LeastSquaresFitting.html
-      auto c   = cov(X,Y);
-      auto sX  = stdev(X);
+      auto c   = m.cov;
+      auto sX  = m.stdev_x;
       if(sX == 0.0) {c = 0.0; sX = 1.0;} //might have a problem with floating point error here
       auto b   = c/(sX*sX) ;
       
       S.push_back(b);
-      X.clear(); Y.clear();
     }
     S.at(0)            = S.at(1);
     S.at(S.size() - 1) = S.at(S.size() - 2);
@@ -261,20 +193,19 @@ namespace michel {
     std::vector<double> R;
     R.reserve(hits.size());
 
-    std::vector<double> X;
-    std::vector<double> Y;
-    X.reserve(_n_window_size);
-    Y.reserve(_n_window_size);
+    auto wire = [](const ::michel::HitPt& h) { return h._w; };
+    auto time = [](const ::michel::HitPt& h) { return h._t; };
 
-    for(const auto& window : get_windows(hits,_n_window_size) ) {
-      
-      for(const auto& hit : window) {
-	X.push_back(hit._w); Y.push_back(hit._t);
-      }
+    ::ubutil::SlidingWindow windows(hits.size(), _n_window_size);
+
+    for(size_t i = 0; i < windows.Size(); ++i) {
+      if(windows.Begin(i) == windows.End(i))
+	Print(msg::kEXCEPTION,__FUNCTION__,"You have me nill to cov");
+      auto m  = ::ubutil::window_moments(hits,windows.Begin(i),windows.End(i),wire,time);
       
-      auto c  = cov(X,Y);
-      auto sX = stdev(X);
-      auto sY = stdev(Y);
+      auto c  = m.cov;
+      auto sX = m.stdev_x;
+      auto sY = m.stdev_y;
       auto r  = c/(sX * sY);
 
       if(_verbosity <= msg::kDEBUG) {
@@ -291,8 +222,6 @@ namespace michel {
 
       // if(R.size() != 1 && R.size() != hits.size())
       // 	if(isnan(r)) Print(msg::kEXCEPTION,__FUNCTION__,"Covariance is nan not on edge");
-      
-      X.clear(); Y.clear();
     }    
     //first and last points will be nan. Lets set them equal to the points just above and below
     R.at(0)            = R.at(1);
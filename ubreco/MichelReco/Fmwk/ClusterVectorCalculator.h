@@ -61,17 +61,6 @@ namespace michel {
     double coeff(double k, double N) const;
 
 
-    template<typename S>
-    S calc_mean(const std::vector<S>& data) const;
-    
-    template<typename W>
-    void cut(std::vector<W>& data, double frac) const;
-    
-    template<typename T>
-    std::vector<std::vector<T> > get_windows(const std::vector<T>& the_thing,
-					     const size_t window_size) const;
-
-
 
     std::vector<double> calc_covariance(const std::vector<::michel::HitPt>& hits, 
 					const int _n_window_size) const;
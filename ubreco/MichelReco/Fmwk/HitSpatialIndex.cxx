@@ -0,0 +1,156 @@
+#ifndef MICHELCLUSTER_HITSPATIALINDEX_CXX
+#define MICHELCLUSTER_HITSPATIALINDEX_CXX
+
+#include "HitSpatialIndex.h"
+#include <cmath>
+#include <algorithm>
+
+namespace michel {
+
+  /// hits further than this from the origin [cm] are not binned
+  static const double kMaxHitCoordinate = 1.e7;
+  /// cap on the number of grid cells
+  static const double kMaxCells = 1 << 20;
+  /// largest ID kept in the bits of HitIdSet
+  static const HitID_t kMaxBitsID = 1 << 24;
+
+  HitSpatialIndex::HitSpatialIndex(double cellsize)
+    : _default_cell_size(cellsize)
+    , _cell_size(cellsize)
+  {
+    Clear();
+  }
+
+  void HitSpatialIndex::Clear()
+  {
+    _hits  = nullptr;
+    _nhits = 0;
+    _w_min = _t_min = 0;
+    _nw = _nt = 0;
+    _cell_start_v.assign(1,0);
+    _cell_v.clear();
+    _outlier_v.clear();
+  }
+
+  void HitSpatialIndex::Build(const std::vector<HitPt>& hits)
+  {
+    Clear();
+    _hits  = hits.data();
+    _nhits = hits.size();
+
+    auto binned = [](const HitPt& h) {
+      return ( std::fabs(h._w) < kMaxHitCoordinate && std::fabs(h._t) < kMaxHitCoordinate );
+    };
+
+    double w_max = 0, t_max = 0;
+    bool first = true;
+    for (size_t i = 0; i < hits.size(); i++) {
+      auto const& h = hits[i];
+      if (!binned(h)) { _outlier_v.push_back(i); continue; }
+      if (first) {
+	_w_min = w_max = h._w;
+	_t_min = t_max = h._t;
+	first = false;
+      }
+      _w_min = std::min(_w_min, h._w);
+      _t_min = std::min(_t_min, h._t);
+      w_max  = std::max(w_max, h._w);
+      t_max  = std::max(t_max, h._t);
+    }
+    if (first) return;
+
+    // grow the cells for events spread over a very large area
+    _cell_size = _default_cell_size;
+    while ( ((w_max - _w_min) / _cell_size + 1) * ((t_max - _t_min) / _cell_size + 1) > kMaxCells )
+      _cell_size *= 2;
+    _nw = CellW(w_max) + 1;
+    _nt = CellT(t_max) + 1;
+
+    // counting sort of the hits into cells, keeping their order
+    _cell_start_v.assign(_nw * _nt + 1, 0);
+    for (size_t i = 0; i < hits.size(); i++)
+      if (binned(hits[i])) _cell_start_v[CellW(hits[i]._w) * _nt + CellT(hits[i]._t) + 1] += 1;
+    for (size_t c = 1; c < _cell_start_v.size(); c++)
+      _cell_start_v[c] += _cell_start_v[c-1];
+    std::vector<size_t> fill_v(_cell_start_v.begin(), _cell_start_v.end() - 1);
+    _cell_v.resize(_cell_start_v.back());
+    for (size_t i = 0; i < hits.size(); i++)
+      if (binned(hits[i])) _cell_v[ fill_v[CellW(hits[i]._w) * _nt + CellT(hits[i]._t)]++ ] = i;
+  }
+
+  int HitSpatialIndex::CellW(double w) const
+  { return (int)std::floor(std::max(std::min((w - _w_min) / _cell_size, 1e9), -1e9)); }
+
+  int HitSpatialIndex::CellT(double t) const
+  { return (int)std::floor(std::max(std::min((t - _t_min) / _cell_size, 1e9), -1e9)); }
+
+  void HitSpatialIndex::Collect(double w, double t, double r, std::vector<size_t>& idx_v) const
+  {
+    // a query we cannot bin returns every hit
+    if ( !std::isfinite(w) || !std::isfinite(t) || !std::isfinite(r) ) {
+      for (size_t i = 0; i < _nhits; i++) idx_v.push_back(i);
+      return;
+    }
+
+    idx_v.insert(idx_v.end(), _outlier_v.begin(), _outlier_v.end());
+    if (!_nw || !_nt) return;
+
+    // slack against rounding in the caller's distance
+    r = std::fabs(r) * (1 + 1e-9) + 1e-6;
+    int imin = std::max(CellW(w - r), 0);
+    int imax = std::min(CellW(w + r), _nw - 1);
+    int jmin = std::max(CellT(t - r), 0);
+    int jmax = std::min(CellT(t + r), _nt - 1);
+    if ( (imin > imax) || (jmin > jmax) ) return;
+
+    // cells of a row are contiguous in _cell_v
+    for (int i = imin; i <= imax; i++) {
+      size_t first = _cell_start_v[i * _nt + jmin];
+      size_t last  = _cell_start_v[i * _nt + jmax + 1];
+      idx_v.insert(idx_v.end(), _cell_v.begin() + first, _cell_v.begin() + last);
+    }
+  }
+
+  void HitSpatialIndex::Query(double w, double t, double r, std::vector<size_t>& idx_v) const
+  {
+    idx_v.clear();
+    Collect(w, t, r, idx_v);
+    std::sort(idx_v.begin(), idx_v.end());
+  }
+
+  void HitSpatialIndex::Query(const std::vector<HitPt>& pts, double r, std::vector<size_t>& idx_v) const
+  {
+    idx_v.clear();
+    for (auto const& pt : pts) Collect(pt._w, pt._t, r, idx_v);
+    std::sort(idx_v.begin(), idx_v.end());
+    idx_v.erase(std::unique(idx_v.begin(), idx_v.end()), idx_v.end());
+  }
+
+  void HitIdSet::Clear()
+  {
+    for (auto const& id : _set_v) _bits[id] = false;
+    _set_v.clear();
+    _large_v.clear();
+  }
+
+  void HitIdSet::Insert(HitID_t id)
+  {
+    if (id >= kMaxBitsID) {
+      if (!Contains(id)) _large_v.push_back(id);
+      return;
+    }
+    if (id >= _bits.size()) _bits.resize(id + 1, false);
+    if (_bits[id]) return;
+    _bits[id] = true;
+    _set_v.push_back(id);
+  }
+
+  bool HitIdSet::Contains(HitID_t id) const
+  {
+    if (id < _bits.size()) return _bits[id];
+    if (id < kMaxBitsID) return false;
+    return ( std::find(_large_v.begin(), _large_v.end(), id) != _large_v.end() );
+  }
+
+}
+#endif
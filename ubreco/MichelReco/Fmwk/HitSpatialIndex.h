@@ -0,0 +1,109 @@
+/**
+ * \file HitSpatialIndex.h
+ *
+ * \ingroup MichelCluster
+ * 
+ * \brief Class def header for the classes HitSpatialIndex and HitIdSet
+ *
+ */
+
+/** \addtogroup MichelCluster
+
+    @{*/
+#ifndef MICHELCLUSTER_HITSPATIALINDEX_H
+#define MICHELCLUSTER_HITSPATIALINDEX_H
+
+#include <vector>
+#include "ubreco/MichelReco/Fmwk/HitPt.h"
+
+namespace michel {
+  /**
+     \class HitSpatialIndex
+     Hits of an event binned in a uniform (wire, time) grid, to look for
+     the hits around a point without scanning the whole event.
+     Queries return candidate indices in increasing order: all hits in
+     the cells overlapping the search square, plus the hits that could
+     not be binned (non-finite or far out coordinates). The caller
+     applies its own distance cut, so results and their order are those
+     of a loop over all hits.
+  */
+  class HitSpatialIndex {
+    
+  public:
+    
+    /// Default constructor
+    HitSpatialIndex(double cellsize = 5.);
+    
+    /// Default destructor
+    ~HitSpatialIndex(){}
+
+    /// bin the hits (the vector must outlive the queries)
+    void Build(const std::vector<HitPt>& hits);
+
+    /// forget the hits
+    void Clear();
+
+    /// was the index built on this very hit vector
+    bool IsBuiltFor(const std::vector<HitPt>& hits) const
+    { return (hits.data() == _hits) && (hits.size() == _nhits); }
+
+    /// candidate indices of hits within r of (w,t)
+    void Query(double w, double t, double r, std::vector<size_t>& idx_v) const;
+
+    /// candidate indices of hits within r of any of the points
+    void Query(const std::vector<HitPt>& pts, double r, std::vector<size_t>& idx_v) const;
+
+  private:
+
+    /// append the candidates around one point, not sorted
+    void Collect(double w, double t, double r, std::vector<size_t>& idx_v) const;
+
+    int CellW(double w) const;
+    int CellT(double t) const;
+
+    double _default_cell_size;
+    double _cell_size;
+    const HitPt* _hits;
+    size_t _nhits;
+    double _w_min, _t_min;
+    int _nw, _nt;
+    std::vector<size_t> _cell_start_v; ///< first entry of each cell in _cell_v
+    std::vector<size_t> _cell_v;       ///< hit indices, cell by cell
+    std::vector<size_t> _outlier_v;    ///< hits not in the grid
+  };
+
+  /**
+     \class HitIdSet
+     Set of hit IDs backed by a bit per ID, for membership tests
+     in constant time. Clear only resets the bits that were set.
+  */
+  class HitIdSet {
+
+  public:
+
+    /// Default constructor
+    HitIdSet(){}
+
+    /// Default destructor
+    ~HitIdSet(){}
+
+    void Clear();
+
+    void Insert(HitID_t id);
+
+    /// insert the IDs of a list of hits
+    void Insert(const std::vector<HitPt>& hits)
+    { for (auto const& h : hits) Insert(h._id); }
+
+    bool Contains(HitID_t id) const;
+
+  private:
+
+    std::vector<bool>    _bits;
+    std::vector<HitID_t> _set_v;   ///< IDs with their bit set
+    std::vector<HitID_t> _large_v; ///< IDs too large for the bits
+  };
+}
+
+#endif
+/** @} */ // end of doxygen group 
@@ -5,6 +5,8 @@
 #include "MichelException.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <memory>
 
 namespace michel {
 
@@ -16,6 +18,7 @@ namespace michel {
     , _alg_merge          ( nullptr )
     , _alg_filter         ( nullptr )
     , _alg_v              ( )
+    , _profile_tree       ( nullptr )
   {
     _event_time = 0;
     _event_ctr  = 0;
@@ -55,6 +58,7 @@ namespace michel {
       throw MichelException();
     }
     _all_hit_v = all_hit_v;
+    _hit_index.Build(_all_hit_v);
   }
   
   //-----------------------------------------------------------------
@@ -67,6 +71,7 @@ namespace michel {
       throw MichelException();
     }
     std::swap(_all_hit_v, all_hit_v);
+    _hit_index.Build(_all_hit_v);
   }
   
   //-----------------------------------------------------------------
@@ -89,9 +94,11 @@ namespace michel {
   void MichelRecoManager::AddAlgo(BaseMichelAlgo* algo)
   //-----------------------------------------------------------------
   {
+    algo->SetHitIndex(&_hit_index);
     _alg_v.push_back(algo);
     _alg_time_v.push_back(0.);
     _alg_ctr_v.push_back(0);
+    _alg_drop_v.push_back(0);
   }
   
   //-----------------------------------------------------------------
@@ -181,20 +188,25 @@ namespace michel {
 	     << " on MichelCluster ID: " << cluster._id;
 	  Print(msg::kINFO, __FUNCTION__, ss.str());
 	}
+	// copy the cluster to report what the algorithm changed only when debugging
+	std::unique_ptr<MichelCluster> before;
+	if (_verbosity <= msg::kDEBUG) before.reset(new MichelCluster(cluster));
 	_watch.Start();
-	MichelCluster before(cluster);
 	keep = _alg_v[n]->ProcessCluster(cluster, _all_hit_v);
-	auto const diff_msg = before.Diff(cluster);
-	if ( !diff_msg.empty() && ( _verbosity <= msg::kDEBUG ) ) {
-	  std::stringstream ss;
-	  ss << "\033[93m Detected a change in MichelCluster (ID=" << cluster._id << ")!\033[00m"
-	     << " by algorithm "
-	     << "\033[95m " << _alg_v[n]->Name() << " (" << n << ") \033[00m" << std::endl
-	     << diff_msg;
-	  Print(msg::kDEBUG, __FUNCTION__, ss.str());
-	}
 	_alg_time_v[n] += _watch.RealTime();
 	_alg_ctr_v[n] += 1;
+	if (!keep) _alg_drop_v[n] += 1;
+	if (before) {
+	  auto const diff_msg = before->Diff(cluster);
+	  if ( !diff_msg.empty() ) {
+	    std::stringstream ss;
+	    ss << "\033[93m Detected a change in MichelCluster (ID=" << cluster._id << ")!\033[00m"
+	       << " by algorithm "
+	       << "\033[95m " << _alg_v[n]->Name() << " (" << n << ") \033[00m" << std::endl
+	       << diff_msg;
+	    Print(msg::kDEBUG, __FUNCTION__, ss.str());
+	  }
+	}
 	if (!keep && _verbosity <= msg::kINFO) {
 	  std::stringstream ss;
 	  ss << "dropping MichelCluster due to algorithm: "
@@ -247,6 +259,23 @@ namespace michel {
     _output_v.clear();
   }
   
+  //-----------------------------------------------------------------
+  std::vector<MichelRecoManager::AlgoProfile> MichelRecoManager::GetAlgoProfile() const
+  //-----------------------------------------------------------------
+  {
+    std::vector<AlgoProfile> profile_v;
+    profile_v.reserve(_alg_v.size());
+    for (size_t n = 0; n < _alg_v.size(); n++) {
+      AlgoProfile profile;
+      profile.name    = _alg_v[n]->Name();
+      profile.time    = _alg_time_v[n];
+      profile.calls   = _alg_ctr_v[n];
+      profile.dropped = _alg_drop_v[n];
+      profile_v.push_back(profile);
+    }
+    return profile_v;
+  }
+
   //-----------------------------------------------------------------
   void MichelRecoManager::Finalize()//TFile *fout)
   //-----------------------------------------------------------------
@@ -268,7 +297,8 @@ namespace michel {
       double alg_time = _alg_time_v[n] / ((double)_alg_ctr_v[n]);
       std::cout <<  std::setw(25) << _alg_v[n]->Name() << "\t Algo Time: " 
 		<< std::setw(10) << alg_time * 1.e6  << " [us/cluster]"
-		<< "\t Clusters Scanned: " << _alg_ctr_v[n] << std::endl;
+		<< "\t Clusters Scanned: " << _alg_ctr_v[n]
+		<< "\t Dropped: " << _alg_drop_v[n] << std::endl;
       if (_alg_v[n]->Name() == "CalcTruncated")
 	_alg_v[n]->EventReset();
       _alg_v[n]->Report();
@@ -279,6 +309,63 @@ namespace michel {
 	      << std::setw(12) << event_time * 1.e6  << " [us/event]"
 	      << "\t Events Scanned: " << _event_ctr << std::endl;
     std::cout << "===============================================================================================" << std::endl;
+
+    // algorithms sorted by the total time they took
+    auto profile_v = GetAlgoProfile();
+    double total_time = 0;
+    for (auto const& profile : profile_v) total_time += profile.time;
+
+    std::vector<size_t> order_v(profile_v.size());
+    for (size_t n = 0; n < order_v.size(); n++) order_v[n] = n;
+    std::stable_sort(order_v.begin(), order_v.end(),
+		     [&profile_v](size_t a, size_t b) { return profile_v[a].time > profile_v[b].time; });
+
+    std::cout << std::endl
+	      << "================================ Algorithm Profile (by total time) ============================" << std::endl
+	      << std::setw(25) << "Algorithm"
+	      << std::setw(12) << "Total [s]"
+	      << std::setw(12) << "Share [%]"
+	      << std::setw(14) << "[us/cluster]"
+	      << std::setw(10) << "Clusters"
+	      << std::setw(10) << "Dropped"
+	      << std::setw(12) << "Drop [%]" << std::endl;
+    for (auto const& n : order_v) {
+      auto const& profile = profile_v[n];
+      double per_call  = profile.calls ? profile.time / profile.calls : 0.;
+      double drop_rate = profile.calls ? profile.dropped / (double)profile.calls : 0.;
+      double share     = total_time > 0 ? profile.time / total_time : 0.;
+      std::cout << std::setw(25) << profile.name
+		<< std::setw(12) << profile.time
+		<< std::setw(12) << share * 100.
+		<< std::setw(14) << per_call * 1.e6
+		<< std::setw(10) << profile.calls
+		<< std::setw(10) << profile.dropped
+		<< std::setw(12) << drop_rate * 100. << std::endl;
+    }
+    std::cout << "===============================================================================================" << std::endl;
+
+    if (_profile_tree) {
+      std::string name;
+      Int_t       index;
+      Double_t    time, time_per_cluster;
+      Long64_t    calls, dropped;
+      _profile_tree->Branch("name",    &name);
+      _profile_tree->Branch("index",   &index,   "index/I");
+      _profile_tree->Branch("time",    &time,    "time/D");
+      _profile_tree->Branch("time_per_cluster", &time_per_cluster, "time_per_cluster/D");
+      _profile_tree->Branch("calls",   &calls,   "calls/L");
+      _profile_tree->Branch("dropped", &dropped, "dropped/L");
+      for (size_t n = 0; n < profile_v.size(); n++) {
+	name    = profile_v[n].name;
+	index   = n;
+	time    = profile_v[n].time;
+	calls   = profile_v[n].calls;
+	dropped = profile_v[n].dropped;
+	time_per_cluster = calls ? time / calls : 0.;
+	_profile_tree->Fill();
+      }
+      _profile_tree->ResetBranchAddresses();
+    }
     
   }
 }
@@ -21,7 +21,9 @@
 #include "ubreco/MichelReco/Fmwk/BaseMichelAlgo.h"
 #include "ubreco/MichelReco/Fmwk/MichelAnaBase.h"
 #include "ubreco/MichelReco/Fmwk/ColorPrint.h"
+#include "ubreco/MichelReco/Fmwk/HitSpatialIndex.h"
 #include <TFile.h>
+#include <TTree.h>
 #include <TStopwatch.h>
 #include <math.h>
 
@@ -47,6 +49,14 @@ class MichelRecoManager : public ColorPrint {
 
 public:
 
+    /// Time profile of one reco algorithm, accumulated over the job
+    struct AlgoProfile {
+      std::string name;   ///< algorithm name
+      double time = 0;    ///< total wall time in ProcessCluster [s]
+      size_t calls = 0;   ///< number of clusters processed
+      size_t dropped = 0; ///< number of clusters the algorithm rejected
+    };
+
     /// Default constructor
     MichelRecoManager();
 
@@ -109,6 +119,12 @@ public:
     /// Setter for setting minimum number of hits to create MichelCluster
     void SetMinNHits(int n)       { _min_nhits = n; }
 
+    /// Setter for a tree filled at Finalize with one entry per reco algorithm (not owned)
+    void SetProfileTree(TTree* tree) { _profile_tree = tree; }
+
+    /// Getter for the time profile of the reco algorithms, in execution order
+    std::vector<AlgoProfile> GetAlgoProfile() const;
+
     /// Getter for input MichelClusterArray
     MichelClusterArray GetMergedClusters()
     { return _merged_v; }
@@ -146,6 +162,8 @@ protected:
     MichelClusterArray _output_v;
     /// "ALL" hit list
     std::vector< ::michel::HitPt > _all_hit_v;
+    /// Spatial index of the "ALL" hit list, shared with the algorithms
+    HitSpatialIndex _hit_index;
     /// Used hit marker for "ALL" hit list
     std::vector< bool > _used_hit_marker_v;
     //
@@ -166,11 +184,13 @@ protected:
     TStopwatch _watch; ///< For profiling
     std::vector<double> _alg_time_v; ///< Overall time for processing
     std::vector<size_t> _alg_ctr_v;  ///< Overall number of clusters processed by algo
+    std::vector<size_t> _alg_drop_v; ///< Overall number of clusters rejected by algo
     double _merge_time; ///< Overall time for processing cluster merging
     size_t _merge_ctr;  ///< number of clusters processed by merging
     TStopwatch _event_watch;
     double _event_time; ///< overall time for the entire event processing
     size_t _event_ctr;  ///< number of events scanned
+    TTree* _profile_tree; ///< optional output of the algorithm profile
 
     /// Event information
     EventID _id;
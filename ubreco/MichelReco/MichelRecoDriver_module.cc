@@ -16,6 +16,7 @@
 #include "canvas/Utilities/InputTag.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
+#include "art_root_io/TFileService.h"
 
 // services etc...
 #include "larcore/Geometry/WireReadout.h"
@@ -95,6 +96,7 @@ MichelRecoDriver::MichelRecoDriver(fhicl::ParameterSet const & p)
   fClusterProducer  = p.get<std::string>("ClusterProducer");
   fHitProducer      = p.get<std::string>("HitProducer");
   fMinClusSize      = p.get<size_t>     ("MinClusSize");
+  bool profileTree  = p.get<bool>       ("ProfileTree", false);
   
   // get detector specific properties
   auto const& channelMap = art::ServiceHandle<geo::WireReadout>()->Get();
@@ -110,6 +112,12 @@ MichelRecoDriver::MichelRecoDriver(fhicl::ParameterSet const & p)
 
   _mgr = new michel::AlgoDefault();
 
+  // per-algorithm time profile written at the end of the job
+  if (profileTree) {
+    art::ServiceHandle<art::TFileService> tfs;
+    _mgr->SetProfileTree( tfs->make<TTree>("michel_profile","Michel reco algorithm profile") );
+  }
+
 }
 
 void MichelRecoDriver::endJob()
@@ -41,6 +41,8 @@
 
 #include "art_root_io/TFileService.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 class OpNoiseCreateMask;
@@ -76,6 +78,28 @@ private:
   bool fApplyOpNoiseMask;
   std::string fHitProducer;
 
+  /// hits of one plane sorted by wire and by time, for box queries around a PMT hit
+  class PlaneHitIndex {
+  public:
+    void Fill(const std::vector<recob::Hit>& hits, unsigned int plane);
+
+    /// Calls f(hit index) for the hits with wirelow < wire-hit_w < wirehigh and
+    /// timelow < time-hit_time < timehigh (hit_time = PeakTime/2-400, in PMT time),
+    /// until f returns true. Returns true if f did.
+    template <typename F>
+    bool Query(double wire, double wirelow, double wirehigh,
+	       double time, double timelow, double timehigh, F f) const;
+
+  private:
+    struct Entry {
+      unsigned int wire;
+      float time;
+      size_t hit;
+    };
+    std::vector<Entry> fEntries;
+    std::vector<size_t> fWireStart; // first entry of each wire, one more element than wires
+  };
+
 };
 
 
@@ -127,9 +151,6 @@ void OpNoiseCreateMask::produce(art::Event& e)
   std::vector< std::vector<double> > ophit_wire;
   std::vector<double> frac_flag_to_noise_vec;
   
-  bool ispl1_flag=false;
-  bool ispl1_noise=false;
-
   int n_flag_pl1=0;
   int n_noise_pl1=0;
 
@@ -163,70 +184,41 @@ void OpNoiseCreateMask::produce(art::Event& e)
   }//finish ophit loop
 
 
+  //bucket plane 1 hits once: the boxes below only look at plane 1
+  const unsigned int mask_plane=1;
+  PlaneHitIndex hit_index;
+  if(pe.size()!=0) hit_index.Fill(*inputHits, mask_plane);
+
   //only look at TPC if there are high pe pmt pulses
   if(pe.size()!=0){
     
     //loop over high p.e. PMT hits
     for(unsigned int i=0; i<pe.size(); i++){
-      //loop over TPC hits
-      for ( unsigned int ih=0; ih<inputHits->size(); ih++) {
-	const auto& tpchit = inputHits->at(ih);     
-	auto hit_w=tpchit.WireID().Wire;
-	auto hit_pl=tpchit.WireID().Plane;
-	
-	//convert hit time to coordinates of TPC time, relative  to trigger
-	float hit_time_pmtcoord  = (tpchit.PeakTime()/2)-400;
-	
-	//only try to mask hits on plane 1
-	if(hit_pl==1){
-	  
-	  //cut on position in flag region
-	  if(ophit_wire[i][hit_pl]-hit_w>fFlagWireLow && ophit_wire[i][hit_pl]-hit_w<fFlagWireHigh && ispl1_flag==false){
-	    //cut on time
-	    if(peaktime[i]-hit_time_pmtcoord>fFlagTimeLow && peaktime[i]-hit_time_pmtcoord<fFlagTimeHigh){
-	      n_flag_pl1=n_flag_pl1+1;//count number of hits in flag region
-	      ispl1_flag=true;
-	    }
-	  }
-	  //cut on noise box
-	  if(ophit_wire[i][hit_pl]-hit_w>fFlagWireLow && ophit_wire[i][hit_pl]-hit_w<fFlagWireHigh && ispl1_noise==false){
-	    //cut on time                                                                                            
-	    if(peaktime[i]-hit_time_pmtcoord>fNoiseTimeLow && peaktime[i]-hit_time_pmtcoord<fNoiseTimeHigh){
-	      n_noise_pl1=n_noise_pl1+1;//count number of hits in flag region   
-	      ispl1_noise=true;
-	    }
-	  }
-	  
-	}//plane 1 only
-      }//tpc hits
+      //at most one count per PMT hit: stop at the first TPC hit in the box
+      auto first_hit = [](size_t){ return true; };
+
+      //cut on position and time in flag region
+      if(hit_index.Query(ophit_wire[i][mask_plane], fFlagWireLow, fFlagWireHigh,
+			 peaktime[i], fFlagTimeLow, fFlagTimeHigh, first_hit)){
+	n_flag_pl1=n_flag_pl1+1;//count number of hits in flag region
+      }
+      //cut on noise box (noise time window in the flag wire window)
+      if(hit_index.Query(ophit_wire[i][mask_plane], fFlagWireLow, fFlagWireHigh,
+			 peaktime[i], fNoiseTimeLow, fNoiseTimeHigh, first_hit)){
+	n_noise_pl1=n_noise_pl1+1;//count number of hits in flag region
+      }
       double frac_flag_to_noise=(double) n_flag_pl1/n_noise_pl1;
       frac_flag_to_noise_vec.push_back(frac_flag_to_noise);
-      ispl1_flag=false; 
-      ispl1_noise=false;
     }//pmt loop
   }//pe.size>0
 
   //loop over high p.e. PMT hits to mask noise
   for(unsigned int i=0; i<pe.size(); i++){
     if(frac_flag_to_noise_vec[i]>fFlagFrac){//require at least 2% in the flag box
-      //loop over TPC hits                                                                                                                
-      for ( unsigned int ih=0; ih<inputHits->size(); ih++) {
-	const auto& tpchit = inputHits->at(ih);
-	auto hit_w=tpchit.WireID().Wire;
-	auto hit_pl=tpchit.WireID().Plane;
-	//convert hit time to coordinates of TPC time, relative  to trigger                                                          
-	float hit_time_pmtcoord  = (tpchit.PeakTime()/2)-400;
-	//only try to mask hits on plane 1                                                                                         
-	if(hit_pl==1){
-	  //cut on noise box                                                                            
-	  if(ophit_wire[i][hit_pl]-hit_w>fNoiseWireLow && ophit_wire[i][hit_pl]-hit_w<fNoiseWireHigh && ispl1_noise==false){
-	    //cut on time                                                                                                              
-	    if(peaktime[i]-hit_time_pmtcoord>fNoiseTimeLow && peaktime[i]-hit_time_pmtcoord<fNoiseTimeHigh){
-	      hit_mask[ih]=false;
-	    }
-	  }
-	}//plane 1 only                                                                                                               
-      }//tpc hits                                                          
+      //mask all plane 1 TPC hits in the noise box
+      hit_index.Query(ophit_wire[i][mask_plane], fNoiseWireLow, fNoiseWireHigh,
+		      peaktime[i], fNoiseTimeLow, fNoiseTimeHigh,
+		      [&hit_mask](size_t ih){ hit_mask[ih]=false; return false; });
     }//flag box
   }//PMT loop      
 
@@ -252,4 +244,57 @@ void OpNoiseCreateMask::produce(art::Event& e)
 
 }
 
+void OpNoiseCreateMask::PlaneHitIndex::Fill(const std::vector<recob::Hit>& hits, unsigned int plane)
+{
+  fEntries.clear();
+  for(size_t ih=0; ih<hits.size(); ih++){
+    const auto& tpchit = hits[ih];
+    if(tpchit.WireID().Plane!=plane) continue;
+    //convert hit time to coordinates of TPC time, relative  to trigger
+    float hit_time_pmtcoord = (tpchit.PeakTime()/2)-400;
+    //a NaN time never passes the time cuts
+    if(std::isnan(hit_time_pmtcoord)) continue;
+    fEntries.push_back({tpchit.WireID().Wire, hit_time_pmtcoord, ih});
+  }
+  std::sort(fEntries.begin(), fEntries.end(), [](const Entry& a, const Entry& b){
+      return (a.wire<b.wire) || (a.wire==b.wire && a.time<b.time); });
+
+  unsigned int nwires = fEntries.empty() ? 0 : fEntries.back().wire+1;
+  fWireStart.assign(nwires+1, 0);
+  for(auto const& entry : fEntries) fWireStart[entry.wire+1]++;
+  for(size_t w=0; w<nwires; w++) fWireStart[w+1]+=fWireStart[w];
+}
+
+template <typename F>
+bool OpNoiseCreateMask::PlaneHitIndex::Query(double wire, double wirelow, double wirehigh,
+					     double time, double timelow, double timehigh, F f) const
+{
+  if(fEntries.empty() || std::isnan(wire) || std::isnan(time)) return false;
+  const long nwires = fWireStart.size()-1;
+
+  //candidate ranges with one wire and a small time margin on each side,
+  //the cuts themselves are applied below exactly as written
+  const double margin = 1.e-3;
+  double wmin = std::max(std::ceil(wire-wirehigh)-1, 0.);
+  double wmax = std::min(std::floor(wire-wirelow)+1, (double)(nwires-1));
+  double tmin = time-timehigh-margin;
+  double tmax = time-timelow+margin;
+  if(wmin>wmax) return false;
+
+  for(long w=(long)wmin; w<=(long)wmax; w++){
+    auto begin = fEntries.begin()+fWireStart[w];
+    auto end = fEntries.begin()+fWireStart[w+1];
+    auto it = std::lower_bound(begin, end, tmin, [](const Entry& e, double t){ return e.time<t; });
+    for(; it!=end && !(it->time>tmax); ++it){
+      unsigned int hit_w = it->wire;
+      float hit_time_pmtcoord = it->time;
+      if(wire-hit_w>wirelow && wire-hit_w<wirehigh &&
+	 time-hit_time_pmtcoord>timelow && time-hit_time_pmtcoord<timehigh){
+	if(f(it->hit)) return true;
+      }
+    }
+  }
+  return false;
+}
+
 DEFINE_ART_MODULE(OpNoiseCreateMask)
@@ -46,11 +46,17 @@ namespace cosmictag {
     _dqds_slider.clear();
     _dqds_slider.reserve(_dqds_v.size());
 
-    std::vector<double> dqds_vector = _dqds_v;
+    // median of each window without its largest and smallest values
+    // (all of them if the window has two values or fewer)
+    ::ubutil::SlidingWindow windows(_dqds_v.size(), _slider_window);
+    ::ubutil::SortedWindow sorted;
+    auto value = [](double d) { return d; };
 
-    for(const auto& window : get_windows(dqds_vector, _slider_window)) {
+    for(size_t i = 0; i < windows.Size(); i++) {
 
-      double median_dqds = get_smooth_trunc_median(window);
+      sorted.Update(_dqds_v, windows.Begin(i), windows.End(i), value);
+      size_t n = sorted.size();
+      double median_dqds = (n > 2) ? sorted.Median(1, n - 1) : sorted.Median(0, n);
       _dqds_slider.push_back(median_dqds);
       //if (_debug) std::cout << "dqds_slider value " << median_dqds << std::endl;
 
@@ -43,17 +43,14 @@ namespace cosmictag {
     std::vector<double> mean_v;
     mean_v.clear();
 
-    std::vector<double> wire_v;
+    mean_v.reserve(_s_hit_v.size());
 
-    for(const auto& window : get_windows(_s_hit_v, _slider_window)) {
+    auto wire = [](const SimpleHit& h) { return (double)h.wire; };
 
-      for (auto s_h : window) {
-        wire_v.push_back(s_h.wire);
-      }
-
-      mean_v.push_back(mean(wire_v));
+    ::ubutil::SlidingWindow windows(_s_hit_v.size(), _slider_window);
 
-      wire_v.clear();
+    for(size_t i = 0; i < windows.Size(); i++) {
+      mean_v.push_back(::ubutil::window_mean(_s_hit_v, windows.Begin(i), windows.End(i), wire));
     }
 
     new_vector.push_back(_s_hit_v.at(0));
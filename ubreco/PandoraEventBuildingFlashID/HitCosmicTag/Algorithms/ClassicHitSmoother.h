@@ -20,6 +20,7 @@
 #include "../Base/HitSmootherFactory.h"
 #include "../Base/HitCosmicTagException.h"
 #include "../Base/Tools.h"
+#include "ubreco/Utilities/SlidingWindow.h"
 
 #include <TVector3.h>
 
@@ -35,21 +35,18 @@ namespace cosmictag {
     std::vector<double> R;
     R.reserve(_s_hit_v.size());
 
-    std::vector<double> X;
-    std::vector<double> Y;
-    X.reserve(_slider_window);
-    Y.reserve(_slider_window);
+    auto wire = [](const SimpleHit& h) { return (double)h.wire; };
+    auto time = [](const SimpleHit& h) { return h.time; };
 
-    for(const auto& window : get_windows(_s_hit_v, _slider_window)) {
+    ::ubutil::SlidingWindow windows(_s_hit_v.size(), _slider_window);
 
-      for(const auto& s_hit : window) {
-        X.push_back(s_hit.wire); 
-        Y.push_back(s_hit.time);
-      }
+    for(size_t i = 0; i < windows.Size(); i++) {
 
-      auto c  = cov(X,Y);
-      auto sX = stdev(X);
-      auto sY = stdev(Y);
+      auto m  = ::ubutil::window_moments(_s_hit_v, windows.Begin(i), windows.End(i), wire, time);
+
+      auto c  = m.cov;
+      auto sX = m.stdev_x;
+      auto sY = m.stdev_y;
       auto r  = std::abs(c/(sX * sY));
 
       //if(_debug) {
@@ -62,8 +59,6 @@ namespace cosmictag {
 
       if(std::isnan(r)) r = 0.0; 
       R.push_back(r);
-      
-      X.clear(); Y.clear();
     }   
  
     //first and last points will be nan. Lets set them equal to the points just above and below
@@ -37,7 +37,7 @@ namespace clusmtool {
     /**
        Is a hit matched on the other plane?
      */
-    int Isochronous(const float& time, const std::vector<cluster::pt>& otherhits);
+    int Isochronous(const float& time, const cluster::ptspan<float>& othertimes);
 
     float _timetolerance; // in cm, max disagreement in hit peak-time
     float _minoverlap; 
@@ -114,16 +114,16 @@ namespace clusmtool {
 
     // if the clusters overlap to some degree, check compatibility on hit-by-hit level
     double compatibility = 0.;
-    auto const& hitsCollection = clusters[collectionPlane]->GetHits();
-    auto const& hitsInduction  = clusters[inductionPlane ]->GetHits();
+    auto const timesCollection = clusters[collectionPlane]->Time();
+    auto const timesInduction  = clusters[inductionPlane ]->Time();
 
-    _nhit_induction  = hitsInduction.size();
-    _nhit_collection = hitsCollection.size();
+    _nhit_induction  = timesInduction.size();
+    _nhit_collection = timesCollection.size();
     
-    for (auto const& hitC : hitsCollection) 
-      compatibility += Isochronous(hitC._t,hitsInduction);
+    for (auto const& tC : timesCollection) 
+      compatibility += Isochronous(tC,timesInduction);
     
-    compatibility /= (double)(hitsCollection.size());
+    compatibility /= (double)(timesCollection.size());
     
     _induction = clusters[inductionPlane]->_plane;
     _compat    = compatibility;
@@ -143,11 +143,11 @@ namespace clusmtool {
   {
   }
 
-  int CFAlgoDevel::Isochronous(const float& time, const std::vector<cluster::pt>& otherhits) {
+  int CFAlgoDevel::Isochronous(const float& time, const cluster::ptspan<float>& othertimes) {
 
-    for (auto const& hit : otherhits) {
+    for (auto const& t : othertimes) {
 
-      if ( fabs(hit._t - time) < _timetolerance) 
+      if ( fabs(t - time) < _timetolerance) 
 	return 1;
       
     }// for all hits in other cluster
@@ -21,6 +21,9 @@ namespace clusmtool {
     */
     float Float(const std::vector<const cluster::Cluster*> &clusters);
 
+    /// Clusters must overlap in time with IoU of at least _iou_min
+    double MinTimeOverlap() const { return (_iou_min > 0) ? _iou_min : 0; }
+
     void Report();
     
     void Reset();
@@ -171,17 +174,14 @@ namespace clusmtool {
   void CFAlgoIoU::getMinMaxTime(const cluster::Cluster* cluster, double& min, double& max)
   {
     
-    auto const& hits = cluster->GetHits();
-
     min = 9600;
     max = 0;
 
-    for (auto const& hit : hits){
-      
-      if (hit._t > max) max = hit._t;
-      if (hit._t < min) min = hit._t;
-
-    }// fo rall hits
+    // time extent is cached by the cluster
+    if (cluster->size()) {
+      if (cluster->_t_max > max) max = cluster->_t_max;
+      if (cluster->_t_min < min) min = cluster->_t_min;
+    }
     
     return;
   }
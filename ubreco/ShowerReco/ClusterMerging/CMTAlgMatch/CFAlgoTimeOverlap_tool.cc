@@ -28,6 +28,9 @@ namespace clusmtool {
     */
     float Float(const std::vector<const cluster::Cluster*> &clusters);
 
+    /// Clusters must overlap in time
+    double MinTimeOverlap() const { return 0; }
+
     void Report();
     
     void Reset();
@@ -41,7 +44,7 @@ namespace clusmtool {
     /**
        Is a hit matched on the other plane?
      */
-    int Matched(const float& time, const std::vector<cluster::pt>& otherhits);
+    int Matched(const float& time, const cluster::ptspan<float>& othertimes);
     
     float _timetolerance;
 
@@ -189,13 +192,13 @@ namespace clusmtool {
 
     // if the clusters overlap to some degree, check compatibility on hit-by-hit level
     double compatibility = 0.;
-    auto const& hitsCollection = clusters[collectionPlane]->GetHits();
-    auto const& hitsInduction  = clusters[inductionPlane ]->GetHits();
+    auto const timesCollection = clusters[collectionPlane]->Time();
+    auto const timesInduction  = clusters[inductionPlane ]->Time();
     
-    for (auto const& hitC : hitsCollection) 
-      compatibility += Matched(hitC._t,hitsInduction);
+    for (auto const& tC : timesCollection) 
+      compatibility += Matched(tC,timesInduction);
 
-    compatibility /= (double)(hitsCollection.size());
+    compatibility /= (double)(timesCollection.size());
 
     //_induction = clusters[inductionPlane]->_plane;
     //_compat    = compatibility;
@@ -214,11 +217,11 @@ namespace clusmtool {
   }
   
 
-  int CFAlgoTimeOverlap::Matched(const float& time, const std::vector<cluster::pt>& otherhits) {
+  int CFAlgoTimeOverlap::Matched(const float& time, const cluster::ptspan<float>& othertimes) {
 
-    for (auto const& hit : otherhits) {
+    for (auto const& t : othertimes) {
 
-      if ( fabs(hit._t - time) < _timetolerance) 
+      if ( fabs(t - time) < _timetolerance) 
 	return 1;
       
     }// for all hits in other cluster
@@ -229,17 +232,14 @@ namespace clusmtool {
   void CFAlgoTimeOverlap::getMinMaxTime(const cluster::Cluster* cluster, double& min, double& max)
   {
     
-    auto const& hits = cluster->GetHits();
-
     min = 9600;
     max = 0;
 
-    for (auto const& hit : hits){
-      
-      if (hit._t > max) max = hit._t;
-      if (hit._t < min) min = hit._t;
-
-    }// fo rall hits
+    // time extent is cached by the cluster
+    if (cluster->size()) {
+      if (cluster->_t_max > max) max = cluster->_t_max;
+      if (cluster->_t_min < min) min = cluster->_t_min;
+    }
     
     return;
   }
@@ -42,6 +42,9 @@ namespace clusmtool {
     /// Function to reset the algorithm instance ... maybe implemented via child class
     void Reset(){}
 
+    /// Bool() has no state
+    bool Reentrant() const { return true; }
+
     void SetMinLargeNHits(size_t n) { _min_size = n; }
     void SetMaxAngleDiff(float a) { _max_angle_diff = a; }
 
@@ -26,6 +26,9 @@ namespace clusmtool {
     /// Function to reset the algorithm instance ... maybe implemented via child class
     void Reset(){}
 
+    /// Bool() has no state, but verbose printout would interleave
+    bool Reentrant() const { return !_verbose; }
+
   protected:
 
     float _buffer;
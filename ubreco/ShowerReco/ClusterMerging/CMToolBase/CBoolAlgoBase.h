@@ -60,6 +60,12 @@ namespace clusmtool {
      */
     bool PairWiseMode()          { return _pair_wise; }
 
+    /**
+       Can Bool() be called concurrently for different pairs?
+       Only algorithms without per-call state should return true.
+     */
+    virtual bool Reentrant() const { return false; }
+
   protected:
 
     bool _merge_till_converge;
@@ -41,6 +41,14 @@ namespace clusmtool {
       else return -1;
     }
 
+    /**
+       Minimum drift-time overlap (intersection over union of the cluster time
+       ranges) a combination needs to get a positive score from Float().
+       CMatchManager only inspects combinations passing this requirement.
+       Negative: no requirement, every combination is inspected.
+    */
+    virtual double MinTimeOverlap() const { return -1; }
+
   };
 
 }
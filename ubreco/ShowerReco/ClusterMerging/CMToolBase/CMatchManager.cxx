@@ -3,6 +3,8 @@
 
 #include "CMatchManager.h"
 
+#include <functional>
+
 namespace clusmtool {
 
   CMatchManager::CMatchManager() : CMManagerBase()
@@ -132,6 +134,105 @@ namespace clusmtool {
       
   }
 
+  static void ClusterTimeRange(const ::cluster::Cluster& cluster, double& min, double& max)
+  {
+    // same convention as the time-based matching algorithms
+    min = 9600;
+    max = 0;
+    if (cluster.size()) {
+      if (cluster._t_max > max) max = cluster._t_max;
+      if (cluster._t_min < min) min = cluster._t_min;
+    }
+  }
+
+  std::vector<std::vector<std::pair<size_t,size_t> > >
+  CMatchManager::TimeOverlapCombinations(const std::vector<std::vector<size_t> >& cluster_array,
+                                         const double min_overlap) const
+  {
+    // Result container
+    std::vector<std::vector<std::pair<size_t,size_t> > > result;
+
+    size_t nplanes = cluster_array.size();
+
+    // Time range of each cluster, and per plane (start time, index) sorted by start time
+    std::vector<std::vector<std::pair<double,double> > > range_v(nplanes);
+    std::vector<std::vector<std::pair<double,size_t> > > start_v(nplanes);
+    // Largest time span per plane: bounds how early an overlapping cluster can start
+    std::vector<double> max_span_v(nplanes,0);
+
+    for(size_t plane=0; plane<nplanes; ++plane) {
+      range_v[plane].reserve(cluster_array[plane].size());
+      start_v[plane].reserve(cluster_array[plane].size());
+      for(size_t i=0; i<cluster_array[plane].size(); ++i) {
+        double min, max;
+        ClusterTimeRange(_in_clusters.at(cluster_array[plane][i]),min,max);
+        range_v[plane].push_back(std::make_pair(min,max));
+        start_v[plane].push_back(std::make_pair(min,i));
+        if(max - min > max_span_v[plane]) max_span_v[plane] = max - min;
+      }
+      std::sort(start_v[plane].begin(),start_v[plane].end());
+    }
+
+    // Clusters on a plane overlapping [min,max], in cluster_array order
+    auto overlapping = [&](size_t plane, double min, double max, std::vector<size_t>& index_v) {
+      index_v.clear();
+      auto const& start = start_v[plane];
+      auto iter = std::lower_bound(start.begin(),start.end(),
+                                   std::make_pair(min - max_span_v[plane],(size_t)0));
+      for(; iter != start.end() && (*iter).first <= max; ++iter)
+        if(range_v[plane][(*iter).second].second >= min) index_v.push_back((*iter).second);
+      std::sort(index_v.begin(),index_v.end());
+    };
+
+    // Loop over N-planes: start from max number of planes => down to 2 planes
+    for(size_t i=0; i<nplanes; ++i) {
+
+      if(nplanes < 2+i) break;
+
+      // Loop over possible N-plane combinations
+      for(auto const& plane_comb : SimpleCombination(nplanes,nplanes-i)) {
+
+        std::vector<size_t> comb(plane_comb.size(),0);
+        std::vector<std::vector<size_t> > cand_v(plane_comb.size());
+
+        // Depth-first over planes, keeping the common and total time ranges.
+        // Same order as ClusterCombinations: first plane in the outer loop.
+        std::function<void(size_t,double,double,double,double)> fill =
+          [&](size_t level, double common_min, double common_max, double total_min, double total_max) {
+
+          if(level == plane_comb.size()) {
+            double iou = (common_max - common_min) / (total_max - total_min);
+            if(iou < min_overlap) return;
+            result.push_back(std::vector<std::pair<size_t,size_t> >());
+            for(size_t n=0; n<comb.size(); ++n)
+              (*result.rbegin()).push_back(std::make_pair(plane_comb[n],comb[n]));
+            return;
+          }
+
+          auto const& plane = plane_comb[level];
+          overlapping(plane,common_min,common_max,cand_v[level]);
+
+          for(auto const& index : cand_v[level]) {
+            auto const& range = range_v[plane][index];
+            comb[level] = index;
+            fill(level+1,
+                 std::max(common_min,range.first), std::min(common_max,range.second),
+                 std::min(total_min ,range.first), std::max(total_max ,range.second));
+          }
+        };
+
+        // First plane: every cluster
+        for(size_t index=0; index<range_v[plane_comb[0]].size(); ++index) {
+          auto const& range = range_v[plane_comb[0]][index];
+          comb[0] = index;
+          fill(1,range.first,range.second,range.first,range.second);
+        }
+      }
+    }
+    return result;
+
+  }
+
   bool CMatchManager::IterationProcess()
   {
 
@@ -181,8 +282,12 @@ namespace clusmtool {
     for(auto const& clusters_per_plane : cluster_array)
 
       seed.push_back(clusters_per_plane.size());
-    
-    auto const& combinations = PlaneClusterCombinations(seed);
+
+    // If the algorithm requires the clusters to overlap in time,
+    // only generate the combinations that do
+    double min_overlap = _match_algo->MinTimeOverlap();
+
+    auto const& combinations = (min_overlap < 0) ? PlaneClusterCombinations(seed) : TimeOverlapCombinations(cluster_array,min_overlap);
 
     if(_debug_mode <= kPerIteration) 
       std::cout << "\033[93m checking through " << combinations.size() << " combinations \033[00m" << std::endl;
@@ -77,6 +77,15 @@ namespace clusmtool {
     /// FMWK function called @ end of Process()
     virtual void EventEnd();
 
+    /**
+       Plane/cluster combinations (same format and order as the full set of combinations)
+       restricted to those whose cluster time ranges overlap with IoU >= min_overlap.
+       Candidates in each plane are looked up from clusters sorted by start time.
+    */
+    std::vector<std::vector<std::pair<size_t,size_t> > >
+    TimeOverlapCombinations(const std::vector<std::vector<size_t> >& cluster_array,
+                            const double min_overlap) const;
+
   protected:
 
     /// Book keeper instance
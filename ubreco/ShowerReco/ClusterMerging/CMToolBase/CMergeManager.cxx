@@ -3,6 +3,10 @@
 
 #include "CMergeManager.h"
 
+#include <algorithm>
+
+#include "ubreco/Utilities/ParallelFor.h"
+
 namespace clusmtool {
 
   CMergeManager::CMergeManager() : CMManagerBase()
@@ -168,10 +172,8 @@ namespace clusmtool {
 	  std::vector<cluster::pt> tmp_hits;
 	  tmp_hits.reserve(tmp_hit_counts);
 	  
-	  for(auto const& index : indexes_v) {
-	    for(auto const& hit : _tmp_merged_clusters.at(index).GetHits())
-	      tmp_hits.push_back(hit);
-	  }
+	  for(auto const& index : indexes_v)
+	    _tmp_merged_clusters.at(index).AppendHits(tmp_hits);
 	  _out_clusters.push_back(::cluster::Cluster());
 	  
 	  if((*_out_clusters.rbegin()).SetHits(tmp_hits) < 1) continue;
@@ -232,12 +234,15 @@ namespace clusmtool {
     int nloop2  = 0;
     int ndiffpl = 0;
     int nflag   = 0;
+    int nfar    = 0;
     int nmerge  = 0;
 
     // which mode? pair-wise:
     if (_merge_algo_v[algo_idx]->PairWiseMode() == true) {
+
+      // Collect the pairs to inspect, in priority order
+      std::vector<std::pair<size_t,size_t> > pair_v;
       
-      // Run over clusters and execute merging algorithms
       for(auto citer1 = _priority.rbegin();
 	  citer1 != _priority.rend();
 	  ++citer1) {
@@ -264,44 +269,64 @@ namespace clusmtool {
 	  if(!(merge_flag.at((*citer2).second)) && !(merge_flag.at((*citer1).second)) ) continue;
 
 	  nflag += 1;
-	  
-	  // Skip if this combination is not allowed to merge
-	  if(!(book_keeper.MergeAllowed((*citer1).second,(*citer2).second))) continue;
 
-	  nmerge += 1;
+	  // Skip if the clusters are too far apart
+	  if(!PairInRange(in_clusters.at((*citer1).second),in_clusters.at((*citer2).second))) { nfar += 1; continue; }
+
+	  pair_v.emplace_back((*citer1).second,(*citer2).second);
+
+	} // end looping over all cluster pairs for citer1
+	
+      } // end looping over clusters
+
+      // A re-entrant algorithm is run on all pairs up front, in threads.
+      // Results are applied below in the same order as a serial pass,
+      // so the merge result does not change.
+      std::vector<char> merge_v;
+      bool precomputed = (_num_threads > 1) && _merge_algo_v[algo_idx]->Reentrant();
+      if (precomputed) EvaluatePairs(algo_idx,in_clusters,pair_v,merge_v);
+
+      // Execute merging algorithms
+      for (size_t n = 0; n < pair_v.size(); n++) {
+
+	auto const& index1 = pair_v[n].first;
+	auto const& index2 = pair_v[n].second;
+	
+	// Skip if this combination is not allowed to merge
+	if(!(book_keeper.MergeAllowed(index1,index2))) continue;
+
+	nmerge += 1;
+	
+	if(_debug_mode <= kPerMerging){
 	  
-	  if(_debug_mode <= kPerMerging){
-	    
-	    std::cout
-	      << Form("    \033[93mInspecting a pair (%zu, %zu) for merging... \033[00m",(*citer1).second, (*citer2).second)
-	      << std::endl;
-	  }
+	  std::cout
+	    << Form("    \033[93mInspecting a pair (%zu, %zu) for merging... \033[00m",index1,index2)
+	    << std::endl;
+	}
 
-	  niter += 1;
+	niter += 1;
+	
+	bool merge = precomputed ? merge_v[n] : _merge_algo_v[algo_idx]->Bool(in_clusters.at(index1),in_clusters.at(index2));
+	
+	if(_debug_mode <= kPerMerging) {
 	  
-	  bool merge = _merge_algo_v[algo_idx]->Bool(in_clusters.at((*citer1).second),in_clusters.at((*citer2).second));
+	  if(merge) 
+	    std::cout << "    \033[93mfound to be merged!\033[00m " 
+		      << std::endl
+		      << std::endl;
 	  
-	  if(_debug_mode <= kPerMerging) {
-	    
-	    if(merge) 
-	      std::cout << "    \033[93mfound to be merged!\033[00m " 
-			<< std::endl
-			<< std::endl;
-	    
-	    else 
-	      std::cout << "    \033[93mfound NOT to be merged...\033[00m" 
-			<< std::endl
-			<< std::endl;
-	    
-	  } // end looping over all sets of algorithms
+	  else 
+	    std::cout << "    \033[93mfound NOT to be merged...\033[00m" 
+		      << std::endl
+		      << std::endl;
 	  
-	  if(merge)
-	    
-	    book_keeper.Merge((*citer1).second,(*citer2).second);
+	} // end looping over all sets of algorithms
+	
+	if(merge)
 	  
-	} // end looping over all cluster pairs for citer1
+	  book_keeper.Merge(index1,index2);
 	
-      } // end looping over clusters
+      } // end looping over cluster pairs
 
       if (_debug_mode <= kPerIteration){
 	std::cout << "    \033[093m pair-wise comparisons : \033[00m  "  << niter  << std::endl;
@@ -309,6 +334,7 @@ namespace clusmtool {
 	std::cout << "    \033[093m loop2 iterations      : \033[00m  "  << nloop2 << std::endl;
 	std::cout << "    \033[093m ndiffplane            : \033[00m  "  << ndiffpl << std::endl;
 	std::cout << "    \033[093m nflag                 : \033[00m  "  << nflag << std::endl;
+	std::cout << "    \033[093m nfar                  : \033[00m  "  << nfar << std::endl;
 	std::cout << "    \033[093m nmerge                : \033[00m  "  << nmerge << std::endl;
       }
     }// if pair-wise mode
@@ -350,6 +376,33 @@ namespace clusmtool {
 
   }
 
+  bool CMergeManager::PairInRange(const ::cluster::Cluster& c1,
+				  const ::cluster::Cluster& c2) const
+  {
+    if (_max_pair_dist < 0) return true;
+
+    // gap between the bounding boxes in wire and time (0 if they overlap)
+    float dw = std::max( c1._w_min - c2._w_max, c2._w_min - c1._w_max );
+    float dt = std::max( c1._t_min - c2._t_max, c2._t_min - c1._t_max );
+    if (dw < 0) dw = 0;
+    if (dt < 0) dt = 0;
+
+    return (dw*dw + dt*dt) <= (_max_pair_dist*_max_pair_dist);
+  }
+
+  void CMergeManager::EvaluatePairs(const int& algo_idx,
+				    const std::vector<::cluster::Cluster> &in_clusters,
+				    const std::vector<std::pair<size_t,size_t> > &pair_v,
+				    std::vector<char> &merge_v) const
+  {
+    merge_v.assign(pair_v.size(),0);
+
+    ::ubutil::ParallelFor(pair_v.size(), _num_threads, [&](size_t n) {
+	merge_v[n] = _merge_algo_v[algo_idx]->Bool(in_clusters.at(pair_v[n].first),
+						   in_clusters.at(pair_v[n].second));
+      });
+  }
+
     void CMergeManager::ReportAlgoChain() {
     
     std::cout << "\t\t" << std::endl;
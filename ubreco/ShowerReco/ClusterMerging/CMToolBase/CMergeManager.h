@@ -17,6 +17,7 @@
 #include <iostream>
 
 #include <vector>
+#include <utility>
 
 #include <typeinfo>
 
@@ -81,6 +82,15 @@ namespace clusmtool {
      */
     void ReportAlgoChain();
 
+    /// Number of threads to evaluate pair-wise algorithms with (only used for re-entrant algorithms)
+    void SetNumThreads(size_t n) { _num_threads = (n ? n : 1); }
+
+    /**
+       Only hand pairs whose (wire,time) bounding boxes are closer than this
+       distance [cm] to pair-wise algorithms. Negative value: all pairs.
+     */
+    void SetMaxPairDistance(float d) { _max_pair_dist = d; }
+
 
   protected:
     
@@ -112,6 +122,16 @@ namespace clusmtool {
 		  const std::vector<bool> &merge_flag,
 		  CMergeBookKeeper &book_keeper) const;
 
+    /// Is the pair close enough to be handed to the merging algorithm?
+    bool PairInRange(const ::cluster::Cluster& c1,
+		     const ::cluster::Cluster& c2) const;
+
+    /// Run Bool() of a re-entrant algorithm on all pairs, spread over _num_threads
+    void EvaluatePairs(const int& algo_idx,
+		       const std::vector<::cluster::Cluster > &in_clusters,
+		       const std::vector<std::pair<size_t,size_t> > &pair_v,
+		       std::vector<char> &merge_v) const;
+
     /// Output clusters
     std::vector<cluster::Cluster> _out_clusters;
 
@@ -128,6 +148,12 @@ namespace clusmtool {
 
     /// Merging algorithm
     std::vector<std::unique_ptr<::clusmtool::CBoolAlgoBase> > _merge_algo_v;
+
+    /// Threads for pair-wise evaluation
+    size_t _num_threads = 1;
+
+    /// Maximum bounding-box distance [cm] of pairs to evaluate (negative: no limit)
+    float _max_pair_dist = -1;
     
 
   };
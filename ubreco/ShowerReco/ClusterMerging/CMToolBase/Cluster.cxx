@@ -12,18 +12,67 @@ namespace cluster {
     _sum_charge = 0;
     _plane      = 4;
 
-    _hits.clear();
+    _t_min = _t_max = 0;
+    _w_min = _w_max = 0;
 
+    _r_v.clear();
+    _a_v.clear();
+    _w_v.clear();
+    _t_v.clear();
+    _q_v.clear();
+    _pl_v.clear();
+    _idx_v.clear();
+
+  }
+
+  cluster::pt Cluster::GetHit(size_t i) const {
+
+    cluster::pt hit(_r_v[i], _a_v[i], _w_v[i], _t_v[i], _q_v[i], _pl_v[i]);
+    hit._idx = _idx_v[i];
+    return hit;
+  }
+
+  void Cluster::AppendHits(std::vector<cluster::pt>& pt_v) const {
+
+    for (size_t i=0; i < size(); i++)
+      pt_v.push_back(GetHit(i));
+  }
+
+  const std::vector<cluster::pt> Cluster::GetHits() const {
+
+    std::vector<cluster::pt> pt_v;
+    pt_v.reserve(size());
+    AppendHits(pt_v);
+    return pt_v;
   }
 
   int Cluster::SetHits(const std::vector<cluster::pt>& hits) {
     
     Clear();
 
-    _hits = hits;
-
     _plane = hits.at(0)._pl;
 
+    // store hits as one array per quantity
+    _r_v.reserve(hits.size());
+    _a_v.reserve(hits.size());
+    _w_v.reserve(hits.size());
+    _t_v.reserve(hits.size());
+    _q_v.reserve(hits.size());
+    _pl_v.reserve(hits.size());
+    _idx_v.reserve(hits.size());
+    for (auto const& hit: hits) {
+      _r_v.push_back(hit._r);
+      _a_v.push_back(hit._a);
+      _w_v.push_back(hit._w);
+      _t_v.push_back(hit._t);
+      _q_v.push_back(hit._q);
+      _pl_v.push_back(hit._pl);
+      _idx_v.push_back(hit._idx);
+    }
+
+    _t_min = _t_max = hits[0]._t;
+    _w_min = _w_max = hits[0]._w;
+
     _angle = 0.;
 
     float angle_min =  360.;
@@ -39,9 +88,9 @@ namespace cluster {
     // if hits are present in 1st and 4th quadrants (left-hand side)
     // then span calculation will be incorrect.
     // correct for this.
-    auto quadrantmixup = QuadMixup(_hits);
+    auto quadrantmixup = QuadMixup();
 
-    for (auto const& hit: _hits) {
+    for (auto const& hit: hits) {
 
       auto angle = hit._a;
 
@@ -67,6 +116,11 @@ namespace cluster {
       if (angle > angle_max) angle_max = angle;
       if (angle < angle_min) angle_min = angle;
 
+      if (hit._t < _t_min) _t_min = hit._t;
+      if (hit._t > _t_max) _t_max = hit._t;
+      if (hit._w < _w_min) _w_min = hit._w;
+      if (hit._w > _w_max) _w_max = hit._w;
+
       hit_w_v.push_back( hit._w );
       hit_t_v.push_back( hit._t );
       
@@ -78,12 +132,12 @@ namespace cluster {
 
     _angle_span = ::cluster::anglespan(angle_min,angle_max);
 
-    angle_avg /= _hits.size();
+    angle_avg /= hits.size();
     _angle_rms = 0.;
     
-    for (auto const& h : _hits)
-      _angle_rms += (h._a - angle_avg) * (h._a - angle_avg);
-    _angle_rms = sqrt( _angle_rms / (_hits.size() - 1) );
+    for (auto const& a : _a_v)
+      _angle_rms += (a - angle_avg) * (a - angle_avg);
+    _angle_rms = sqrt( _angle_rms / (hits.size() - 1) );
     
     
     if (quadrantmixup) {
@@ -99,18 +153,18 @@ namespace cluster {
 
     }
     
-    return _hits.size();
+    return size();
   }
 
-  bool Cluster::QuadMixup(const std::vector<::cluster::pt>& pt_v) {
+  bool Cluster::QuadMixup() const {
     
     bool quadrantmixup = false;
     bool quad1 = false;
     bool quad4 = false;
-    for (auto const& hit: _hits) {
+    for (auto const& a: _a_v) {
       
-      if (hit._a > 270.) quad4 = true;
-      if (hit._a < 90.)  quad1 = true;
+      if (a > 270.) quad4 = true;
+      if (a < 90.)  quad1 = true;
     }
     
     if (quad1 && quad4) quadrantmixup = true;
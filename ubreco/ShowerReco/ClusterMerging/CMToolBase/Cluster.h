@@ -75,6 +75,32 @@ namespace cluster {
     }
     
   };
+
+  /**
+     \class ptspan
+     Non-owning view over one per-hit quantity of a Cluster.
+     Valid until the cluster's hits are reset.
+   */
+  template <class T>
+  class ptspan{
+
+  public:
+
+    ptspan(const T* data, size_t size) : _data(data), _size(size) {}
+
+    const T* begin() const { return _data; }
+    const T* end()   const { return _data + _size; }
+    const T* data()  const { return _data; }
+    size_t   size()  const { return _size; }
+    bool     empty() const { return _size == 0; }
+    const T& operator[](size_t i) const { return _data[i]; }
+
+  private:
+
+    const T* _data;
+    size_t   _size;
+
+  };
   
   class Cluster {
     
@@ -96,11 +122,32 @@ namespace cluster {
 
     ::twodimtools::Linearity _lin;
 
-    const std::vector<cluster::pt> GetHits() const { return _hits; }
+    // extent of the hits in time and wire [cm], set by SetHits
+    float  _t_min;
+    float  _t_max;
+    float  _w_min;
+    float  _w_max;
+
+    /// Copy of the hits as pt records. Prefer the per-quantity views below.
+    const std::vector<cluster::pt> GetHits() const;
+
+    /// Append the hits as pt records to pt_v
+    void AppendHits(std::vector<cluster::pt>& pt_v) const;
+
+    /// hit i as a pt record
+    cluster::pt GetHit(size_t i) const;
+
+    /// Per-hit quantities, stored as one array each
+    ptspan<float> R()      const { return ptspan<float>(_r_v.data(), _r_v.size()); }
+    ptspan<float> Angle()  const { return ptspan<float>(_a_v.data(), _a_v.size()); }
+    ptspan<float> Wire()   const { return ptspan<float>(_w_v.data(), _w_v.size()); }
+    ptspan<float> Time()   const { return ptspan<float>(_t_v.data(), _t_v.size()); }
+    ptspan<float> Charge() const { return ptspan<float>(_q_v.data(), _q_v.size()); }
+    ptspan<int>   HitIdx() const { return ptspan<int>  (_idx_v.data(), _idx_v.size()); }
     
     int SetHits(const std::vector<cluster::pt>& hits) ;
 
-    size_t size() const { return _hits.size(); }
+    size_t size() const { return _t_v.size(); }
 
     float Length() const { return _end_pt._r - _start_pt._r; }
 
@@ -108,9 +155,15 @@ namespace cluster {
 
     void Clear();
 
-    bool QuadMixup(const std::vector<::cluster::pt>& pt_v);
+    bool QuadMixup() const;
 
-    std::vector<cluster::pt> _hits;
+    std::vector<float> _r_v;
+    std::vector<float> _a_v;
+    std::vector<float> _w_v;
+    std::vector<float> _t_v;
+    std::vector<float> _q_v;
+    std::vector<int>   _pl_v;
+    std::vector<int>   _idx_v;
     
   };
 
@@ -93,6 +93,8 @@ ClusterMerger::ClusterMerger(fhicl::ParameterSet const & pset)
   _merge_helper->GetManager().Reset();
   _merge_helper->GetManager().DebugMode(clusmtool::CMManagerBase::kPerIteration);
   _merge_helper->GetManager().MergeTillConverge(false);
+  _merge_helper->GetManager().SetNumThreads(pset.get<size_t>("NumThreads",1));
+  _merge_helper->GetManager().SetMaxPairDistance(pset.get<float>("MaxPairDistance",-1));
 
   //const fhicl::ParameterSet& priorityTool = pset.get<fhicl::ParameterSet>("PriorityTool");
   //_merge_helper->GetManager().AddPriorityAlgo(art::make_tool<clusmtool::CPriorityAlgoBase>(priorityTool));
@@ -228,7 +230,7 @@ const recob::Cluster ClusterMerger::FillClusterProperties(const ::cluster::Clust
   recob::Cluster clus(startW, 0., startT, 0., 0., CMCluster._angle, 0., 
 		      endW,   0., endT,   0., 0., 0., 0., 
 		      CMCluster._sum_charge, 0., CMCluster._sum_charge, 0., 
-		      CMCluster.GetHits().size(), 0., 0., n,
+		      CMCluster.size(), 0., 0., n,
                       channelMap.Plane(planeid).View(),
 		      planeid);
 
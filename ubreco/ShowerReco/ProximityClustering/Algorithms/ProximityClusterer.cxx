@@ -6,6 +6,10 @@
 #include "larcorealg/Geometry/Exceptions.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom<>()
 
+#include <algorithm>
+
+#include "ubreco/Utilities/ParallelFor.h"
+
 namespace gammacatcher {
 
   bool ProximityClusterer::initialize() {
@@ -26,219 +30,140 @@ namespace gammacatcher {
     if (hit_h->size() == 0)
       return false;
 
+    // hits on different planes are never compatible: each plane is clustered
+    // on its own. cluster indices used to run on across planes, so the planes
+    // are concatenated in order
+    std::vector<std::vector<unsigned int> > plane_clusters[3];
+
+    ::ubutil::ParallelFor(3, (_parallel ? 3 : 1), [&](size_t pl){
+	ClusterPlane(hit_h,pl,plane_clusters[pl]);
+      });
+
+    // make a vector for the clusters
+    for (auto& clusters : plane_clusters)
+      for (auto& clus : clusters)
+	_out_cluster_vector.push_back(std::move(clus));
+    
+    return true;
+  }
+
+  void ProximityClusterer::ClusterPlane(const art::ValidHandle<std::vector<recob::Hit> >& hit_h,
+					int plane, std::vector<std::vector<unsigned int> >& clusters) const {
 
-    // a map to connect hit index wih a cluster index
-    // each hit gets a cluster index
-    // _clusterMap[hit_index] -> cluster_index
-    std::map<size_t, size_t> _clusterMap;
-    // a map to connect the cluster index with the vector of hit indices for that cluster
-    // _clusters[index] -> vector of hit indices for that cluster
-    std::map<size_t,std::vector<size_t> > _clusters;
+    // hit map will only contain hits we want to use for clustering
+    HitGrid grid;
+    MakeHitMap(hit_h,plane,grid);
+    auto const& hits = grid.hits;
 
-    // keep track of largest cluster ID created
-    size_t maxClusterID = 0;
+    // cluster index of each hit, -1 if not assigned yet
+    std::vector<int> clusterMap(hit_h->size(),-1);
+    // hit indices of each cluster. merged clusters are left empty
+    // and do not make it to the output
+    std::vector<std::vector<size_t> > clusterHits;
 
-    for (int pl=0; pl < 3; pl++){
+    std::vector<size_t> neighborhits;
 
-      // hit map will only contain hits we want to use for clustering
-      MakeHitMap(hit_h,pl);
-      
-      // iterator for hit cell map
-      std::map<std::pair<int,int>, std::vector<size_t> >::iterator it;
-      
-      // loop through hits in each cell to find matches
-      for (it = _hitMap.begin(); it != _hitMap.end(); it++){
+    // loop through hits in each cell to find matches
+    for (int i=0; i < grid.nI; i++){
+      for (int j=0; j < grid.nJ; j++){
+
+	size_t cell = size_t(i)*grid.nJ + j;
+	if (grid.cellStart[cell] == grid.cellStart[cell+1]) continue;
 
-	// pair = (i,j) indices of this cell in the _hitMap
-	auto const& pair = it->first;
-	
-	// wire-space cell index
 	// prepare a hit list of all neighboring cells
 	// _________
 	// |__|__|__|
 	// |__|__|__|
 	// |__|__|__|
-	std::vector<size_t> cellhits = it->second;
+	neighborhits.clear();
+	getNeighboringHits(grid,i,j,neighborhits);
 
-	std::vector<size_t> neighborhits;
-	getNeighboringHits(pair,neighborhits);
+	for (size_t a = grid.cellStart[cell]; a < grid.cellStart[cell+1]; a++){
 
-	for (size_t h1=0; h1 < cellhits.size(); h1++){
-
-	  // has this hit been added to a cluster?
-	  // if so not necessary to look at
-	  auto const& hit1 = cellhits[h1];
+	  auto const& hit1 = hits[a];
 	  // keep track if the hit will ever be matched to another
 	  bool matched = false;
-	  // if not find hits it should be clustered with and add it to the appropriate cluster
-	  for (size_t h2=0; h2 < neighborhits.size(); h2++){
-	    auto const& hit2 = neighborhits[h2];
+	  for (auto const& hit2 : neighborhits){
 	    if (hit1 == hit2) continue;
+	    // once hit1 is matched, a hit already in its cluster changes nothing
+	    if (matched and clusterMap[hit1] >= 0 and clusterMap[hit1] == clusterMap[hit2]) continue;
 	    // are the hits compatible?
-	    bool compat = HitsCompatible(hit_h->at(hit1),
-					 hit_h->at(hit2));
-	    // should the hits go in the same cluster?
-	    if (compat){
-	      matched = true;
-	      // if both hits have already been assigned to a cluster then we can merge the cluster indices!
-	      if ( (_clusterMap.find(hit1) != _clusterMap.end()) and
-		   (_clusterMap.find(hit2) != _clusterMap.end()) ){
-		// if in the same cluster -> do nothing
-		// if they are in different clusters:
-		if (_clusterMap[hit1] != _clusterMap[hit2]){
-		  auto idx1 = _clusterMap[hit1];
-		  auto idx2 = _clusterMap[hit2];
-		  // hit indices for 1st cluster:
-		  auto hits1 = _clusters[idx1];
-		  auto hits2 = _clusters[idx2];
-		  // append hits2 to hits1
-		  for (auto h : hits2){
-		    hits1.push_back(h);
-		    // also change the index that the hit goes to (idx1 instead of idx2)
-		    _clusterMap[h] = idx1;
-		  }
-		  _clusters[idx1] = hits1;
-		  // erase cluster @ index2
-		  _clusters.erase(idx2);
-		}// if they are in different clusters
-	      }
-	      // if compatible and the 2nd hit has been added to a cluster
-	      // add hit1 to the same cluster
-	      else if ( (_clusterMap.find(hit2) != _clusterMap.end()) and
-			(_clusterMap.find(hit1) == _clusterMap.end()) ){
-		auto clusIdx = _clusterMap[hit2];
-		_clusterMap[hit1] = clusIdx;
-		_clusters[clusIdx].push_back(hit1);
-	      }
-	      // otherwise, add both to a new cluster
-	      else if ( (_clusterMap.find(hit1) != _clusterMap.end()) and
-			(_clusterMap.find(hit2) == _clusterMap.end()) ){
-		auto clusIdx = _clusterMap[hit1];
-		_clusterMap[hit2] = clusIdx;
-		_clusters[clusIdx].push_back(hit2);
+	    if (not HitsCompatible(hit_h->at(hit1),hit_h->at(hit2))) continue;
+	    matched = true;
+	    // if both hits have already been assigned to a cluster then we can merge the cluster indices!
+	    if ( clusterMap[hit1] >= 0 and clusterMap[hit2] >= 0 ){
+	      // if in the same cluster -> do nothing
+	      if (clusterMap[hit1] != clusterMap[hit2]){
+		auto idx1 = clusterMap[hit1];
+		auto idx2 = clusterMap[hit2];
+		// append hits of the 2nd cluster to the 1st one
+		auto hits2 = std::move(clusterHits[idx2]);
+		clusterHits[idx2].clear();
+		for (auto h : hits2){
+		  clusterHits[idx1].push_back(h);
+		  clusterMap[h] = idx1;
+		}
 	      }
-	      // if neither has a cluster yet
-	      else{
-		// create a new cluster for this match
-		_clusterMap[hit1] = maxClusterID;
-		_clusterMap[hit2] = maxClusterID;
-		std::vector<size_t> cl = {hit1,hit2};
-		_clusters[maxClusterID] = cl;
-		maxClusterID += 1;
-	      }
-	    }// if the two hits are compatible
-	  }// 2nd loop through hits in the cell
+	    }
+	    // if compatible and the 2nd hit has been added to a cluster
+	    // add hit1 to the same cluster
+	    else if ( clusterMap[hit2] >= 0 ){
+	      clusterMap[hit1] = clusterMap[hit2];
+	      clusterHits[clusterMap[hit2]].push_back(hit1);
+	    }
+	    // and the other way around
+	    else if ( clusterMap[hit1] >= 0 ){
+	      clusterMap[hit2] = clusterMap[hit1];
+	      clusterHits[clusterMap[hit1]].push_back(hit2);
+	    }
+	    // if neither has a cluster yet create a new one for this match
+	    else{
+	      clusterMap[hit1] = clusterMap[hit2] = clusterHits.size();
+	      clusterHits.push_back({hit1,hit2});
+	    }
+	  }// loop through neighboring hits
 	  // has this hit been matched? if not we still need to add it as its own cluster
 	  if (matched == false){
-	    _clusterMap[hit1] = maxClusterID;
-	    _clusters[maxClusterID] = {hit1};
-	    maxClusterID += 1;
+	    clusterMap[hit1] = clusterHits.size();
+	    clusterHits.push_back({hit1});
 	  }
-	}// 1st loop through hits in the cell
-      }// loop through all cells
-
-    }// loop through all planes
+	}// loop through hits in the cell
+      }
+    }// loop through all cells
 
-    // make a vector for the clusters
-    for (auto it = _clusters.begin(); it != _clusters.end(); it++){
-      auto indices = it->second;
-      // if there are enough indices, make a cluster
-      if (indices.size() >= 1){
-	std::vector<unsigned int> clus;
-	for (auto idx : indices)
-	  clus.push_back(idx);
-	_out_cluster_vector.push_back(clus);
-      }// if there are 2 hits in cluster
+    // clusters in the order they were created
+    for (auto const& indices : clusterHits){
+      if (indices.empty()) continue;
+      clusters.emplace_back(indices.begin(),indices.end());
     }
-    
-    return true;
-  }
 
-  // get all hits from neighboring cells
-  void ProximityClusterer::getNeighboringHits(const std::pair<int,int>& pair, std::vector<size_t>& hitIndices){
-   
-    auto const& i       = pair.first;
-    // time-space cell index
-    auto const& j       = pair.second;
+    return;
+  }
 
-    // _________
-    // |__|__|__|
-    // |__|XX|__|
-    // |__|__|__|
-    if (_hitMap.find(std::make_pair(i,j)) != _hitMap.end()){
-      for (auto &h : _hitMap[std::make_pair(i,j)])
-	hitIndices.push_back(h);
-    }
+  // get all hits from neighboring cells, in the same cell order as the std::map based hit map
+  void ProximityClusterer::getNeighboringHits(const HitGrid& grid, int i, int j,
+					      std::vector<size_t>& hitIndices) const {
 
-    // now look at neighboring cells, if they exist
-    // _________
-    // |__|__|__|
-    // |XX|__|__|
-    // |__|__|__|
-    if (_hitMap.find(std::make_pair(i-1,j)) != _hitMap.end()){
-      for (auto &h : _hitMap[std::make_pair(i-1,j)])
-	hitIndices.push_back(h);
-    }
-    // _________
-    // |__|__|__|
-    // |__|__|__|
-    // |__|XX|__|
-    if (_hitMap.find(std::make_pair(i,j-1)) != _hitMap.end()){
-      for (auto &h : _hitMap[std::make_pair(i,j-1)])
-	hitIndices.push_back(h);
-    }
-    // _________
-    // |__|__|__|
-    // |__|__|__|
-    // |XX|__|__|
-    if ( _hitMap.find(std::make_pair(i-1,j-1)) != _hitMap.end() ){
-      for (auto &h : _hitMap[std::make_pair(i-1,j-1)])
-	hitIndices.push_back(h);
-    }
     // _________
+    // |__|XX|__|   (i,j), (i-1,j), (i,j-1), (i-1,j-1), (i,j+1),
+    // |XX|XX|XX|   (i+1,j), (i+1,j+1), (i-1,j+1), (i+1,j-1)
     // |__|XX|__|
-    // |__|__|__|
-    // |__|__|__|
-    if ( _hitMap.find(std::make_pair(i,j+1)) != _hitMap.end() ){
-      for (auto &h : _hitMap[std::make_pair(i,j+1)])
-	hitIndices.push_back(h);
-    }
-    // _________
-    // |__|__|__|
-    // |__|__|XX|
-    // |__|__|__|
-    if ( _hitMap.find(std::make_pair(i+1,j)) != _hitMap.end() ){
-      for (auto &h : _hitMap[std::make_pair(i+1,j)])
-	hitIndices.push_back(h);
-    }
-    // _________
-    // |__|__|XX|
-    // |__|__|__|
-    // |__|__|__|
-    if ( _hitMap.find(std::make_pair(i+1,j+1)) != _hitMap.end() ){
-      for (auto &h : _hitMap[std::make_pair(i+1,j+1)])
-	hitIndices.push_back(h);
-    }
-    // _________
-    // |XX|__|__|
-    // |__|__|__|
-    // |__|__|__|
-    if ( _hitMap.find(std::make_pair(i-1,j+1)) != _hitMap.end() ){
-      for (auto &h : _hitMap[std::make_pair(i-1,j+1)])
-	hitIndices.push_back(h);
-    }
-    // _________
-    // |__|__|__|
-    // |__|__|__|
-    // |__|__|XX|
-    if ( _hitMap.find(std::make_pair(i+1,j-1)) != _hitMap.end() ){
-      for (auto &h : _hitMap[std::make_pair(i+1,j-1)])
-	hitIndices.push_back(h);
+    const int cells[9][2] = { {0,0}, {-1,0}, {0,-1}, {-1,-1}, {0,1},
+			      {1,0}, {1,1}, {-1,1}, {1,-1} };
+
+    for (auto const& c : cells){
+      int ni = i + c[0];
+      int nj = j + c[1];
+      if (ni < 0 || ni >= grid.nI || nj < 0 || nj >= grid.nJ) continue;
+      size_t ncell = size_t(ni)*grid.nJ + nj;
+      hitIndices.insert(hitIndices.end(),
+			grid.hits.begin() + grid.cellStart[ncell],
+			grid.hits.begin() + grid.cellStart[ncell+1]);
     }
   }
 
   // if two hits are further apart then the set distance -> not compatible
-  bool ProximityClusterer::HitsCompatible(const recob::Hit& h1, const recob::Hit& h2){
+  bool ProximityClusterer::HitsCompatible(const recob::Hit& h1, const recob::Hit& h2) const {
 
     if (h1.WireID().Plane != h2.WireID().Plane)
       return false;
@@ -291,12 +216,14 @@ namespace gammacatcher {
     return false;
   }
   
-  void ProximityClusterer::MakeHitMap(const art::ValidHandle<std::vector<recob::Hit> >& hitlist, int plane){
+  void ProximityClusterer::MakeHitMap(const art::ValidHandle<std::vector<recob::Hit> >& hitlist,
+				      int plane, HitGrid& grid) const {
     
-    _hitMap.clear();
-    // temporary pair
-    std::pair<int,int> tmpPair;
-
+    // hits we want to use and their (i,j) cell
+    // i : ith bin in wire of some width
+    // j : jth bin in time of some width
+    std::vector<size_t> hit_v;
+    std::vector<std::pair<int,int> > cell_v;
     
     for (size_t h=0; h < hitlist->size(); h++){
       
@@ -316,25 +243,45 @@ namespace gammacatcher {
 	// ignore hit if out of ROI
 	if (d2D > _ROISq) continue;
       }
-	
-
-      // map is (i,j) -> hit list
-      // i : ith bin in wire of some width
-      // j : jth bin in time of some width
-      int i = int(w/_cellSize);
-      int j = int(t/_cellSize);
-      tmpPair = std::make_pair(i,j);
-      // does this entry exist in the map?
-      // if yes -> append to vector
-      // if no create new vector and add to map
-      if (_hitMap.find(tmpPair) == _hitMap.end()){
-	std::vector<size_t> aaa = {h};
-	_hitMap[tmpPair] = aaa;
-      }
-      else
-	_hitMap[tmpPair].push_back(h);
+
+      hit_v.push_back(h);
+      cell_v.emplace_back(int(w/_cellSize), int(t/_cellSize));
     }// for all hits
 
+    grid.iMin = grid.jMin = 0;
+    grid.nI   = grid.nJ   = 0;
+    grid.hits.clear();
+    grid.cellStart.assign(1,0);
+    if (hit_v.empty()) return;
+
+    // dense grid spanning the cells in use
+    int iMax = cell_v[0].first;
+    int jMax = cell_v[0].second;
+    grid.iMin = iMax;
+    grid.jMin = jMax;
+    for (auto const& cell : cell_v){
+      grid.iMin = std::min(grid.iMin,cell.first);
+      grid.jMin = std::min(grid.jMin,cell.second);
+      iMax = std::max(iMax,cell.first);
+      jMax = std::max(jMax,cell.second);
+    }
+    grid.nI = iMax - grid.iMin + 1;
+    grid.nJ = jMax - grid.jMin + 1;
+
+    // count hits per cell, then place them: hits keep their index order within a cell
+    grid.cellStart.assign(size_t(grid.nI)*grid.nJ+1, 0);
+    for (auto const& cell : cell_v)
+      grid.cellStart[size_t(cell.first-grid.iMin)*grid.nJ + (cell.second-grid.jMin) + 1]++;
+    for (size_t c=1; c < grid.cellStart.size(); c++)
+      grid.cellStart[c] += grid.cellStart[c-1];
+
+    std::vector<size_t> pos(grid.cellStart.begin(), grid.cellStart.end()-1);
+    grid.hits.resize(hit_v.size());
+    for (size_t n=0; n < hit_v.size(); n++){
+      auto const& cell = cell_v[n];
+      grid.hits[pos[size_t(cell.first-grid.iMin)*grid.nJ + (cell.second-grid.jMin)]++] = hit_v[n];
+    }
+
     return;
   }
 
@@ -15,7 +15,7 @@
 #ifndef GAMMACATCHER_PROXIMITYCLUSTERER_H
 #define GAMMACATCHER_PROXIMITYCLUSTERER_H
 
-#include <map>
+#include <vector>
 
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Vertex.h"
@@ -42,6 +42,7 @@ namespace gammacatcher {
       _vertex      = false;
       _radius      = 2.0;
       _cellSize    = 2;
+      _parallel    = false;
     }
 
     /// Default destructor
@@ -69,6 +70,8 @@ namespace gammacatcher {
     void setRadius(double d) { _radius = d; }
     /// Verbosity setter
     void setVerbose(bool on) { _verbose = on; }
+    /// Cluster the three planes in separate threads
+    void setParallelPlanes(bool on) { _parallel = on; }
 
     // vertex coordinates on each plane
     bool loadVertex(detinfo::DetectorClocksData const& clockData,
@@ -90,28 +93,38 @@ namespace gammacatcher {
     /// verbosity flag
     bool _verbose;
 
+    /// process planes in parallel
+    bool _parallel;
+
     /// conversion factors for hits
     double _wire2cm, _time2cm;
 
+    /// hits of one plane binned in (wire,time) cells of size _cellSize
+    /// cell (i,j) holds hits[cellStart[c]] ... hits[cellStart[c+1]-1]
+    /// with c = (i-iMin)*nJ + (j-jMin)
+    struct HitGrid {
+      int iMin, jMin;
+      int nI, nJ;
+      std::vector<size_t> cellStart;
+      std::vector<size_t> hits;
+    };
+
     /// Map making function
     void MakeHitMap(const art::ValidHandle<std::vector<recob::Hit> >& hit_h,
-		    int plane);
+		    int plane, HitGrid& grid) const;
 
-    /// Functions to decide if two hits should belong to the same cluster or not
-    bool HitsCompatible(const recob::Hit& h1, const recob::Hit& h2);
+    /// get all hits from the 3x3 cells around cell (i,j)
+    void getNeighboringHits(const HitGrid& grid, int i, int j, std::vector<size_t>& hitIndices) const;
 
-    /// Function to get neighboring hits (from self + neighoring cells)
-    void getNeighboringHits(const std::pair<int,int>& pair, std::vector<size_t>& hitIndices);
+    /// Cluster the hits of one plane, appending the clusters to _out_cluster_vector
+    void ClusterPlane(const art::ValidHandle<std::vector<recob::Hit> >& hit_h,
+		      int plane, std::vector<std::vector<unsigned int> >& _out_cluster_vector) const;
+
+    /// Functions to decide if two hits should belong to the same cluster or not
+    bool HitsCompatible(const recob::Hit& h1, const recob::Hit& h2) const;
 
     /// check if time overlaps
     bool TimeOverlap(const recob::Hit& h1, const recob::Hit& h2, double& dmin) const;
-    
-    /// map connecting coordinate index (i,j) to [h1,h2,h3] (hit index list)
-    std::map<std::pair<int,int>, std::vector<size_t> > _hitMap;
-
-    /// maximum i'th and j'th
-    int _maxI;
-    int _maxJ;
 
     // has the vertex been loaded?
     bool _vertex;
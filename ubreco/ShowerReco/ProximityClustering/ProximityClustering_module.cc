@@ -83,6 +83,8 @@ private:
   // maximum tick-value for beam-related drift-window
   float fBeamDriftTickMax;
   double fROI; // in cm, spherical region around vertex to use for clustering
+  // cluster the three planes in separate threads
+  bool fParallelPlanes;
 
   // Proximity clusterer class
   gammacatcher::ProximityClusterer* _ProximityClusterer;
@@ -112,6 +114,7 @@ ProximityClustering::ProximityClustering(fhicl::ParameterSet const & p)
   fBeamDriftTickMin = p.get<float>      ("BeamDriftTickMin");
   fBeamDriftTickMax = p.get<float>      ("BeamDriftTickMax");
   fROI              = p.get<double>     ("ROI"          );
+  fParallelPlanes   = p.get<bool>       ("ParallelPlanes", false);
 
 }
 
@@ -169,6 +172,7 @@ void ProximityClustering::beginJob()
   _ProximityClusterer->initialize();
   _ProximityClusterer->setRadius(fClusterRadius);
   _ProximityClusterer->setCellSize(fCellSize);
+  _ProximityClusterer->setParallelPlanes(fParallelPlanes);
 
   return;
 }
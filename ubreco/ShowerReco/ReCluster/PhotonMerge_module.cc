@@ -432,7 +432,7 @@ void PhotonMerge::produce(art::Event & e)
       recob::Cluster clus(startW, 0., startT, 0., 0., CMCluster._angle, 0., 
 			  endW,   0., endT,   0., 0., 0., 0., 
 			  CMCluster._sum_charge, 0., CMCluster._sum_charge, 0., 
-			  CMCluster.GetHits().size(), 0., 0., (s*3)+pl,
+			  CMCluster.size(), 0., 0., (s*3)+pl,
                           channelMap.Plane(planeid).View(),
 			  planeid);
       
@@ -9,6 +9,9 @@
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace twodimtools {
 
   Poly2D::Poly2D()
@@ -21,21 +24,163 @@ namespace twodimtools {
     _wire2cm = channelMap.Plane(geo::PlaneID{0,0,0}).WirePitch();
     _time2cm = sampling_rate(clockData) / 1000.0 * detp.DriftVelocity( detp.Efield(), detp.Temperature() );
     _trigoff = trigger_offset(clockData);
+    UpdateBounds();
   }
 
   Poly2D::Poly2D(const std::vector< art::Ptr<recob::Hit> >& hit_v)
     : Poly2D()
   {
     SelectPolygonHitList(hit_v,vertices,0.95);
+    UpdateBounds();
   }
   
   //------------------------------------------------
-  // returns slope of line uniting points p1 and p2
-  float FindSlope( const std::pair<float, float> &p1,
-		   const std::pair<float, float> &p2 )
+  // z-component of (B-A) x (C-A): > 0 if A,B,C turn counter-clockwise
+  static double Cross(const std::pair<float, float> &A,
+	              const std::pair<float, float> &B,
+	              const std::pair<float, float> &C)
+  {
+    return ( (double)B.first - A.first ) * ( (double)C.second - A.second )
+      - ( (double)B.second - A.second ) * ( (double)C.first - A.first );
+  }
+
+  //------------------------------------------------------------------
+  // convex hull (Andrew's monotone chain), counter-clockwise, no collinear points
+  static std::vector< std::pair<float, float> > ConvexHull(std::vector< std::pair<float, float> > points)
+  {
+    std::sort(points.begin(), points.end());
+    points.erase( std::unique(points.begin(), points.end()), points.end() );
+    if (points.size() < 3) return points;
+    
+    std::vector< std::pair<float, float> > hull(2 * points.size());
+    size_t k = 0;
+    // lower hull
+    for (size_t i = 0; i < points.size(); i++) {
+      while ( k >= 2 && Cross(hull[k - 2], hull[k - 1], points[i]) <= 0 ) k--;
+      hull[k++] = points[i];
+    }
+    // upper hull
+    for (size_t i = points.size() - 1, t = k + 1; i > 0; i--) {
+      while ( k >= t && Cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0 ) k--;
+      hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+  }
+
+  //------------------------------------------------------------------
+  // is the closed polygon convex? all turns in the same direction and
+  // the edge direction changes sign at most twice along x and along y
+  // (i.e. the boundary winds around only once)
+  static bool IsConvex(const std::vector< std::pair<float, float> > &points)
+  {
+    // edges, skipping repeated vertices
+    std::vector< std::pair<double, double> > edges;
+    edges.reserve(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+      auto const& p1 = points[i];
+      auto const& p2 = points[(i + 1) % points.size()];
+      double dx = (double)p2.first - p1.first;
+      double dy = (double)p2.second - p1.second;
+      if ( (dx != 0) || (dy != 0) ) edges.push_back( std::make_pair(dx, dy) );
+    }
+    if (edges.size() < 3) return false;
+
+    int turn = 0;
+    int xflips = 0, yflips = 0;
+    int xsign = 0, ysign = 0;
+    // go around twice so that the sign changes across the closing edge are counted once
+    for (size_t i = 0; i < 2 * edges.size(); i++) {
+      auto const& e1 = edges[i % edges.size()];
+      auto const& e2 = edges[(i + 1) % edges.size()];
+      if (i < edges.size()) {
+	double cross = e1.first * e2.second - e1.second * e2.first;
+	// edge doubling back on itself
+	if ( (cross == 0) && (e1.first * e2.first + e1.second * e2.second < 0) ) return false;
+	int s = (cross > 0) - (cross < 0);
+	if (s != 0) {
+	  if (turn == 0) turn = s;
+	  else if (s != turn) return false;
+	}
+      }
+      int sx = (e1.first  > 0) - (e1.first  < 0);
+      int sy = (e1.second > 0) - (e1.second < 0);
+      if (sx != 0) {
+	if ( (xsign != 0) && (sx != xsign) && (i >= edges.size()) ) xflips++;
+	xsign = sx;
+      }
+      if (sy != 0) {
+	if ( (ysign != 0) && (sy != ysign) && (i >= edges.size()) ) yflips++;
+	ysign = sy;
+      }
+    }
+    
+    return (turn != 0) && (xflips <= 2) && (yflips <= 2);
+  }
+
+  //------------------------------------------------------------------
+  // is there an edge of hull a with all of hull b outside of it (or touching it)?
+  // both hulls counter-clockwise. The point of b furthest inside each edge
+  // moves forward monotonically as the edges of a turn, so this is O(n+m)
+  static bool SeparatingEdge(const std::vector< std::pair<float, float> > &a,
+		             const std::vector< std::pair<float, float> > &b)
+  {
+    if ( (a.size() < 2) || (b.empty()) ) return false;
+
+    // support point of b for the first edge
+    size_t j = 0;
+    for (size_t k = 1; k < b.size(); k++)
+      if ( Cross(a[0], a[1], b[k]) > Cross(a[0], a[1], b[j]) ) j = k;
+
+    for (size_t i = 0; i < a.size(); i++) {
+      auto const& a1 = a[i];
+      auto const& a2 = a[(i + 1) % a.size()];
+      // advance the support point of b
+      for (size_t step = 0; step < b.size(); step++) {
+	size_t next = (j + 1) % b.size();
+	if ( Cross(a1, a2, b[next]) > Cross(a1, a2, b[j]) ) j = next;
+	else break;
+      }
+      // all of b on the outer side of this edge
+      if ( Cross(a1, a2, b[j]) <= 0 ) return true;
+    }
+    return false;
+  }
+
+  //------------------------------------------------------------------
+  void Poly2D::UpdateBounds()
+  {
+    _xmin = _ymin =  std::numeric_limits<float>::max();
+    _xmax = _ymax = -std::numeric_limits<float>::max();
+    for (auto const& p : vertices) {
+      if (p.first  < _xmin) _xmin = p.first;
+      if (p.first  > _xmax) _xmax = p.first;
+      if (p.second < _ymin) _ymin = p.second;
+      if (p.second > _ymax) _ymax = p.second;
+    }
+    _hull   = ConvexHull(vertices);
+    _convex = IsConvex(vertices);
+  }
+
+  //------------------------------------------------------------------
+  bool Poly2D::BoxOverlap(const Poly2D &poly2) const
+  {
+    return ( (_xmin <= poly2._xmax) and (poly2._xmin <= _xmax) and
+	     (_ymin <= poly2._ymax) and (poly2._ymin <= _ymax) );
+  }
+
+  //------------------------------------------------------------------
+  bool Poly2D::BoxOverlap(const std::pair<float, float> &p1,
+			  const std::pair<float, float> &p2) const
+  {
+    return ( (std::min(p1.first , p2.first ) <= _xmax) and (_xmin <= std::max(p1.first , p2.first )) and
+	     (std::min(p1.second, p2.second) <= _ymax) and (_ymin <= std::max(p1.second, p2.second)) );
+  }
+
+  //------------------------------------------------------------------
+  bool Poly2D::HullsSeparated(const Poly2D &poly2) const
   {
-    float slope = (p2.second - p1.second) / (p2.first - p1.first);
-    return slope;
+    return ( SeparatingEdge(_hull, poly2._hull) or SeparatingEdge(poly2._hull, _hull) );
   }
   
   //-------------------------------------------------------------------------
@@ -87,6 +232,7 @@ namespace twodimtools {
     if ( !(poly1.PolyOverlap(poly2)) ) {
       std::vector< std::pair<float, float> > nullpoint;
       vertices = nullpoint;
+      UpdateBounds();
       return;
     }
     
@@ -109,6 +255,8 @@ namespace twodimtools {
     //3)
     //FIND SEGMENT INTERSECTIONS
     for (unsigned int i = 0; i < poly1.Size(); i++) {
+      // a segment outside of poly2's bounding box cannot cross it
+      if ( !(poly2.BoxOverlap( poly1.Point(i), poly1.Point(i + 1) )) ) continue;
       for (unsigned int j = 0; j < poly2.Size(); j++) {
 	if (SegmentOverlap( poly1.Point(i).first, poly1.Point(i).second,
 			    poly1.Point(i + 1).first, poly1.Point(i + 1).second,
@@ -123,6 +271,7 @@ namespace twodimtools {
     }//for all segments in poly1
     
     vertices = IntersectionPoints;
+    UpdateBounds();
     return;
   }
   
@@ -218,6 +367,8 @@ namespace twodimtools {
     
     bool overlap = false;
 
+    // vertices outside of the bounding box cannot be inside
+    if ( !BoxOverlap(poly2) ) return overlap;
     
     for (size_t j=0; j < poly2.Size(); j++){
       
@@ -230,56 +381,29 @@ namespace twodimtools {
     return overlap;
   }
   
-  //---------------------------------------------------------------
-  bool Poly2D::Overlap(float slope,
-		       const Poly2D &poly2,
-		       const std::pair<float, float> &origin) const
-  {
-    //translate and rotate both polygons
-    float theta = tan(slope);
-    //here we translate origin, rotate and find x-coordinates and find range of projection on edge line
-    std::pair<float, float> range1 = this->Project(origin, theta);
-    std::pair<float, float> range2 = poly2.Project(origin, theta);
-    //std::cout << "range 1: " << range1.first << " " << range1.second << std::endl;
-    //std::cout << "range 2: " << range2.first << " " << range2.second << std::endl;
-    //if the two projections don't overlap --> no overlap!
-    if ( ( ((range1.first <= range2.second) and ( range1.first >= range2.first )) or ((range1.second <= range2.second) and ( range1.second >= range2.first )) ) or ( ((range2.first <= range1.second) and ( range2.first >= range1.first )) or ((range2.second <= range1.second) and ( range2.second >= range1.first )) ) )
-      return true;     //yes...they overlap
-    else
-      return false;    //no....they do not overlap
-  }
-  
   //-------------------------------------------------------
   bool Poly2D::PolyOverlap(const Poly2D &poly2) const
   {
     
-    //start from first pair in vector then check all edges.
-    //edges are (0,1), (1,2), ..., (N,N-1) each pair a pair
-    //of vertexes
-    for (unsigned int i = 0; i < this->Size(); i++) { //loop over first polygon's vertices
-      //find projection line's slope
-      //line: y=ax+b --- slope is a variable
-      float slope;
-      slope = FindSlope( this->Point(i) , this->Point(i + 1) );
-      //if there is even one no-overlap
-      //need to exit and return no overlap!
-      if (! (this->Overlap( slope, poly2, this->Point(i) )) )
-	return false;
-    }//loop over first polygon vertices
-    
-    //do the exact same thing but reversing polygon role
-    for (unsigned int i = 0; i < poly2.Size(); i++) { //loop over first polygon
-      float slope;
-      slope = FindSlope( poly2.Point(i) , poly2.Point(i + 1) );
-      if (!(poly2.Overlap( slope, *this, poly2.Point(i) )) )
-	return false;
-    }//loop over second polygon vertices
-    return true;
+    //polygons whose bounding boxes or convex hulls are
+    //separated cannot overlap
+    if ( !BoxOverlap(poly2) )
+      return false;
+    if ( HullsSeparated(poly2) )
+      return false;
+    //convex polygons coincide with their hulls:
+    //no separating axis means they overlap
+    if ( _convex and poly2._convex )
+      return true;
+    //otherwise check containment and segment crossings
+    return PolyOverlapSegments(poly2);
   }
   
   //---------------------------------------------------------------
   bool Poly2D::PolyOverlapSegments(const Poly2D &poly2) const
   {
+    if ( !BoxOverlap(poly2) )
+      return false;
     //if contained in one another then they also overlap:
     if ( (this->Contained(poly2)) or (poly2.Contained(*this)) ) {
       return true;
@@ -306,6 +430,11 @@ namespace twodimtools {
     //any ray originating at point will cross polygon
     //even number of times if point outside
     //odd number of times if point inside
+    //the ray towards (10000,10000) cannot cross the polygon
+    //if it starts beyond the bounding box
+    if ( (std::min(point.first , (float)10000.) > _xmax) or
+	 (std::min(point.second, (float)10000.) > _ymax) )
+      return false;
     int intersections = 0;
     for (unsigned int i = 0; i < this->Size(); i++) {
       if ( SegmentOverlap( this->Point(i).first, this->Point(i).second,
@@ -325,6 +454,12 @@ namespace twodimtools {
   bool Poly2D::Contained(const Poly2D &poly2) const
   {
     
+    //poly2 sticking out of the bounding box
+    //cannot be contained
+    if ( (poly2._xmin < _xmin) or (poly2._xmax > _xmax) or
+	 (poly2._ymin < _ymin) or (poly2._ymax > _ymax) )
+      return false;
+    
     //loop over poly2 checking wehther
     //points of poly2 all inside poly1
     for (unsigned int i = 0; i < poly2.Size(); i++) {
@@ -367,6 +502,9 @@ namespace twodimtools {
 	}
       }//second loop
     }//first loop
+
+    //vertex order changed: convexity may have too
+    UpdateBounds();
     
   }
 
@@ -50,7 +50,7 @@ namespace twodimtools {
     /// default destructor
     ~Poly2D(){}
     /// constructor starting from list of edges for polygon
-    Poly2D(const std::vector< std::pair<float,float> > &points) { vertices = points; }
+    Poly2D(const std::vector< std::pair<float,float> > &points) { vertices = points; UpdateBounds(); }
     /// constructor given input list of hits
     Poly2D(const std::vector< art::Ptr<recob::Hit> >& hit_v);
     /// Create Intersection Polygon from 2 polygons
@@ -70,6 +70,8 @@ namespace twodimtools {
     bool Overlap(const Poly2D &poly2) const;
     /// boolean: do these polygons overlap?
     bool PolyOverlap(const Poly2D &poly2) const;
+    /// boolean: do these polygons overlap? (containment and segment crossings only, slow)
+    bool PolyOverlapSegments(const Poly2D &poly2) const;
     /// boolean: is a point inside the polygon?
     bool PointInside(const std::pair<float,float> &point) const;
     /// check if poly2 is fully contained in poly1
@@ -77,7 +79,9 @@ namespace twodimtools {
     /// untangle polygon
     void UntanglePolygon();
     /// clear polygon's points
-    void Clear() { vertices.clear(); }
+    void Clear() { vertices.clear(); UpdateBounds(); }
+    /// is the polygon convex (i.e. identical to its convex hull)?
+    bool Convex() const { return _convex; }
     
     ///Calculate the opening angle at the specified vertex:
     //float InteriorAngle(unsigned int p) const;
@@ -93,12 +97,23 @@ namespace twodimtools {
 
     /// vector listing the polygon edges
     std::vector< std::pair<float,float> > vertices;
-    
-    /// utility function used by PolyOverlap to determine overlap
-    bool Overlap(float slope, const Poly2D &poly2, const std::pair<float,float> &origin) const;
-    
-    /// utility function used in polygon overlap determination
-    bool PolyOverlapSegments(const Poly2D &poly2) const;
+
+    /// bounding box of the vertices (inverted if the polygon is empty)
+    float _xmin, _xmax, _ymin, _ymax;
+    /// convex hull of the vertices, counter-clockwise
+    std::vector< std::pair<float,float> > _hull;
+    /// true if the polygon is convex, i.e. it covers the same area as its hull
+    bool _convex;
+
+    /// recompute bounding box, hull and convexity: call whenever vertices change
+    void UpdateBounds();
+
+    /// do the bounding boxes of the two polygons overlap?
+    bool BoxOverlap(const Poly2D &poly2) const;
+    /// does the bounding box of segment p1-p2 overlap the polygon's bounding box?
+    bool BoxOverlap(const std::pair<float,float> &p1, const std::pair<float,float> &p2) const;
+    /// is there a separating axis between the convex hulls of the two polygons?
+    bool HullsSeparated(const Poly2D &poly2) const;
 
     /**
      * @brief Find the Polygon boundary given a list of hits
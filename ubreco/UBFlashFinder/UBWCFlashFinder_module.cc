@@ -79,12 +79,17 @@ private:
   bool _usePmtGainDB;
   bool _remap_ch;
   bool _useExtSat;
+  bool _batchedDeconv;
+  int _numThreads;
   float _OpDetFreq;
 
   std::vector<std::string> _flashProducts;
   std::vector<std::string> _saturationProducts;
   ::wcopreco::Config_Params flash_pset;
   ::wcopreco::UBAlgo flash_algo;
+  // deconvolution kernels, rebuilt only when the PMT gains change
+  std::vector<::wcopreco::kernel_fourier_container> _kernel_container_v;
+  std::vector<float> _kernel_gain;
   bool _saveAnaTree;
   //for ana output
   TTree* _outtree;
@@ -108,19 +113,28 @@ private:
   TTree* _histtree;
   std::vector<std::vector<double>> decon_vv;
 
+  // waveforms are read in place from the art products, samples are only
+  // converted to double when filling the wcopreco collections
+  typedef std::vector<const raw::OpDetWaveform*> OpDetWaveformView_t;
+  OpDetWaveformView_t make_view(std::vector<raw::OpDetWaveform> const& opwfms);
+
   void reco_default(art::Event &evt, double &triggerTime);
   void reco_external_sat(art::Event &evt, double &triggerTime);
   ::wcopreco::UBEventWaveform fill_evt_wf(double triggerTime,
-					  std::vector<raw::OpDetWaveform> bgh, 
-  					  std::vector<raw::OpDetWaveform> blg,
-  					  std::vector<raw::OpDetWaveform> chg,
-  					  std::vector<raw::OpDetWaveform> clg,
-  					  std::vector<float> pmt_gain, std::vector<float> pmt_gainerr );
+					  OpDetWaveformView_t const& bgh, 
+  					  OpDetWaveformView_t const& blg,
+  					  OpDetWaveformView_t const& chg,
+  					  OpDetWaveformView_t const& clg,
+  					  std::vector<float> const& pmt_gain, std::vector<float> const& pmt_gainerr );
   void fill_wfmcollection(double triggerTime,
-			  std::vector<raw::OpDetWaveform> opwfms,
+			  OpDetWaveformView_t const& opwfms,
 			  int type,
 			  ::wcopreco::OpWaveformCollection &wfm_collection);
+  void fill_saturation_wfm(double triggerTime,
+			   ::wcopreco::OpWaveformCollection const& sat_v,
+			   std::vector<raw::OpDetWaveform> &opwfms);
   std::vector<::wcopreco::kernel_fourier_container> fill_kernel_container(std::vector<float> pmt_gain);
+  void update_kernel_container();
   void GetFlashLocation(std::vector<double>, double&, double&, double&, double&);
   void fill_ana_tree(recob::OpFlash flash,int idx, int type);
 };
@@ -147,11 +161,15 @@ UBWCFlashFinder::UBWCFlashFinder(fhicl::ParameterSet const & p)
   _useExtSat         = p.get<bool>("ExtSaturation",false);
   _OpDetFreq         = p.get<float>("OpDetFreq");
   _saveAnaTree       = p.get<bool>("SaveAnaTree");
+  _batchedDeconv     = p.get<bool>("BatchedDeconvolution",false);
+  _numThreads        = p.get<int>("NumThreads",1);
 
   // configure
   flash_pset.set_do_swap_channels(_remap_ch);
   flash_pset.set_tick_width_us(1./_OpDetFreq*1.e6);
   flash_pset.set_scaling_by_channel(lghg_scale);
+  flash_pset.set_batched_deconvolution(_batchedDeconv);
+  flash_pset.set_num_threads(_numThreads);
   flash_pset.Check_common_parameters();
   flash_algo.Configure(flash_pset);
 
@@ -232,37 +250,14 @@ void UBWCFlashFinder::produce(art::Event & evt)
       pmt_gainerr.assign(32, 0.30);
     }    
   }
-  //reconstruct
-  flash_algo.Configure(flash_pset);
+  //reconstruct (flash_algo is configured once in the constructor, its caches live across events)
+  update_kernel_container();
   if(!_useExtSat) reco_default(evt, triggerTime);
   else reco_external_sat(evt, triggerTime);
 
   //get saturation corrected wf
-  auto const satb_v = flash_algo.get_merged_beam();
-  auto const satc_v = flash_algo.get_merged_cosmic();
-  for(const auto& isat : satb_v){
-    std::vector<unsigned short> wf;
-    for(unsigned int c=0; c<isat.size(); c++){
-      wf.push_back(isat[c]);
-    }
-    raw::TimeStamp_t t = isat.get_time_from_trigger()+triggerTime;
-    raw::Channel_t ch = isat.get_ChannelNum();
-    raw::OpDetWaveform wfm(t,ch,wf);
-    saturation_beam->emplace_back(std::move(wfm));
-    wf.clear();
-  }
-  for(const auto& isat : satc_v){
-    std::vector<unsigned short> wf;
-    for(unsigned int c=0; c<isat.size(); c++){
-      wf.push_back(isat[c]);
-    }
-    raw::TimeStamp_t t = isat.get_time_from_trigger()+triggerTime;
-    raw::Channel_t ch = isat.get_ChannelNum();
-    raw::OpDetWaveform wfm(t,ch,wf);
-    saturation_cosmic->emplace_back(std::move(wfm));
-    wf.clear();
-
-  }
+  fill_saturation_wfm(triggerTime, flash_algo.get_merged_beam(), *saturation_beam);
+  fill_saturation_wfm(triggerTime, flash_algo.get_merged_cosmic(), *saturation_cosmic);
   
   //get deconvolved WF
   if(_saveAnaTree){
@@ -324,24 +319,24 @@ void UBWCFlashFinder::reco_default(art::Event &evt, double &triggerTime){
   evt.getByLabel( _OpDataProducerCosmicLG, _OpDataTypes[kCosmicLowGain], wfCLGHandle);
   std::vector<raw::OpDetWaveform> const& opwfms_clg(*wfCLGHandle);
 
-  std::vector<raw::OpDetWaveform> sort_blg;
-  std::vector<raw::OpDetWaveform> sort_clg;
+  OpDetWaveformView_t sort_blg;
+  OpDetWaveformView_t sort_clg;
 
   // HBG: Below conditional should be true for every epoch contrary to embedded comment.
 
   if( /*evt.run() <= 3984*/ opwfms_blg.size()>opwfms_bhg.size() ){
     for (unsigned i=0; i<opwfms_blg.size(); i++){
-      if(opwfms_blg.at(i).size()>=1500) sort_blg.push_back(opwfms_blg.at(i));
-      if(opwfms_blg.at(i).size()<1500) sort_clg.push_back(opwfms_blg.at(i));
+      if(opwfms_blg.at(i).size()>=1500) sort_blg.push_back(&opwfms_blg.at(i));
+      if(opwfms_blg.at(i).size()<1500) sort_clg.push_back(&opwfms_blg.at(i));
     }
   }
   ::wcopreco::UBEventWaveform UB_evt_wf;
-  if(sort_blg.size()>0) UB_evt_wf = fill_evt_wf(triggerTime, opwfms_bhg, sort_blg, opwfms_chg, sort_clg, pmt_gain,pmt_gainerr);
-  else if(sort_blg.size()<=0) UB_evt_wf = fill_evt_wf(triggerTime, opwfms_bhg, opwfms_blg, opwfms_chg, opwfms_clg, pmt_gain,pmt_gainerr);
+  if(sort_blg.size()>0) UB_evt_wf = fill_evt_wf(triggerTime, make_view(opwfms_bhg), sort_blg, make_view(opwfms_chg), sort_clg, pmt_gain,pmt_gainerr);
+  else if(sort_blg.size()<=0) UB_evt_wf = fill_evt_wf(triggerTime, make_view(opwfms_bhg), make_view(opwfms_blg), make_view(opwfms_chg), make_view(opwfms_clg), pmt_gain,pmt_gainerr);
 
-  std::vector<wcopreco::kernel_fourier_container> kernel_container_v = fill_kernel_container( pmt_gain);
-  flash_algo.SaturationCorrection(&UB_evt_wf);
-  flash_algo.Run(&pmt_gain, &pmt_gainerr, &kernel_container_v);
+  //the event waveform is not used afterwards, let the merger take its collections
+  flash_algo.SaturationCorrection(std::move(UB_evt_wf));
+  flash_algo.Run(&pmt_gain, &pmt_gainerr, &_kernel_container_v);
   
 }
 
@@ -367,13 +362,12 @@ void UBWCFlashFinder::reco_external_sat(art::Event &evt, double &triggerTime){
   CHG_wfm_collection.set_op_gainerror(pmt_gainerr);
 
   //Fill up wfm collections
-  fill_wfmcollection(triggerTime, opwfms_bhg, ::wcopreco::kbeam_merged, BHG_wfm_collection);
-  fill_wfmcollection(triggerTime, opwfms_chg, ::wcopreco::kcosmic_merged, CHG_wfm_collection);
+  fill_wfmcollection(triggerTime, make_view(opwfms_bhg), ::wcopreco::kbeam_merged, BHG_wfm_collection);
+  fill_wfmcollection(triggerTime, make_view(opwfms_chg), ::wcopreco::kcosmic_merged, CHG_wfm_collection);
 
-  std::vector<wcopreco::kernel_fourier_container> kernel_container_v = fill_kernel_container( pmt_gain);
-  flash_algo.set_merged_beam(BHG_wfm_collection);
-  flash_algo.set_merged_cosmic(CHG_wfm_collection);
-  flash_algo.Run(&pmt_gain, &pmt_gainerr, &kernel_container_v);
+  flash_algo.set_merged_beam(std::move(BHG_wfm_collection));
+  flash_algo.set_merged_cosmic(std::move(CHG_wfm_collection));
+  flash_algo.Run(&pmt_gain, &pmt_gainerr, &_kernel_container_v);
 
 }
 
@@ -405,11 +399,11 @@ void UBWCFlashFinder::fill_ana_tree(recob::OpFlash flash, int idx, int type){
 // fills beam high/low gain, cosmic high/low gain
 //------------------------------------------------//
 ::wcopreco::UBEventWaveform UBWCFlashFinder::fill_evt_wf(double triggerTime,
-							 std::vector<raw::OpDetWaveform> bhg,
-							 std::vector<raw::OpDetWaveform> blg,
-							 std::vector<raw::OpDetWaveform> chg,
-							 std::vector<raw::OpDetWaveform> clg, 
-							 std::vector<float> pmt_gain, std::vector<float> pmt_gainerr){
+							 OpDetWaveformView_t const& bhg,
+							 OpDetWaveformView_t const& blg,
+							 OpDetWaveformView_t const& chg,
+							 OpDetWaveformView_t const& clg, 
+							 std::vector<float> const& pmt_gain, std::vector<float> const& pmt_gainerr){
   
   ::wcopreco::UBEventWaveform _UB_evt_wfm;
   std::vector<wcopreco::OpWaveformCollection> empty_vec;
@@ -439,10 +433,10 @@ void UBWCFlashFinder::fill_ana_tree(recob::OpFlash flash, int idx, int type){
   fill_wfmcollection(triggerTime, chg, ::wcopreco::kcosmic_hg, CHG_wfm_collection);
   fill_wfmcollection(triggerTime, clg, ::wcopreco::kcosmic_lg, CLG_wfm_collection);
 
-  _UB_evt_wfm.add_entry(BHG_wfm_collection, ::wcopreco::kbeam_hg );
-  _UB_evt_wfm.add_entry(BLG_wfm_collection, ::wcopreco::kbeam_lg );
-  _UB_evt_wfm.add_entry(CHG_wfm_collection, ::wcopreco::kcosmic_hg );
-  _UB_evt_wfm.add_entry(CLG_wfm_collection, ::wcopreco::kcosmic_lg );
+  _UB_evt_wfm.add_entry(std::move(BHG_wfm_collection), ::wcopreco::kbeam_hg );
+  _UB_evt_wfm.add_entry(std::move(BLG_wfm_collection), ::wcopreco::kbeam_lg );
+  _UB_evt_wfm.add_entry(std::move(CHG_wfm_collection), ::wcopreco::kcosmic_hg );
+  _UB_evt_wfm.add_entry(std::move(CLG_wfm_collection), ::wcopreco::kcosmic_lg );
 
   return _UB_evt_wfm;
 
@@ -453,11 +447,15 @@ void UBWCFlashFinder::fill_ana_tree(recob::OpFlash flash, int idx, int type){
 // merged waveforms filled by algo.Run()
 //-------------------------------------//
 void UBWCFlashFinder::fill_wfmcollection(double triggerTime,
-					 std::vector<raw::OpDetWaveform> opwfms,
+					 OpDetWaveformView_t const& opwfms,
 					 int type,
 					 ::wcopreco::OpWaveformCollection &wfm_collection) {
 
-  for(auto &opwfm : opwfms)  {
+  const int nbins_beam = flash_pset._get_cfg_deconvolver()._get_nbins_beam();
+  const int nbins_cosmic = flash_pset._get_cfg_cophit()._get_nbins_cosmic();
+
+  for(auto const* opwfm_ptr : opwfms)  {
+    auto const& opwfm = *opwfm_ptr;
     int ch = opwfm.ChannelNumber();
     double timestamp = opwfm.TimeStamp();
 
@@ -465,16 +463,16 @@ void UBWCFlashFinder::fill_wfmcollection(double triggerTime,
       continue;
 
     if ( (type == ::wcopreco::kbeam_hg)||(type==::wcopreco::kbeam_lg) || (type==::wcopreco::kbeam_merged) ){
-      ::wcopreco::OpWaveform wfm(ch%100, timestamp-triggerTime, type, flash_pset._get_cfg_deconvolver()._get_nbins_beam());
-      for (int bin=0; bin<flash_pset._get_cfg_deconvolver()._get_nbins_beam(); bin++) {
+      ::wcopreco::OpWaveform wfm(ch%100, timestamp-triggerTime, type, nbins_beam);
+      for (int bin=0; bin<nbins_beam; bin++) {
 	wfm[bin]=(double)opwfm[bin];
       }
 
       if(wfm_collection.get_channel2index(ch%100).size()==0){
-	wfm_collection.add_waveform(wfm);
+	wfm_collection.add_waveform(std::move(wfm));
       }
       else{
-	auto prev = wfm_collection.at(wfm_collection.get_channel2index(ch%100)[0]);
+	auto const& prev = wfm_collection.at(wfm_collection.get_channel2index(ch%100)[0]);
 	if(prev.get_time_from_trigger() > (timestamp-triggerTime)){
 	  wfm_collection.at(wfm_collection.get_channel2index(ch%100)[0]).swap(wfm);
 	  wfm_collection.at(wfm_collection.get_channel2index(ch%100)[0]).set_time_from_trigger(timestamp-triggerTime);
@@ -485,16 +483,47 @@ void UBWCFlashFinder::fill_wfmcollection(double triggerTime,
     }
 
     if ( (type == ::wcopreco::kcosmic_hg)||(type==::wcopreco::kcosmic_lg) || (type==::wcopreco::kcosmic_merged) ){
-      ::wcopreco::OpWaveform wfm(ch%100, timestamp-triggerTime, type, flash_pset._get_cfg_cophit()._get_nbins_cosmic());
-      for (int bin=0; bin<flash_pset._get_cfg_cophit()._get_nbins_cosmic(); bin++) {
+      ::wcopreco::OpWaveform wfm(ch%100, timestamp-triggerTime, type, nbins_cosmic);
+      for (int bin=0; bin<nbins_cosmic; bin++) {
 	wfm[bin]=(double)opwfm[bin];
       }
-      wfm_collection.add_waveform(wfm);
+      wfm_collection.add_waveform(std::move(wfm));
     }
   }
   
   return;
 }
+
+//--------------------------------------//
+// pointers to the waveforms of an art
+// product, nothing is copied
+//-------------------------------------//
+UBWCFlashFinder::OpDetWaveformView_t UBWCFlashFinder::make_view(std::vector<raw::OpDetWaveform> const& opwfms){
+  OpDetWaveformView_t view;
+  view.reserve(opwfms.size());
+  for(auto const& opwfm : opwfms) view.push_back(&opwfm);
+  return view;
+}
+
+//--------------------------------------//
+// convert the saturation corrected
+// waveforms back to raw::OpDetWaveform
+//-------------------------------------//
+void UBWCFlashFinder::fill_saturation_wfm(double triggerTime,
+					  ::wcopreco::OpWaveformCollection const& sat_v,
+					  std::vector<raw::OpDetWaveform> &opwfms){
+  opwfms.reserve(opwfms.size()+sat_v.size());
+  for(const auto& isat : sat_v){
+    raw::TimeStamp_t t = isat.get_time_from_trigger()+triggerTime;
+    raw::Channel_t ch = isat.get_ChannelNum();
+    //this constructor only reserves the samples
+    raw::OpDetWaveform wfm(t,ch,isat.size());
+    for(unsigned int c=0; c<isat.size(); c++){
+      wfm.push_back((unsigned short)isat[c]);
+    }
+    opwfms.emplace_back(std::move(wfm));
+  }
+}
 //--------------------------------//
 // make kernels for deconvolution
 //--------------------------------//
@@ -515,6 +544,16 @@ std::vector<wcopreco::kernel_fourier_container> UBWCFlashFinder::fill_kernel_con
   return kernel_container_v;
 }
 
+//--------------------------------//
+// keep the kernels of the previous
+// event unless the gains changed
+//--------------------------------//
+void UBWCFlashFinder::update_kernel_container(){
+  if(!_kernel_container_v.empty() && _kernel_gain==pmt_gain) return;
+  _kernel_container_v = fill_kernel_container(pmt_gain);
+  _kernel_gain = pmt_gain;
+}
+
 //----------------------------------------//
 // calculate PE-weighted flash location
 // this frunction is from UBFlashFinder
@@ -0,0 +1,68 @@
+/**
+ * \file ParallelFor.h
+ *
+ * \ingroup Utilities
+ *
+ * \brief Worker pool for the NumThreads options of the reconstruction modules
+ *
+ */
+
+/** \addtogroup Utilities
+
+    @{*/
+#ifndef UBRECO_UTILITIES_PARALLELFOR_H
+#define UBRECO_UTILITIES_PARALLELFOR_H
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ubutil {
+
+  /**
+     Calls work(worker) for worker = 0 ... nworkers-1, worker 0 on the calling
+     thread and the others on their own threads. Once all of them are done, the
+     first exception thrown (in worker order) is rethrown.
+  */
+  template<typename F>
+  void RunWorkers(size_t nworkers, F work)
+  {
+    std::vector<std::exception_ptr> error_v(nworkers);
+    auto run = [&](size_t worker) {
+      try { work(worker); }
+      catch (...) { error_v[worker] = std::current_exception(); }
+    };
+
+    std::vector<std::thread> thread_v;
+    if (nworkers > 1) thread_v.reserve(nworkers-1);
+    for (size_t worker = 1; worker < nworkers; ++worker) thread_v.emplace_back(run,worker);
+    if (nworkers) run(0);
+    for (auto& t : thread_v) t.join();
+
+    for (auto const& error : error_v)
+      if (error) std::rethrow_exception(error);
+  }
+
+  /**
+     Calls f(i) for i = 0 ... n-1 on min(nthreads,n) workers. Worker w handles
+     i = w, w+nworkers, ... so f must only write to the outputs of its own i.
+     With nthreads <= 1 this is the plain serial loop.
+  */
+  template<typename F>
+  void ParallelFor(size_t n, size_t nthreads, F f)
+  {
+    if (nthreads <= 1 || n <= 1) {
+      for (size_t i = 0; i < n; ++i) f(i);
+      return;
+    }
+    size_t nworkers = (nthreads < n ? nthreads : n);
+    RunWorkers(nworkers, [&](size_t worker) {
+	for (size_t i = worker; i < n; i += nworkers) f(i);
+      });
+  }
+
+}
+
+#endif
+/** @} */ // end of doxygen group
@@ -0,0 +1,203 @@
+/**
+ * \file SlidingWindow.h
+ *
+ * \ingroup Utilities
+ *
+ * \brief Sliding windows over ordered points, evaluated in place
+ *
+ */
+
+/** \addtogroup Utilities
+
+    @{*/
+#ifndef UBRECO_UTILITIES_SLIDINGWINDOW_H
+#define UBRECO_UTILITIES_SLIDINGWINDOW_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace ubutil {
+
+  /**
+     \class SlidingWindow
+     One window per element of a sequence of Size() elements, given as index
+     ranges instead of copies: away from the ends, window i covers the elements
+     [i+1-w, i+w) with w = (window_size+1)/2. Near the ends the windows shrink
+     and are clamped to the sequence. Both bounds never decrease with i.
+  */
+  class SlidingWindow {
+
+  public:
+
+    SlidingWindow(size_t num, size_t window_size)
+      : _num(num), _w((window_size + 2 - 1)/2)
+    {}
+
+    /// number of windows (one per element)
+    size_t Size() const { return _num; }
+
+    size_t Begin(size_t i) const
+    {
+      size_t k = i + 1;
+      size_t b;
+      if (k < _w)                  b = 0;
+      else if (k > _num - _w + 1)  b = _num - 2*((_num - k)%_w) - 1;
+      else                         b = k - _w;
+      return std::min(b, _num);
+    }
+
+    size_t End(size_t i) const
+    {
+      size_t k = i + 1;
+      size_t e;
+      if (k < _w)                  e = 2*(k%_w) - 1;
+      else if (k > _num - _w + 1)  e = _num;
+      else                         e = k + _w - 1;
+      return std::max(std::min(e, _num), Begin(i));
+    }
+
+  private:
+
+    size_t _num;
+    size_t _w;
+
+  };
+
+  /// Moments of two variables over a window
+  struct WindowMoments {
+    double cov     = 0; ///< covariance, normalised to the number of entries
+    double stdev_x = 0; ///< standard deviation of the first variable
+    double stdev_y = 0; ///< standard deviation of the second variable
+  };
+
+  /**
+     Mean of fx(v[j]) for j in [begin, end), summed in index order.
+  */
+  template<typename T, typename FX>
+  double window_mean(const std::vector<T>& v, size_t begin, size_t end, FX fx)
+  {
+    double result = 0.0;
+    for (size_t j = begin; j < end; ++j) result += fx(v[j]);
+    return result / ((double)(end - begin));
+  }
+
+  /**
+     Covariance and standard deviations of fx(v[j]), fy(v[j]) for j in [begin, end),
+     computed in two passes (means first, then the centred sums).
+  */
+  template<typename T, typename FX, typename FY>
+  WindowMoments window_moments(const std::vector<T>& v, size_t begin, size_t end, FX fx, FY fy)
+  {
+    double n = (double)(end - begin);
+    double sum_x = 0.0, sum_y = 0.0;
+    for (size_t j = begin; j < end; ++j) {
+      sum_x += fx(v[j]);
+      sum_y += fy(v[j]);
+    }
+    double mean_x = sum_x / n;
+    double mean_y = sum_y / n;
+
+    double c = 0.0, var_x = 0.0, var_y = 0.0;
+    for (size_t j = begin; j < end; ++j) {
+      double dx = fx(v[j]) - mean_x;
+      double dy = fy(v[j]) - mean_y;
+      c     += dx*dy;
+      var_x += dx*dx;
+      var_y += dy*dy;
+    }
+
+    WindowMoments m;
+    m.cov     = c / n;
+    m.stdev_x = std::sqrt(var_x / n);
+    m.stdev_y = std::sqrt(var_y / n);
+    return m;
+  }
+
+  /**
+     \class SortedWindow
+     Values of a sliding window kept in increasing order. Moving to the next
+     window erases the values that left it and inserts the ones that entered,
+     so the buffer is only sorted from scratch when the window jumps, and it
+     does not allocate once it has grown to the window size.
+  */
+  class SortedWindow {
+
+  public:
+
+    /// update to the values f(v[j]) for j in [begin, end)
+    template<typename T, typename F>
+    void Update(const std::vector<T>& v, size_t begin, size_t end, F f)
+    {
+      if (begin < _begin || end < _end || begin >= _end) {
+        Fill(v, begin, end, f);
+        return;
+      }
+      for (size_t j = _begin; j < begin; ++j) {
+        double x = f(v[j]);
+        auto it = std::lower_bound(_sorted.begin(), _sorted.end(), x);
+        // values without an order (nan) cannot be found: sort again
+        if (it == _sorted.end() || !(*it == x)) {
+          Fill(v, begin, end, f);
+          return;
+        }
+        _sorted.erase(it);
+      }
+      for (size_t j = _end; j < end; ++j) {
+        double x = f(v[j]);
+        _sorted.insert(std::upper_bound(_sorted.begin(), _sorted.end(), x), x);
+      }
+      _begin = begin;
+      _end   = end;
+    }
+
+    /// forget the current window
+    void Clear()
+    {
+      _sorted.clear();
+      _begin = _end = 0;
+    }
+
+    size_t size() const { return _sorted.size(); }
+
+    double operator[](size_t i) const { return _sorted[i]; }
+
+    /// mean of the sorted values [first, last), summed in increasing order
+    double Mean(size_t first, size_t last) const
+    {
+      double sum = 0.0;
+      for (size_t i = first; i < last; ++i) sum += _sorted[i];
+      return sum / ((double)(last - first));
+    }
+
+    /// median of the sorted values [first, last)
+    double Median(size_t first, size_t last) const
+    {
+      size_t size = last - first;
+      if (size % 2 == 0)
+        return (_sorted[first + size/2 - 1] + _sorted[first + size/2]) / 2;
+      return _sorted[first + size/2];
+    }
+
+  private:
+
+    template<typename T, typename F>
+    void Fill(const std::vector<T>& v, size_t begin, size_t end, F f)
+    {
+      _sorted.clear();
+      for (size_t j = begin; j < end; ++j) _sorted.push_back(f(v[j]));
+      std::sort(_sorted.begin(), _sorted.end());
+      _begin = begin;
+      _end   = end;
+    }
+
+    std::vector<double> _sorted;
+    size_t _begin = 0;
+    size_t _end   = 0;
+
+  };
+
+}
+
+#endif
+/** @} */ // end of doxygen group
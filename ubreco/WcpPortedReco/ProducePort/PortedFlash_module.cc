@@ -16,6 +16,9 @@
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "larcorealg/Geometry/OpDetGeo.h"
 #include "ubcore/Geometry/UBOpReadoutMap.h"
+#include "cetlib_except/exception.h"
+
+#include "ubreco/WcpPortedReco/ProducePort/WcpPortInput.h"
 
 #include "TTree.h"
 #include "TBranch.h"
@@ -44,6 +47,18 @@ private:
 
   std::string fInput;
   std::string fTreeName;
+
+  // tree entry the branches are bound to, and the input file kept open
+  struct PortFlash {
+    int run=-1, subrun=-1, event=-1, type=-1;
+    double totalPE=-1., time=-1., low_time=-1., high_time=-1.;
+    std::vector<double> pe;
+    std::vector<double> pe_err;
+    std::vector<double> *pe_ptr = &pe;
+    std::vector<double> *pe_err_ptr = &pe_err;
+  } fFlash;
+  wcpport::WcpPortInput fReader;
+  void OpenInput();
 };
 
 pf::PortedFlash::PortedFlash(fhicl::ParameterSet const & p) : EDProducer{p}
@@ -57,6 +72,26 @@ pf::PortedFlash::PortedFlash(fhicl::ParameterSet const & p) : EDProducer{p}
   produces<std::vector<double> >("flashHighTime");
 }
 
+void pf::PortedFlash::OpenInput(){
+  std::cout<<"INPUT FILE NAME: "<<fInput<<std::endl;
+  if(!fReader.OpenMergedFile(fInput))
+    throw cet::exception("PortedFlash") << "Cannot open input file " << fInput << "\n";
+  TTree *tin = fReader.GetTree(fTreeName);
+  if(!tin)
+    throw cet::exception("PortedFlash") << "TTree " << fTreeName << " not found in file " << fInput << "\n";
+
+  tin->SetBranchAddress("run",&fFlash.run);
+  tin->SetBranchAddress("subrun",&fFlash.subrun);
+  tin->SetBranchAddress("event",&fFlash.event);
+  tin->SetBranchAddress("type",&fFlash.type);
+  tin->SetBranchAddress("totalPE",&fFlash.totalPE);
+  tin->SetBranchAddress("time",&fFlash.time);
+  tin->SetBranchAddress("low_time",&fFlash.low_time);
+  tin->SetBranchAddress("high_time",&fFlash.high_time);
+  tin->SetBranchAddress("pe",&fFlash.pe_ptr);
+  tin->SetBranchAddress("pe_err",&fFlash.pe_err_ptr);
+}
+
 void pf::PortedFlash::produce(art::Event &e){
 
   auto const& channelMap = ::art::ServiceHandle<geo::WireReadout const>()->Get();
@@ -66,35 +101,20 @@ void pf::PortedFlash::produce(art::Event &e){
   auto outputDoubleVecA = std::make_unique< std::vector<double> >();
   auto outputDoubleVecB = std::make_unique< std::vector<double> >();
 
-  std::string path(fInput);
-  std::string file = (path);
-  std::cout<<"INPUT FILE NAME: "<<file<<std::endl;
-  TFile *fin = new TFile(file.c_str());
-  TTree *tin = (TTree*)fin->Get(fTreeName.c_str());
-  
-  int run=-1, subrun=-1, event=-1, type=-1;
-  double totalPE=-1., time=-1., low_time=-1., high_time=-1.;
-  std::vector<double> *pe = new std::vector<double>;
-  std::vector<double> *pe_err = new std::vector<double>;
-  tin->SetBranchAddress("run",&run);
-  tin->SetBranchAddress("subrun",&subrun);
-  tin->SetBranchAddress("event",&event);
-  tin->SetBranchAddress("type",&type);
-  tin->SetBranchAddress("totalPE",&totalPE);
-  tin->SetBranchAddress("time",&time);
-  tin->SetBranchAddress("low_time",&low_time);
-  tin->SetBranchAddress("high_time",&high_time);
-  tin->SetBranchAddress("pe",&pe);
-  tin->SetBranchAddress("pe_err",&pe_err);
+  if(!fReader.IsOpen()) OpenInput();
+  TTree *tin = fReader.GetTree(fTreeName);
 
   std::cout<<"==========================================="<<std::endl;
   std::cout<<"Run "<<e.run()<<"   Subrun "<< e.subRun()<<"    Event "<<e.id().event()<<std::endl;
 
-  for(int i=0; i<tin->GetEntries(); i++){
+  // entries of this event only, from the (run, subrun, event) index of the tree
+  for(auto const& i : fReader.Entries(fTreeName, (int)e.run(), (int)e.subRun(), (int)e.id().event())){
     tin->GetEntry(i);
-    if( run!=(int)e.run() || 
-        subrun!=(int)e.subRun() || 
-	event!=(int)e.id().event() ) continue;
+    const std::vector<double>* pe = &fFlash.pe;
+    int type = fFlash.type;
+    double time = fFlash.time;
+    double low_time = fFlash.low_time;
+    double high_time = fFlash.high_time;
 
     double Ycenter=0., Zcenter=0., Ywidth=0., Zwidth=0.;
     double sumy=0., sumz=0., sumy2=0., sumz2=0.;
@@ -176,7 +196,6 @@ void pf::PortedFlash::produce(art::Event &e){
     }
   }
 
-  fin->Close();
   std::cout<<" flash vector size: "<<outputFlashVec->size()<<std::endl;
   e.put(std::move(outputFlashVec));
   e.put(std::move(outputIntVec), "flashType");
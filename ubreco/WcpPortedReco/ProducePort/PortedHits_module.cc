@@ -13,6 +13,9 @@
 #include "larcoreobj/SimpleTypesAndConstants/RawTypes.h"
 #include "lardata/Utilities/AssociationUtil.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
+#include "cetlib_except/exception.h"
+
+#include "ubreco/WcpPortedReco/ProducePort/WcpPortInput.h"
 
 #include "TTree.h"
 #include "TBranch.h"
@@ -45,6 +48,15 @@ private:
   short fTickOffset;
   float fChargeScaling;
   float fRebin;
+
+  // tree entry the branches are bound to, and the input file kept open
+  struct PortHit {
+    int run, subrun, event;
+    int channel, start_tick, main_flag;
+    float charge, charge_error;
+  } fHit;
+  wcpport::WcpPortInput fReader;
+  void OpenInput();
 };
 
 ph::PortedHits::PortedHits(fhicl::ParameterSet const & p) : EDProducer{p}
@@ -58,37 +70,43 @@ ph::PortedHits::PortedHits(fhicl::ParameterSet const & p) : EDProducer{p}
   produces<std::vector<recob::Hit> >();
 }
 
+void ph::PortedHits::OpenInput(){
+  std::cout<<"INPUT FILE NAME: "<<fInput<<std::endl;
+  if(!fReader.OpenMergedFile(fInput))
+    throw cet::exception("PortedHits") << "Cannot open input file " << fInput << "\n";
+  TTree *tin = fReader.GetTree(fTreeName);
+  if(!tin)
+    throw cet::exception("PortedHits") << "TTree " << fTreeName << " not found in file " << fInput << "\n";
+
+  tin->SetBranchAddress("run",&fHit.run);
+  tin->SetBranchAddress("subrun",&fHit.subrun);
+  tin->SetBranchAddress("event",&fHit.event);
+  tin->SetBranchAddress("channel",&fHit.channel);
+  tin->SetBranchAddress("start_tick",&fHit.start_tick);
+  tin->SetBranchAddress("main_flag",&fHit.main_flag);
+  tin->SetBranchAddress("charge",&fHit.charge);
+  tin->SetBranchAddress("charge_error",&fHit.charge_error);
+}
+
 void ph::PortedHits::produce(art::Event &e){
   std::unique_ptr<std::vector<recob::Hit> >hit_collection(new std::vector<recob::Hit>);
 
-  std::string path(fInput);
-
-  std::string file = (path);
-  std::cout<<"INPUT FILE NAME: "<<file<<std::endl;
-  TFile *fin = new TFile(file.c_str());
-  TTree *tin = (TTree*)fin->Get(fTreeName.c_str());
-  
-  int run, subrun, event;
-  int channel, start_tick, main_flag;
-  float charge, charge_error;
-  tin->SetBranchAddress("run",&run);
-  tin->SetBranchAddress("subrun",&subrun);
-  tin->SetBranchAddress("event",&event);
-  tin->SetBranchAddress("channel",&channel);
-  tin->SetBranchAddress("start_tick",&start_tick);
-  tin->SetBranchAddress("main_flag",&main_flag);
-  tin->SetBranchAddress("charge",&charge);
-  tin->SetBranchAddress("charge_error",&charge_error);
+  if(!fReader.IsOpen()) OpenInput();
+  TTree *tin = fReader.GetTree(fTreeName);
 
   //auto const &detClocks = lar::providerFrom<detinfo::DetectorClocksService>();
   auto const& channelMap = art::ServiceHandle<geo::WireReadout const>()->Get();
   int cryostat_no=0, tpc_no=0, plane_no=0;
-  for(int i=0; i<tin->GetEntries(); i++){
+  // entries of this event only, from the (run, subrun, event) index of the tree
+  for(auto const& i : fReader.Entries(fTreeName, (int)e.run(), (int)e.subRun(), (int)e.id().event())){
     tin->GetEntry(i);
 
-    if(fMainCluster==true && main_flag!=1) continue;
+    if(fMainCluster==true && fHit.main_flag!=1) continue;
 
-    if(run!=(int)e.run() || subrun!=(int)e.subRun() || event!=(int)e.id().event()) continue;
+    int channel = fHit.channel;
+    int start_tick = fHit.start_tick;
+    float charge = fHit.charge;
+    float charge_error = fHit.charge_error;
 
     if(channel<2400){ 
       plane_no=0; 
@@ -127,8 +145,6 @@ void ph::PortedHits::produce(art::Event &e){
                                          channelMap.SignalType(chan),
 					 wire));
   }
-  
-  fin->Close();
 
   std::cout<<" [threshold] hit collection size: "<<hit_collection->size()<<std::endl;
   e.put(std::move(hit_collection));
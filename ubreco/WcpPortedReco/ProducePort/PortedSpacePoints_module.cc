@@ -11,6 +11,9 @@
 
 #include "lardata/Utilities/AssociationUtil.h"
 #include "lardataobj/RecoBase/SpacePoint.h"
+#include "cetlib_except/exception.h"
+
+#include "ubreco/WcpPortedReco/ProducePort/WcpPortInput.h"
 
 #include "TTree.h"
 #include "TBranch.h"
@@ -41,6 +44,14 @@ private:
   bool fMainCluster;
   std::string fSpacePointLabel;
   short fTickOffset;
+
+  // tree entry the branches are bound to, and the input file kept open
+  struct PortSpacePoint {
+    int run=-1, subrun=-1, event=-1, /*cluster_id=-1,*/ main_flag=-1, time_slice=-1, ch_u=-1, ch_v=-1, ch_w=-1;
+    double x=-1., y=-1., z=-1., q=-1., nq=-1;
+  } fPoint;
+  wcpport::WcpPortInput fReader;
+  void OpenInput();
 };
 
 psp::PortedSpacePoints::PortedSpacePoints(fhicl::ParameterSet const & p) : EDProducer{p}
@@ -54,55 +65,55 @@ psp::PortedSpacePoints::PortedSpacePoints(fhicl::ParameterSet const & p) : EDPro
   produces<std::vector<recob::SpacePoint> >();
 }
 
+void psp::PortedSpacePoints::OpenInput(){
+  std::cout<<"INPUT FILE NAME: "<<fInput<<std::endl;
+  if(!fReader.OpenMergedFile(fInput))
+    throw cet::exception("PortedSpacePoints") << "Cannot open input file " << fInput << "\n";
+  TTree *tin = fReader.GetTree(fTreeName);
+  if(!tin)
+    throw cet::exception("PortedSpacePoints") << "TTree " << fTreeName << " not found in file " << fInput << "\n";
+
+  tin->SetBranchAddress("run",&fPoint.run);
+  tin->SetBranchAddress("subrun",&fPoint.subrun);
+  tin->SetBranchAddress("event",&fPoint.event);
+  //tin->SetBranchAddress("cluster_id",&fPoint.cluster_id);
+  tin->SetBranchAddress("main_flag",&fPoint.main_flag);
+  tin->SetBranchAddress("time_slice",&fPoint.time_slice);
+  tin->SetBranchAddress("ch_u",&fPoint.ch_u);
+  tin->SetBranchAddress("ch_v",&fPoint.ch_v);
+  tin->SetBranchAddress("ch_w",&fPoint.ch_w);
+  tin->SetBranchAddress("x",&fPoint.x);
+  tin->SetBranchAddress("y",&fPoint.y);
+  tin->SetBranchAddress("z",&fPoint.z);
+  tin->SetBranchAddress("q",&fPoint.q);
+  tin->SetBranchAddress("nq",&fPoint.nq);
+}
+
 void psp::PortedSpacePoints::produce(art::Event &e){
 
   auto outputSpacePointVec = std::make_unique< std::vector<recob::SpacePoint> >();
 
-  std::string path(fInput);
-  std::string file = (path);
-  std::cout<<"INPUT FILE NAME: "<<file<<std::endl;
-  TFile *fin = new TFile(file.c_str());
-  TTree *tin = (TTree*)fin->Get(fTreeName.c_str());
- 
-  int run=-1, subrun=-1, event=-1, /*cluster_id=-1,*/ main_flag=-1, time_slice=-1, ch_u=-1, ch_v=-1, ch_w=-1;
-  double x=-1., y=-1., z=-1., q=-1., nq=-1;
-  tin->SetBranchAddress("run",&run);
-  tin->SetBranchAddress("subrun",&subrun);
-  tin->SetBranchAddress("event",&event);
-  //tin->SetBranchAddress("cluster_id",&cluster_id);
-  tin->SetBranchAddress("main_flag",&main_flag);
-  tin->SetBranchAddress("time_slice",&time_slice);
-  tin->SetBranchAddress("ch_u",&ch_u);
-  tin->SetBranchAddress("ch_v",&ch_v);
-  tin->SetBranchAddress("ch_w",&ch_w);
-  tin->SetBranchAddress("x",&x);
-  tin->SetBranchAddress("y",&y);
-  tin->SetBranchAddress("z",&z);
-  tin->SetBranchAddress("q",&q);
-  tin->SetBranchAddress("nq",&nq);
-
-  for(int i=0; i<tin->GetEntries(); i++){
-    tin->GetEntry(i);
+  if(!fReader.IsOpen()) OpenInput();
+  TTree *tin = fReader.GetTree(fTreeName);
 
-    if(fMainCluster==true && main_flag!=1) continue;
+  // entries of this event only, from the (run, subrun, event) index of the tree
+  for(auto const& i : fReader.Entries(fTreeName, (int)e.run(), (int)e.subRun(), (int)e.id().event())){
+    tin->GetEntry(i);
 
-    if( run!=(int)e.run() || 
-        subrun!=(int)e.subRun() || 
-	event!=(int)e.id().event() ) continue;
+    if(fMainCluster==true && fPoint.main_flag!=1) continue;
 
     int id = -1;
     double xyz[3] = {0., 0., 0.};
     double xyz_err[6] = {0., 0., 0., 0., 0., 0.};
     double chisq = 0.;
 
-    xyz[0]=x; // x alignment not confirmed
-    xyz[1]=y;
-    xyz[2]=z;
+    xyz[0]=fPoint.x; // x alignment not confirmed
+    xyz[1]=fPoint.y;
+    xyz[2]=fPoint.z;
     recob::SpacePoint sp(xyz, xyz_err, chisq, id);
     outputSpacePointVec->emplace_back(sp);
   }
 
-  fin->Close();
   std::cout<<" space point vector size: "<<outputSpacePointVec->size()<<std::endl;
   e.put(std::move(outputSpacePointVec));
 }
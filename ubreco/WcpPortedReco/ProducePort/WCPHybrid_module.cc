@@ -17,11 +17,13 @@
 #include "lardata/Utilities/AssociationUtil.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
+#include "ubreco/Utilities/ParallelFor.h"
 
 #include "TF1.h"
 #include "TH1.h"
 #include "TMath.h"
 
+#include <algorithm>
 #include <memory>
 
 class WCPHybrid;
@@ -46,6 +48,7 @@ private:
   std::string fWireProducer;
   bool fChargeSupplement;
   bool fUnbin;
+  size_t fNumThreads;
   
 };
 
@@ -57,6 +60,7 @@ WCPHybrid::WCPHybrid(fhicl::ParameterSet const& p)
   fWireProducer = p.get<std::string>("WireProducer");
   fChargeSupplement = p.get<bool>("ChargeSupplement");
   fUnbin = p.get<bool>("Unbin");
+  fNumThreads = p.get<size_t>("NumThreads",1);
 
   produces<std::vector<raw::RawDigit> >();
   produces<std::vector<recob::Wire> >();
@@ -93,111 +97,121 @@ void WCPHybrid::produce(art::Event& e)
   lar_pandora::WireVector wire_vec;
   art::fill_ptr_vector(wire_vec, wire_handle);
 
-  std::map<int,std::vector<std::pair<int,int> > > hit_map;
-  std::pair<int,int> hit_roi;
-
+  // hits and merged hit tick ranges indexed by channel, built once per event
+  std::vector<std::vector<size_t> > channel_hits;
   for(size_t i_h=0; i_h<hit_vec.size(); ++i_h)
     {
-      art::Ptr<recob::Hit> hit = hit_vec.at(i_h);
-      hit_roi = std::make_pair( (int)hit->StartTick(), (int)hit->EndTick() );
-      hit_map[ (int)hit->Channel() ].emplace_back( hit_roi );
+      size_t ch = hit_vec[i_h]->Channel();
+      if(ch>=channel_hits.size()) channel_hits.resize(ch+1);
+      channel_hits[ch].push_back(i_h);
     }
 
-  for(size_t i_w=0; i_w<wire_vec.size(); ++i_w) // loop over all 8256 wires
+  std::vector<std::vector<std::pair<int,int> > > channel_ranges(channel_hits.size());
+  for(size_t ch=0; ch<channel_hits.size(); ++ch)
     {
-      art::Ptr<recob::Wire> wire = wire_vec.at(i_w);
-      auto wire_channel = wire->Channel();
-      std::vector<float> wf = wire->Signal();
-      recob::Wire::RegionsOfInterest_t roi( (int)wf.size() );
-      //recob::Wire::RegionsOfInterest_t unbinnedROI( (int)wf.size() );
-
-      bool found = false;
-      bool dead = false;
-
-      for(auto const& m : hit_map) // loop over (WCP-ported) hit channel-tick pairs
+      auto& ranges = channel_ranges[ch];
+      for(auto const& i_h : channel_hits[ch])
+	ranges.emplace_back( (int)hit_vec[i_h]->StartTick(), (int)hit_vec[i_h]->EndTick() );
+      std::sort(ranges.begin(), ranges.end());
+      // merge overlapping or touching ranges: the selected ticks are the same
+      size_t n = 0;
+      for(size_t i=0; i<ranges.size(); ++i)
 	{
-	  if( m.first != (int)wire_channel) {
-	    continue;
-	  }
-	  found=true;
-
-	  double totalsignal=0;
-	  for(int i=0; i<(int)wf.size(); i++){
-	    totalsignal+=wf.at(i);
-	  }
+	  if(ranges[i].first>ranges[i].second) continue;
+	  if(n>0 && ranges[i].first<=ranges[n-1].second+1)
+	    ranges[n-1].second = std::max(ranges[n-1].second, ranges[i].second);
+	  else
+	    ranges[n++] = ranges[i];
+	}
+      ranges.resize(n);
+    }
 
-	  if(totalsignal==0.0){
-	    dead=true;
+  // per wire ROIs, filled in parallel and stored in wire order
+  enum WireStatus : char { kNoHit = 0, kLive, kDead };
+  std::vector<const recob::Wire*> wires(wire_vec.size());
+  for(size_t i_w=0; i_w<wire_vec.size(); ++i_w) wires[i_w] = wire_vec[i_w].get();
+  std::vector<char> status(wires.size(), kNoHit);
+  std::vector<recob::Wire::RegionsOfInterest_t> rois(wires.size());
+
+  auto fillROI = [&](size_t i_w) {
+    const recob::Wire& wire = *wires[i_w];
+    size_t ch = wire.Channel();
+    if(ch>=channel_hits.size() || channel_hits[ch].empty()) return;
+
+    auto const& signal = wire.SignalROI();
+    int nticks = (int)signal.size();
+    auto& roi = rois[i_w];
+    roi.resize(nticks);
+
+    double totalsignal=0;
+    for(auto const& range : signal.get_ranges())
+      for(auto const& v : range) totalsignal+=v;
+    status[i_w] = (totalsignal==0.0) ? kDead : kLive;
+
+    // copy the non-zero runs of the signal inside the hit ranges
+    auto iSignal = signal.get_ranges().begin();
+    auto const signalEnd = signal.get_ranges().end();
+    for(auto const& r : channel_ranges[ch])
+      {
+	int lo = std::max(r.first, 0);
+	int hi = std::min(r.second, nticks-1);
+	if(lo>hi) continue;
+	while(iSignal!=signalEnd && (int)iSignal->end_index()<=lo) ++iSignal;
+	for(auto iRange=iSignal; iRange!=signalEnd && (int)iRange->begin_index()<=hi; ++iRange)
+	  {
+	    int offset = (int)iRange->begin_index();
+	    auto first = iRange->begin() + (std::max(lo, offset) - offset);
+	    auto done = iRange->begin() + (std::min(hi+1, (int)iRange->end_index()) - offset);
+	    auto beg = first;
+	    while(true)
+	      {
+		beg = std::find_if(beg, done, [](float v){ return v!=0.0; } );
+		if(beg==done) break;
+		auto end = std::find_if(beg, done, [](float v){ return v==0.0; } );
+		roi.add_range(offset + (beg-iRange->begin()), beg, end);
+		beg=end;
+	      }
 	  }
+      }
+  };
 
-	  for(auto & e : m.second) // loop over pairs of ticks of for a given <hit channel-time tick> pair
-	    {
-	      std::vector<float> wf_temp(wf.size(), 0.);
-	      for(int a=e.first; a<=e.second; a++) // e.first = start tick, e.second = end tick
-		{
-		  if(a<0 || a>(int)wf.size()-1) continue;
-		  wf_temp[a] = wf[a];
-		}
+  ubutil::ParallelFor(wires.size(), fNumThreads, fillROI);
 
-	      auto first = wf_temp.begin();
-	      auto done = wf_temp.end();
-	      auto beg = first;
-
-	      while(true)
-		{
-		  beg = std::find_if(beg, done, [](float v){ return v!=0.0; } ); // find the first "non-zero" element's iterator 
-		  if(beg==done) // if there's no element that satisfies the condition "element non-zero", then quit
-		    {
-		      break;
-		    }
-		  auto end = std::find_if(beg, done, [](float v){ return v==0.0;} ); // find the first "zero" element "after" beg iterator found above
-		  
-		  std::vector<float> c(beg, end);
-		  roi.add_range(beg-first, c.begin(), c.end()); //(offset:where to add the elements, first, last)
-		  beg=end;
-		}
-	    }
-	}
+  for(size_t i_w=0; i_w<wires.size(); ++i_w) // loop over all 8256 wires
+    {
+      if(status[i_w]==kNoHit) continue;
+      auto wire_channel = wires[i_w]->Channel();
+      int nticks = (int)wires[i_w]->NSignal();
+      auto& roi = rois[i_w];
 
-      if(found==true && dead==false) // live channels
+      if(status[i_w]==kLive) // live channels
 	{
-            outputWireVec->emplace_back(recob::Wire(roi,wire_channel,channelMap.View(wire_channel)));
-	    
-	    raw::RawDigit::ADCvector_t outadc;
-	    outadc.resize((int)wf.size(), 1);
-	    outputRawdigitVec->emplace_back(raw::RawDigit(wire_channel,(int)wf.size(),outadc,raw::kNone));
-	    const size_t outind = outputWireVec->size();
-	    auto const rawptr = rawPtr(outind-1);
-	    auto const sigptr = wirePtr(outind-1);
-	    outputRawdigitWireAssoc->addSingle(rawptr,sigptr);
+	  outputWireVec->emplace_back(recob::Wire(std::move(roi),wire_channel,channelMap.View(wire_channel)));
 	}
-      else if(found==true && dead==true) // charge supplement for dead channels                  
+      else // charge supplement for dead channels
 	{
 	  if(fChargeSupplement){
-
-	    for(size_t i_h=0; i_h<hit_vec.size(); ++i_h)
+	    for(auto const& i_h : channel_hits[wire_channel])
 	      {
-		art::Ptr<recob::Hit> hit = hit_vec.at(i_h);
-		if((int)hit->Channel()==(int)wire_channel){
-		  for(int i=(int)hit->StartTick(); i<(int)hit->EndTick()+1; ++i){
-		    roi.set_at(i, hit->PeakAmplitude());
-		  }
+		art::Ptr<recob::Hit> const& hit = hit_vec[i_h];
+		for(int i=(int)hit->StartTick(); i<(int)hit->EndTick()+1; ++i){
+		  roi.set_at(i, hit->PeakAmplitude());
 		}
 	      }
 	  }
 	  if(fUnbin==true) // unbinned WCP hit
-            outputWireVec->emplace_back(recob::Wire(unbinROI(roi,(int)wf.size()),wire_channel,channelMap.View(wire_channel)));
-	  else if(fUnbin==false) // raw WCP hit
-            outputWireVec->emplace_back(recob::Wire(roi,wire_channel,channelMap.View(wire_channel)));
-
-	  raw::RawDigit::ADCvector_t outadc;
-	  outadc.resize((int)wf.size(), 1);
-	  outputRawdigitVec->emplace_back(raw::RawDigit(wire_channel,(int)wf.size(),outadc,raw::kNone));
-	  const size_t outind = outputWireVec->size();
-	  auto const rawptr = rawPtr(outind-1);
-	  auto const sigptr = wirePtr(outind-1);
-	  outputRawdigitWireAssoc->addSingle(rawptr,sigptr);
+	    outputWireVec->emplace_back(recob::Wire(unbinROI(roi,nticks),wire_channel,channelMap.View(wire_channel)));
+	  else // raw WCP hit
+	    outputWireVec->emplace_back(recob::Wire(std::move(roi),wire_channel,channelMap.View(wire_channel)));
 	}
+
+      raw::RawDigit::ADCvector_t outadc;
+      outadc.resize(nticks, 1);
+      outputRawdigitVec->emplace_back(raw::RawDigit(wire_channel,nticks,outadc,raw::kNone));
+      const size_t outind = outputWireVec->size();
+      auto const rawptr = rawPtr(outind-1);
+      auto const sigptr = wirePtr(outind-1);
+      outputRawdigitWireAssoc->addSingle(rawptr,sigptr);
     }
 
   std::cout<<"[wcp hybrid wire] size: "<<outputWireVec->size()<<std::endl;
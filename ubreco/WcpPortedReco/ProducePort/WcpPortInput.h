@@ -0,0 +1,168 @@
+/**
+ * \file WcpPortInput.h
+ *
+ * \brief Reader for the ROOT files of the WireCell-ported products
+ *
+ */
+
+#ifndef WCPPORTINPUT_H
+#define WCPPORTINPUT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TSystem.h"
+
+namespace wcpport {
+
+  /**
+     \class WcpPortInput
+     Keeps a WireCell port input file open for the modules reading it and
+     tells which tree entries belong to an art event. Two layouts are supported:
+     - one file per event (entries of every tree belong to that event),
+       the file is reopened only when its name changes;
+     - one merged file for many events, opened once, where each tree has
+       run/subrun/event branches. The entries of each tree are indexed by
+       (run, subrun, event) the first time the tree is used.
+     Trees read a TTreeCache of CacheSize bytes, so the baskets of the next
+     entries are prefetched while the module steps through an event.
+   */
+  class WcpPortInput {
+
+  public:
+
+    typedef std::tuple<int,int,int> EventKey_t;
+
+    WcpPortInput(Long64_t cachesize = 10000000)
+      : _cacheSize(cachesize), _merged(false)
+    {}
+
+    /// open a file with one event; returns false if it does not exist or cannot be read
+    bool OpenEventFile(const std::string& fname) { return Open(fname,false); }
+
+    /// open a file with many events; returns false if it does not exist or cannot be read
+    bool OpenMergedFile(const std::string& fname) { return Open(fname,true); }
+
+    /// is a readable file open
+    bool IsOpen() const { return (bool)_file; }
+
+    /// name of the open file
+    const std::string& FileName() const { return _fileName; }
+
+    /// tree from the open file (nullptr if missing)
+    TTree* GetTree(const std::string& name)
+    {
+      auto it = _trees.find(name);
+      if (it != _trees.end()) return it->second.tree;
+      TreeInfo& info = _trees[name];
+      if (!_file) return nullptr;
+      info.tree = dynamic_cast<TTree*>(_file->Get(name.c_str()));
+      if (info.tree && (_cacheSize > 0)) {
+	info.tree->SetCacheSize(_cacheSize);
+	info.tree->AddBranchToCache("*",true);
+      }
+      if (info.tree && _merged) BuildIndex(info);
+      return info.tree;
+    }
+
+    /**
+       Entries of a tree for an event, in increasing order.
+       With one file per event these are all the entries of the tree.
+    */
+    const std::vector<Long64_t>& Entries(const std::string& name, int run, int subrun, int event)
+    {
+      static const std::vector<Long64_t> kNoEntries;
+      TTree* tree = GetTree(name);
+      if (!tree) return kNoEntries;
+      TreeInfo& info = _trees[name];
+      if (!_merged) {
+	if ((Long64_t)info.all.size() != tree->GetEntries()) {
+	  info.all.resize(tree->GetEntries());
+	  for (Long64_t i = 0; i < (Long64_t)info.all.size(); i++) info.all[i] = i;
+	}
+	return info.all;
+      }
+      auto it = info.index.find(EventKey_t(run,subrun,event));
+      if (it == info.index.end()) return kNoEntries;
+      return it->second;
+    }
+
+    /**
+       First entry of a tree for an event, -1 if it has none in a merged file.
+       With one file per event this is always entry 0.
+    */
+    Long64_t FirstEntry(const std::string& name, int run, int subrun, int event)
+    {
+      if (!_merged) return 0;
+      auto const& entries = Entries(name,run,subrun,event);
+      return entries.empty() ? -1 : entries.front();
+    }
+
+    void Close()
+    {
+      _trees.clear();
+      if (_file) _file->Close();
+      _file.reset();
+      _fileName = "";
+    }
+
+  private:
+
+    struct TreeInfo {
+      TTree* tree = nullptr;
+      std::vector<Long64_t> all;
+      std::map<EventKey_t, std::vector<Long64_t> > index;
+    };
+
+    bool Open(const std::string& fname, bool merged)
+    {
+      if (_file && (fname == _fileName) && (merged == _merged)) return true;
+      Close();
+      _merged = merged;
+      // AccessPathName returns true if the file can NOT be accessed
+      if (gSystem->AccessPathName(fname.c_str())) return false;
+      _file.reset(TFile::Open(fname.c_str(),"READ"));
+      if (!_file || _file->IsZombie()) {
+	_file.reset();
+	return false;
+      }
+      _fileName = fname;
+      return true;
+    }
+
+    /// read only the run/subrun/event branches of the tree and map them to the entries
+    void BuildIndex(TreeInfo& info)
+    {
+      TTree* tree = info.tree;
+      if (!tree->GetBranch("run") || !tree->GetBranch("subrun") || !tree->GetBranch("event")) return;
+      int run = -1, subrun = -1, event = -1;
+      tree->SetBranchStatus("*",0);
+      tree->SetBranchStatus("run",1);
+      tree->SetBranchStatus("subrun",1);
+      tree->SetBranchStatus("event",1);
+      tree->SetBranchAddress("run",&run);
+      tree->SetBranchAddress("subrun",&subrun);
+      tree->SetBranchAddress("event",&event);
+      for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+	tree->GetEntry(i);
+	info.index[EventKey_t(run,subrun,event)].push_back(i);
+      }
+      tree->ResetBranchAddresses();
+      tree->SetBranchStatus("*",1);
+    }
+
+    Long64_t _cacheSize;
+    bool _merged;
+    std::string _fileName;
+    std::unique_ptr<TFile> _file;
+    std::map<std::string, TreeInfo> _trees;
+
+  };
+}
+
+#endif
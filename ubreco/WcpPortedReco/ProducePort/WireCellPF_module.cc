@@ -19,11 +19,11 @@
 #include "nusimdata/SimulationBase/MCParticle.h"
 #include "ubobj/WcpPort/NuSelectionBDT.h"
 #include "ubobj/WcpPort/NuSelectionKINE.h"
+#include "ubreco/WcpPortedReco/ProducePort/WcpPortInput.h"
 
 #include <memory>
 #include <string>
 #include <iostream>
-#include <fstream>
 #include <vector>
 
 #include "TFile.h"
@@ -62,6 +62,7 @@ private:
   unsigned int NumberOfPF;
   std::string fInput; // input ROOT file for each event
   std::string fInput_prefix; // file name prefix
+  std::string fInput_merged; // merged input ROOT file for all events (replaces the per-event files if set)
   std::string fInput_tree;  // particle flow
   std::string fInput_tree2; // nu selection tagger results
   std::string fInput_tree3; // BDT input variables
@@ -70,6 +71,8 @@ private:
   bool f_PFport;
   bool f_BDTport;
   bool f_KINEport;
+
+  wcpport::WcpPortInput fReader; // keeps the input file and its trees open
 };
 
 
@@ -79,6 +82,7 @@ nsm::WireCellPF::WireCellPF(fhicl::ParameterSet const& p)
   , NumberOfPF    (0)
   , fInput        ("")
   , fInput_prefix (p.get<std::string>("PFInput_prefix", "nue")  )
+  , fInput_merged (p.get<std::string>("PFInput_merged", "")     )
   , fInput_tree   (p.get<std::string>("PFInput_tree", "TMC")    )
   , fInput_tree2  (p.get<std::string>("PFInput_tree2", "T_match"))
   , fInput_tree3  (p.get<std::string>("PFInput_BDT", "T_tagger"))
@@ -86,6 +90,7 @@ nsm::WireCellPF::WireCellPF(fhicl::ParameterSet const& p)
   , f_PFport	  (p.get<bool>("PFport", true))
   , f_BDTport	  (p.get<bool>("BDTport", true))
   , f_KINEport	  (p.get<bool>("KINEport", true))
+  , fReader       (p.get<long long>("PFInput_cache_size", 10000000))
 {
   // Call appropriate produces<>() functions here.
   // Call appropriate consumes<>() for any products to be retrieved by this module.
@@ -102,22 +107,23 @@ void nsm::WireCellPF::produce(art::Event& e)
 {
   // Implementation of required member function here.
   bool badinput = false;
-  TFile* fin = nullptr;
-  std::string event_runinfo = std::to_string((int)e.run())+"_"+std::to_string((int)e.subRun())+"_"+std::to_string((int)e.event());
-  fInput = fInput_prefix+"_"+event_runinfo+".root";
+  const int run = e.run();
+  const int subrun = e.subRun();
+  const int event = e.event();
+  bool merged = !fInput_merged.empty();
+  if(merged) {
+	fInput = fInput_merged;
+  }
+  else {
+	std::string event_runinfo = std::to_string(run)+"_"+std::to_string(subrun)+"_"+std::to_string(event);
+	fInput = fInput_prefix+"_"+event_runinfo+".root";
+  }
   mf::LogInfo("WireCellPF") <<"INPUT FILE NAME: "<< fInput <<"\n";
-  std::ifstream fcheck(fInput.c_str());
-  if(!fcheck.good()) {
-	mf::LogInfo("WireCellPF") <<"INPUT FILE NOT FOUND!"<<std::endl;
+  // the merged file is opened once, a per-event file replaces the previous one
+  if(!(merged ? fReader.OpenMergedFile(fInput) : fReader.OpenEventFile(fInput))) {
+	mf::LogInfo("WireCellPF") <<"INPUT FILE NOT FOUND OR CANNOT OPEN: "<< fInput <<"\n";
 	badinput = true;
   }
-  else{
-	fin = new TFile(fInput.c_str());
-	if(fin->IsZombie()){
-	  mf::LogError("WireCellPF") <<"INPUT FILE CANNOT OPEN: "<< fInput <<"\n";
-	  badinput = true;
-	}
-  }
 
 if(f_PFport){
   auto outputPF = std::make_unique< std::vector<simb::MCParticle> >();
@@ -133,19 +139,21 @@ if(f_PFport){
   // 5th bit: long muon
   // 6th bit: nue CC
   Int_t neutrino_type = 0;
-  TTree *tree2 = (TTree*)fin->Get(fInput_tree2.c_str());
+  TTree *tree2 = fReader.GetTree(fInput_tree2);
   if(tree2) {
   tree2->SetBranchStatus("*", 0);
   tree2->SetBranchStatus("neutrino_type", 1);
   tree2->SetBranchAddress("neutrino_type",&neutrino_type);
-    for(int i=0; i<tree2->GetEntries(); i++){
+    for(auto const& i : fReader.Entries(fInput_tree2, run, subrun, event)){
 	tree2->GetEntry(i);
 	if(neutrino_type>1) break; // this should be the in-beam flash match
     }
+  tree2->ResetBranchAddresses();
   }
 
-  TTree *tree = (TTree*)fin->Get(fInput_tree.c_str());
-  if(tree) {
+  TTree *tree = fReader.GetTree(fInput_tree);
+  Long64_t entry = fReader.FirstEntry(fInput_tree, run, subrun, event);
+  if(tree && entry>=0) {
   /// Wire-Cell Particle Flow
   int mc_Ntrack;  // number of tracks in MC
   int mc_id[MAX_TRACKS];  // track id; size == mc_Ntrack
@@ -172,7 +180,7 @@ if(f_PFport){
   tree->SetBranchAddress("mc_startMomentum", &mc_startMomentum); // unit: GeV
   tree->SetBranchAddress("mc_endMomentum"  , &mc_endMomentum);   // unit: GeV
   //std::cout<<"Check point 0.2: "<<std::endl;
-  tree->GetEntry(0); // one file one event (entry)
+  tree->GetEntry(entry); // one file one event (entry)
   //std::cout<<"Check point 0.3: "<<std::endl;
 
   for(int i=0; i<mc_Ntrack; i++){
@@ -201,9 +209,10 @@ if(f_PFport){
 
   NumberOfPF++;
 
+  tree->ResetBranchAddresses();
   }
   else {
-    mf::LogError("WireCellPF") <<"TTree "<< fInput_tree <<" not found in file " << fInput <<"\n";
+    mf::LogError("WireCellPF") <<"TTree "<< fInput_tree <<" (or this event) not found in file " << fInput <<"\n";
   }
 
   e.put(std::move(outputPF));
@@ -219,8 +228,9 @@ if(f_BDTport){
   else{
   nsm::NuSelectionBDT nsmbdt;
 
-  TTree *tree3 = (TTree*)fin->Get(fInput_tree3.c_str());
-  if(tree3){
+  TTree *tree3 = fReader.GetTree(fInput_tree3);
+  Long64_t entry = fReader.FirstEntry(fInput_tree3, run, subrun, event);
+  if(tree3 && entry>=0){
 
   /// define variables and set branch address
 
@@ -1942,7 +1952,8 @@ if(f_BDTport){
 
 
   /// Read and assign values
-  tree3->GetEntry(0); // rare case: multiple in-beam matched activity
+  tree3->GetEntry(entry); // rare case: multiple in-beam matched activity
+  tree3->ResetBranchAddresses();
 
   nsm::NuSelectionBDT::SPID _SPID_init = {
           shw_sp_num_mip_tracks,
@@ -2902,7 +2913,7 @@ if(f_BDTport){
 
   }
   else {
-    mf::LogError("WireCellPF") <<"TTree "<< fInput_tree3 <<" not found in file " << fInput <<"\n";
+    mf::LogError("WireCellPF") <<"TTree "<< fInput_tree3 <<" (or this event) not found in file " << fInput <<"\n";
   }
 
   e.put(std::move(outputBDTvars));
@@ -2919,8 +2930,9 @@ if(f_KINEport){
   else{
   nsm::NuSelectionKINE nsmkine;
 
-  TTree *tree4 = (TTree*)fin->Get(fInput_tree4.c_str());
-  if(tree4){
+  TTree *tree4 = fReader.GetTree(fInput_tree4);
+  Long64_t entry = fReader.FirstEntry(fInput_tree4, run, subrun, event);
+  if(tree4 && entry>=0){
 
 	  float kine_reco_Enu; // kinetic energy  + additional energy ...
 	  float kine_reco_add_energy;  // mass, binding energy ...
@@ -2961,7 +2973,8 @@ if(f_KINEport){
 	  tree4->SetBranchAddress("kine_pio_angle", &kine_pio_angle);
 
 	  //read and port
-  	  tree4->GetEntry(0);
+  	  tree4->GetEntry(entry);
+	  tree4->ResetBranchAddresses();
 	  nsm::NuSelectionKINE::KineInfo _KineInfo_init = {
 		  kine_reco_Enu,
 		  kine_reco_add_energy,
@@ -2988,7 +3001,7 @@ if(f_KINEport){
 
   }
   else{
-    mf::LogError("WireCellPF") <<"TTree "<< fInput_tree4 <<" not found in file " << fInput <<"\n";
+    mf::LogError("WireCellPF") <<"TTree "<< fInput_tree4 <<" (or this event) not found in file " << fInput <<"\n";
   }
 
   e.put(std::move(outputKINEvars));
@@ -2997,7 +3010,6 @@ if(f_KINEport){
 }
 
 
-  if(fin) fin->Close();
   return;
 
 }
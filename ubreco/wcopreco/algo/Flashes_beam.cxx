@@ -6,10 +6,11 @@ namespace wcopreco {
                                         std::vector<double> *mult_v,
                                         std::vector<double> *l1_totPE_v,
                                         std::vector<double> *l1_mult_v,
-                                        std::vector< std::vector<double> > decon_vv,
+                                        const std::vector< std::vector<double> > &decon_vv,
                                         double beam_start_time,
                                         const Config_FlashesBeam &configFB,
-                                        const Config_Opflash &configOpF)
+                                        const Config_Opflash &configOpF,
+                                        OpflashArena *arena)
     : _cfgOpF(configOpF) ,  _cfgFB(configFB)
   {
     //Module for flash finding for beams
@@ -89,7 +90,8 @@ namespace wcopreco {
       //check with the next bin content ...
       //create Opflash
 
-      Opflash *flash = new Opflash(decon_vv, beam_start_time, start_bin, end_bin, _cfgOpF);
+      Opflash *flash = arena ? arena->make_beam(decon_vv, beam_start_time, start_bin, end_bin, _cfgOpF)
+                             : new Opflash(decon_vv, beam_start_time, start_bin, end_bin, _cfgOpF);
       for (size_t p=0; p< l1_totPE_v->size(); p++){
       }
       flash->Add_l1info(l1_totPE_v, l1_mult_v, beam_start_time, start_bin, end_bin, _cfgOpF);
@@ -6,6 +6,7 @@
 #include "OpWaveformCollection.h"
 #include "EventOpWaveforms.h"
 #include "Opflash.h"
+#include "OpflashArena.h"
 #include "HitFinder_beam.h"
 
 #include "Config_Opflash.h"
@@ -23,10 +24,11 @@ namespace wcopreco{
                 std::vector<double> *mult_v,
                 std::vector<double> *l1_totPE_v,
                 std::vector<double> *l1_mult_v,
-                std::vector< std::vector<double> > decon_vv,
+                const std::vector< std::vector<double> > &decon_vv,
                 double beam_start_time,
                 const Config_FlashesBeam &configFB,
-                const Config_Opflash &configOpF
+                const Config_Opflash &configOpF,
+                OpflashArena *arena = nullptr //flashes are new'd and owned by the caller without arena
               );
     ~Flashes_beam() {};
 
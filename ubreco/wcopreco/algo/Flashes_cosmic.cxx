@@ -2,7 +2,7 @@
 
 namespace wcopreco {
 
-  wcopreco::Flashes_cosmic::Flashes_cosmic(std::vector<COphitSelection> *ophits_group,  const Config_Opflash &configOpF)
+  wcopreco::Flashes_cosmic::Flashes_cosmic(std::vector<COphitSelection> *ophits_group,  const Config_Opflash &configOpF, OpflashArena *arena)
     : _cfgOpF(configOpF)
   {
     //Module for flash finding for cosmics
@@ -11,13 +11,14 @@ namespace wcopreco {
     int count_deleted=0;
 
     for (size_t j=0; j!=ophits_group->size();j++){
-      Opflash *flash = new Opflash(ophits_group->at(j), _cfgOpF);
+      Opflash *flash = arena ? arena->make_cosmic(ophits_group->at(j), _cfgOpF) : new Opflash(ophits_group->at(j), _cfgOpF);
       if (flash->get_total_PE()!=0){
         count++;
         cosmic_flashes.push_back(flash);
       }
       else{
-        delete flash;
+        if (arena) arena->release_last();
+        else delete flash;
         count_deleted++;
 
       }
@@ -6,6 +6,7 @@
 #include "OpWaveformCollection.h"
 #include "EventOpWaveforms.h"
 #include "Opflash.h"
+#include "OpflashArena.h"
 #include "HitFinder_cosmic.h"
 
 #include "Config_Opflash.h"
@@ -16,7 +17,8 @@ namespace wcopreco{
 
   class Flashes_cosmic {
   public:
-    Flashes_cosmic(std::vector<COphitSelection> *ophits_group, const Config_Opflash &configOpF);
+    //flashes come from the arena if one is given, otherwise they are new'd and owned by the caller
+    Flashes_cosmic(std::vector<COphitSelection> *ophits_group, const Config_Opflash &configOpF, OpflashArena *arena = nullptr);
     ~Flashes_cosmic() {};
 
     OpflashSelection get_cosmic_flashes(){return cosmic_flashes;};
@@ -1,17 +1,16 @@
 #include "HitFinder_beam.h"
+#include "ubreco/Utilities/ParallelFor.h"
 
 namespace wcopreco {
 
-  wcopreco::HitFinder_beam::HitFinder_beam(OpWaveformCollection &deconvolved_beam, std::vector<kernel_fourier_container> &kernel_container_v, const Config_Hitfinder_Beam &cfg_HB, const Config_Deconvolver &cfg_DC)
+  wcopreco::HitFinder_beam::HitFinder_beam(OpWaveformCollection &deconvolved_beam, std::vector<kernel_fourier_container> &kernel_container_v, const Config_Hitfinder_Beam &cfg_HB, const Config_Deconvolver &cfg_DC,
+                                           fft_engine *fft, kernel_fourier_cache *kernel_cache)
   :_cfg(cfg_HB)
+  ,l1_warm_total(0)
   {
-    
-    //main function for beam hit finder
-    //perform deconvolution with kernals add and with filters (true,true)
-    wcopreco::Deconvolver filtered_wfm(deconvolved_beam, true, kernel_container_v, cfg_DC);
-
-    OpWaveformCollection filtered_collection = filtered_wfm.Deconvolve_Collection(deconvolved_beam);
-    filtered_collection.set_op_gain(deconvolved_beam.get_op_gain());//set the gains back
+    //warm starts chain the channels, so they are only used when running serially
+    int nthreads = std::min(_cfg._num_threads, _cfg._num_channels);
+    _warm_start = _cfg._l1_warm_start && nthreads <= 1;
 
     totPE_v.resize(_cfg._nbins_beam/_cfg._rebin_frac);
     mult_v.resize(_cfg._nbins_beam/_cfg._rebin_frac);
@@ -19,6 +18,18 @@ namespace wcopreco {
     l1_mult_v.resize(_cfg._nbins_beam/_cfg._rebin_frac);
     decon_vv.resize(_cfg._num_channels);
 
+    if (nthreads > 1){
+      Run_Parallel(deconvolved_beam, kernel_container_v, cfg_DC, fft, kernel_cache, nthreads);
+      return;
+    }
+
+    //main function for beam hit finder
+    //perform deconvolution with kernals add and with filters (true,true)
+    wcopreco::Deconvolver filtered_wfm(deconvolved_beam, true, kernel_container_v, cfg_DC, fft, kernel_cache);
+
+    OpWaveformCollection filtered_collection = filtered_wfm.Deconvolve_Collection(deconvolved_beam);
+    filtered_collection.set_op_gain(deconvolved_beam.get_op_gain());//set the gains back
+
     //loop through each channel and perform the l1 fit
     for (int ch=0; ch<_cfg._num_channels; ch++){
       float chgain = filtered_collection.get_op_gain().at(ch);
@@ -35,7 +46,57 @@ namespace wcopreco {
     }
   }
 
-  void HitFinder_beam::Perform_L1(std::vector<double> inverse_res1,
+  void HitFinder_beam::Run_Parallel(OpWaveformCollection &deconvolved_beam, std::vector<kernel_fourier_container> &kernel_container_v, const Config_Deconvolver &cfg_DC,
+                                    fft_engine *fft, kernel_fourier_cache *kernel_cache, int nthreads)
+  {
+    int nch = _cfg._num_channels;
+    int nrebin = _cfg._nbins_beam/_cfg._rebin_frac;
+
+    //each channel fills its own contribution, they are summed in channel order afterwards
+    //so that the result is the same as the serial loop whatever the scheduling
+    std::vector< std::vector<double> > totPE_c(nch, std::vector<double>(nrebin,0));
+    std::vector< std::vector<double> > mult_c(nch, std::vector<double>(nrebin,0));
+    std::vector< std::vector<double> > l1_totPE_c(nch, std::vector<double>(nrebin,0));
+    std::vector< std::vector<double> > l1_mult_c(nch, std::vector<double>(nrebin,0));
+    std::vector<float> gain_v = deconvolved_beam.get_op_gain();
+
+    if (kernel_cache) kernel_cache->reserve_channels(kernel_container_v.size());
+
+    ubutil::RunWorkers(nthreads, [&](size_t w){
+        //one Deconvolver (scratch space) and one fft slot per worker
+        wcopreco::Deconvolver filtered_wfm(deconvolved_beam, true, kernel_container_v, cfg_DC, fft, kernel_cache);
+        filtered_wfm.set_fft_slot(w);
+        //each worker takes one contiguous block of channels; in batched mode the
+        //whole block is deconvolved at once, as the serial path does for all channels
+        int ch_begin = (int)w*nch/nthreads;
+        int ch_end = ((int)w+1)*nch/nthreads;
+        std::vector<OpWaveform> block_wfms;
+        bool block = cfg_DC._batched && filtered_wfm.Deconvolve_Block(deconvolved_beam, ch_begin, ch_end, block_wfms);
+        for (int ch=ch_begin; ch<ch_end; ch++){
+          OpWaveform filtered = block ? std::move(block_wfms.at(ch-ch_begin)) : filtered_wfm.Deconvolve_Channel(deconvolved_beam, ch);
+          decon_vv.at(ch).reserve(300);
+          Perform_L1( filtered,
+                      decon_vv,
+                      totPE_c.at(ch),
+                      mult_c.at(ch),
+                      l1_totPE_c.at(ch),
+                      l1_mult_c.at(ch),
+                      ch,
+                      gain_v.at(ch));
+        }
+      });
+
+    for (int ch=0; ch<nch; ch++){
+      for (int j=0; j<nrebin; j++){
+        totPE_v.at(j) = totPE_v.at(j) + totPE_c[ch][j];
+        mult_v.at(j) = mult_v.at(j) + mult_c[ch][j];
+        l1_totPE_v.at(j) = l1_totPE_v.at(j) + l1_totPE_c[ch][j];
+        l1_mult_v.at(j) = l1_mult_v.at(j) + l1_mult_c[ch][j];
+      }
+    }
+  }
+
+  void HitFinder_beam::Perform_L1(const std::vector<double> &inverse_res1,
 				  std::vector< std::vector<double> > &decon_vv,
 				  std::vector<double> &totPE_v,
 				  std::vector<double> &mult_v,
@@ -82,29 +143,60 @@ namespace wcopreco {
     }
 
     int nbin_fit = vals_x.size();
-    Eigen::VectorXd W = Eigen::VectorXd::Zero(nbin_fit);
-    Eigen::MatrixXd G = Eigen::MatrixXd::Zero(nbin_fit,nbin_fit);
-    for (int i=0;i!=nbin_fit;i++){
-        W(i) = vals_y.at(i) / sqrt(vals_y.at(i));
-        double t1 = vals_x.at(i); // measured time
-        for (int k=0;k!=nbin_fit;k++){
-           double t2 = vals_x.at(k); // real time
-           if (t1>t2) {
-               G(i,k) = (_cfg._frac_G_t2_first * (exp(-((t1-t2)*_cfg._G_p0*_cfg._tick_width_us-_cfg._G_p1*_cfg._tick_width_us)/_cfg._G_p2)-exp(-((t1-t2)*_cfg._G_p0*_cfg._tick_width_us+3*_cfg._tick_width_us)/_cfg._G_p2))) / sqrt(vals_y.at(i));
-           }
-            else if (t1==t2){
-               G(i,k) = (_cfg._frac_G_sametime + _cfg._frac_G_t2_first *(1-exp(-_cfg._G_p1*_cfg._tick_width_us/_cfg._G_p2))) / sqrt(vals_y.at(i));
-           }
-            else{
-               continue;
-           }
-        }
+    Eigen::VectorXd beta;
+    if (_cfg._l1_exp_solver){
+      // same fit as below, but using the exponential structure of G instead of building it
+      double tw = _cfg._tick_width_us;
+      double same = _cfg._frac_G_sametime + _cfg._frac_G_t2_first *(1-exp(-_cfg._G_p1*tw/_cfg._G_p2));
+      double amp = _cfg._frac_G_t2_first * (exp(_cfg._G_p1*tw/_cfg._G_p2) - exp(-3*tw/_cfg._G_p2));
+      double slope = _cfg._G_p0*tw/_cfg._G_p2;
+
+      wcopreco::ExpKernelLassoModel m2(_cfg._Lasso_p0, _cfg._Lasso_p1, _cfg._Lasso_p2);
+      m2.SetKernel(same, amp, slope);
+      m2.SetData(vals_x, vals_y);
+
+      double total = 0;
+      for (int i=0;i!=nbin_fit;i++) total += vals_y.at(i);
+      if (_warm_start && l1_warm_total>0){
+        // start from the previous channel's solution scaled to this channel's light
+        std::vector<double> init(nbin_fit);
+        for (int i=0;i!=nbin_fit;i++) init.at(i) = l1_warm_v.at(vals_bin.at(i)) * total/l1_warm_total;
+        m2.Set_init_values(init);
+      }
+      m2.Fit();
+      beta = m2.Getbeta();
+
+      if (_warm_start){
+        l1_warm_v.assign(_cfg._nbins_beam/_cfg._rebin_frac, 0);
+        for (int i=0;i!=nbin_fit;i++) l1_warm_v.at(vals_bin.at(i)) = beta(i);
+        l1_warm_total = total;
+      }
     }
+    else{
+      Eigen::VectorXd W = Eigen::VectorXd::Zero(nbin_fit);
+      Eigen::MatrixXd G = Eigen::MatrixXd::Zero(nbin_fit,nbin_fit);
+      for (int i=0;i!=nbin_fit;i++){
+          W(i) = vals_y.at(i) / sqrt(vals_y.at(i));
+          double t1 = vals_x.at(i); // measured time
+          for (int k=0;k!=nbin_fit;k++){
+             double t2 = vals_x.at(k); // real time
+             if (t1>t2) {
+                 G(i,k) = (_cfg._frac_G_t2_first * (exp(-((t1-t2)*_cfg._G_p0*_cfg._tick_width_us-_cfg._G_p1*_cfg._tick_width_us)/_cfg._G_p2)-exp(-((t1-t2)*_cfg._G_p0*_cfg._tick_width_us+3*_cfg._tick_width_us)/_cfg._G_p2))) / sqrt(vals_y.at(i));
+             }
+              else if (t1==t2){
+                 G(i,k) = (_cfg._frac_G_sametime + _cfg._frac_G_t2_first *(1-exp(-_cfg._G_p1*_cfg._tick_width_us/_cfg._G_p2))) / sqrt(vals_y.at(i));
+             }
+              else{
+                 continue;
+             }
+          }
+      }
 
-    wcopreco::LassoModel m2(_cfg._Lasso_p0, _cfg._Lasso_p1, _cfg._Lasso_p2);
-    m2.SetData(G, W);
-    m2.Fit();
-    Eigen::VectorXd beta = m2.Getbeta();
+      wcopreco::LassoModel m2(_cfg._Lasso_p0, _cfg._Lasso_p1, _cfg._Lasso_p2);
+      m2.SetData(G, W);
+      m2.Fit();
+      beta = m2.Getbeta();
+    }
 
     //Make vector to hold L1 fit values
     std::vector<double> l1_v;
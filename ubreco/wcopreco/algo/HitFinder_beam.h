@@ -7,6 +7,7 @@
 #include "EventOpWaveforms.h"
 #include "Opflash.h"
 #include "LassoModel.h"
+#include "ExpKernelLassoModel.h"
 #include "ElasticNetModel.h"
 #include "LinearModel.h"
 #include "OpWaveformCollection.h"
@@ -21,6 +22,7 @@
 #include <cmath>
 #include <string>
 #include <Eigen/Dense>
+#include <algorithm>
 
 //root
 #include "TMath.h"
@@ -31,10 +33,11 @@ namespace wcopreco{
 
   class HitFinder_beam {
   public:
-    HitFinder_beam(OpWaveformCollection &deconvolved_beam, std::vector<kernel_fourier_container> &kernel_container_v, const Config_Hitfinder_Beam &cfg_HB, const Config_Deconvolver &cfg_DC);
+    HitFinder_beam(OpWaveformCollection &deconvolved_beam, std::vector<kernel_fourier_container> &kernel_container_v, const Config_Hitfinder_Beam &cfg_HB, const Config_Deconvolver &cfg_DC,
+                   fft_engine *fft = nullptr, kernel_fourier_cache *kernel_cache = nullptr);
     ~HitFinder_beam() {};
 
-    void Perform_L1(std::vector<double> inverse_res1,
+    void Perform_L1(const std::vector<double> &inverse_res1,
 		    std::vector< std::vector<double> > &decon_vv,
 		    std::vector<double> &totPE_v,
 		    std::vector<double> &mult_v,
@@ -44,6 +47,11 @@ namespace wcopreco{
 		    float gain
 		    );
 
+     // deconvolution and L1 fits spread over nthreads workers (Config_Hitfinder_Beam::_num_threads),
+     // each handling a block of channels (deconvolved as one block if Config_Deconvolver::_batched)
+     void Run_Parallel(OpWaveformCollection &deconvolved_beam, std::vector<kernel_fourier_container> &kernel_container_v, const Config_Deconvolver &cfg_DC,
+                       fft_engine *fft, kernel_fourier_cache *kernel_cache, int nthreads);
+
      std::vector<double> get_totPE_v(){return totPE_v;}
      std::vector<double> get_mult_v(){return mult_v;}
      std::vector<double> get_l1_totPE_v(){return l1_totPE_v;}
@@ -60,6 +68,10 @@ namespace wcopreco{
     std::vector<double> l1_mult_v;
     std::vector< std::vector<double> > decon_vv;
 
+    //last L1 solution (per rebinned bin) and its total light, used to warm start the next channel
+    std::vector<double> l1_warm_v;
+    double l1_warm_total;
+    bool _warm_start;
 
   };
 
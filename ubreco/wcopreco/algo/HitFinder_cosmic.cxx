@@ -13,7 +13,7 @@ namespace wcopreco {
     //Much of this code can be left the way it is in WC
       int count =0;
       for (size_t i=0; i!=merged_cosmic->size(); i++){
-        OpWaveform wfm_cosmic = merged_cosmic->at(i);
+        OpWaveform &wfm_cosmic = merged_cosmic->at(i);
         int channel = wfm_cosmic.get_ChannelNum();
         double timestamp = wfm_cosmic.get_time_from_trigger();
         COphit *op_hit = new COphit(channel, &wfm_cosmic, timestamp, op_gain->at(channel), op_gainerror->at(channel), _cfgCOpH);
@@ -3,24 +3,31 @@
 
 namespace wcopreco {
 
-  Saturation_Merger::Saturation_Merger(UBEventWaveform UB_Ev, const Config_Saturation_Merger &cfg)
-  :_cfg(cfg) {
+  Saturation_Merger::Saturation_Merger(const UBEventWaveform &UB_Ev, const Config_Saturation_Merger &cfg)
+  :_cfg(cfg), op_gain(UB_Ev.get_op_gain()), op_gainerror(UB_Ev.get_op_gainerror()) {
 
-    OpWaveformCollection BHG_WFs;
-    OpWaveformCollection BLG_WFs;
-    OpWaveformCollection CHG_WFs;
-    OpWaveformCollection CLG_WFs;
+    auto const& wfm_v = UB_Ev.get_wfm_v();
+    merge(wfm_v[kbeam_hg], wfm_v[kbeam_lg], wfm_v[kcosmic_hg], wfm_v[kcosmic_lg]);
 
-    BHG_WFs = (UB_Ev.get_wfm_v() [kbeam_hg]);
-    BLG_WFs = (UB_Ev.get_wfm_v() [kbeam_lg]);
-    CHG_WFs = (UB_Ev.get_wfm_v() [kcosmic_hg]);
-    CLG_WFs = (UB_Ev.get_wfm_v() [kcosmic_lg]);
+  }//End of Class Constructor
+
+  Saturation_Merger::Saturation_Merger(UBEventWaveform &&UB_Ev, const Config_Saturation_Merger &cfg)
+  :_cfg(cfg), op_gain(UB_Ev.get_op_gain()), op_gainerror(UB_Ev.get_op_gainerror()) {
+
+    auto &wfm_v = UB_Ev.get_wfm_v();
+    merge(std::move(wfm_v[kbeam_hg]), std::move(wfm_v[kbeam_lg]),
+	  std::move(wfm_v[kcosmic_hg]), std::move(wfm_v[kcosmic_lg]));
+
+  }//End of Class Constructor
+
+  void Saturation_Merger::merge(OpWaveformCollection BHG_WFs, OpWaveformCollection BLG_WFs,
+				OpWaveformCollection CHG_WFs, OpWaveformCollection CLG_WFs){
 
     scale_lowgains(&BLG_WFs,&CLG_WFs);
 
     //Set data member merged versions of waveforms
-    merged_beam = *beam_merger(&BHG_WFs, &BLG_WFs);
-    merged_cosmic = *cosmic_merger(&CHG_WFs, &CLG_WFs);
+    merged_beam = std::move(*beam_merger(&BHG_WFs, &BLG_WFs));
+    merged_cosmic = std::move(*cosmic_merger(&CHG_WFs, &CLG_WFs));
 
     //Make all the individual waveforms the new type (merged beam or merged cosmic (5 and 6))
     for (size_t n = 0; n< merged_beam.size(); n++){
@@ -30,13 +37,17 @@ namespace wcopreco {
       merged_cosmic.at(n).set_type(kcosmic_merged);
     }
 
+  }//End of Function
 
+  //The merged event waveform is only built on request, it copies both merged collections
+  UBEventWaveform Saturation_Merger::get_merged_UB_Ev(){
+    UBEventWaveform UB_Ev_Merged;
     UB_Ev_Merged.add_entry(merged_beam,   kbeam_merged );
     UB_Ev_Merged.add_entry(merged_cosmic, kcosmic_merged );
-    UB_Ev_Merged.set_op_gain(   UB_Ev.get_op_gain()   );
-    UB_Ev_Merged.set_op_gainerror( UB_Ev.get_op_gainerror()   );
-
-  }//End of Class Constructor
+    UB_Ev_Merged.set_op_gain(   op_gain   );
+    UB_Ev_Merged.set_op_gainerror( op_gainerror   );
+    return UB_Ev_Merged;
+  }
 
   void Saturation_Merger::scale_lowgains(OpWaveformCollection *BLG_WFs, OpWaveformCollection *CLG_WFs){
       //First lets do the Beam Low Gain Waveform Rescaling
@@ -86,16 +97,15 @@ namespace wcopreco {
   }//End of Function
 
   double wcopreco::Saturation_Merger::findBaselineLg(OpWaveform *wfm, int nbin){
-    TH1F *h = new TH1F("h","",1000,_cfg._low_bound_baseline_search-0.5,_cfg._high_bound_baseline_search-0.5);
+    FixedBinHistogram<1000> h(_cfg._low_bound_baseline_search-0.5,_cfg._high_bound_baseline_search-0.5);
     double baseline=0;
     for(int i=0; i!=_cfg._nbins_baseline_search; i++){
       double content = wfm->at(i);
       //    baseline += content;
-      if(content>_cfg._low_bound_baseline_search && content<_cfg._high_bound_baseline_search){ h->Fill(content); }
+      if(content>_cfg._low_bound_baseline_search && content<_cfg._high_bound_baseline_search){ h.Fill(content); }
     }
     //  baseline /= 6.;
-    baseline = h->GetBinCenter(h->GetMaximumBin()+1);
-    delete h;
+    baseline = h.GetBinCenter(h.GetMaximumBin()+1);
     return baseline;
   }//End of Function
 
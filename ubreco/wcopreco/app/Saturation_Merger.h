@@ -4,6 +4,7 @@
 #include "DataReader.h"
 #include "UBEventWaveform.h"
 #include "Config_Saturation_Merger.h"
+#include "FixedBinHistogram.h"
 namespace wcopreco{
 
   // This class is microboone specific. It is designed to merge the high and
@@ -11,18 +12,23 @@ namespace wcopreco{
   // merged_cosmic OpWaveformCollection datamembers, replacing the high gain
   // waveform regions that get saturated if there is a low gain corresponding
   // to it.
+  // The unmerged collections are modified while merging: they are copied from
+  // a const event waveform, or taken over when the event waveform is an rvalue.
   class Saturation_Merger {
   public:
-    Saturation_Merger(UBEventWaveform, const Config_Saturation_Merger &);
+    Saturation_Merger(const UBEventWaveform &, const Config_Saturation_Merger &);
+    Saturation_Merger(UBEventWaveform &&, const Config_Saturation_Merger &);
     ~Saturation_Merger() {};
 
-    OpWaveformCollection get_merged_beam() {return merged_beam;}
-    OpWaveformCollection get_merged_cosmic() {return merged_cosmic;}
-    UBEventWaveform get_merged_UB_Ev() {return UB_Ev_Merged;}
+    OpWaveformCollection& get_merged_beam() {return merged_beam;}
+    OpWaveformCollection& get_merged_cosmic() {return merged_cosmic;}
+    UBEventWaveform get_merged_UB_Ev();
 
 
   protected:
     Config_Saturation_Merger _cfg;
+    void merge(OpWaveformCollection BHG_WFs, OpWaveformCollection BLG_WFs,
+	       OpWaveformCollection CHG_WFs, OpWaveformCollection CLG_WFs);
     float findScaling(size_t channel);
     void scale_lowgains(OpWaveformCollection *BLG, OpWaveformCollection *CLG);
     double findBaselineLg(OpWaveform *wfm, int nbin);
@@ -39,7 +45,8 @@ namespace wcopreco{
     //second argument. A third optional argument allows for customized saturation threshold
     OpWaveformCollection merged_cosmic;
     OpWaveformCollection merged_beam;
-    UBEventWaveform UB_Ev_Merged;
+    std::vector<float> op_gain;
+    std::vector<float> op_gainerror;
 
 
   };
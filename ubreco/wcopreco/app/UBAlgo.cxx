@@ -1,4 +1,5 @@
 #include "UBAlgo.h"
+#include "ubreco/Utilities/ParallelFor.h"
 
 namespace wcopreco{
 
@@ -7,29 +8,61 @@ namespace wcopreco{
   {}
 
   void UBAlgo::Configure(const Config_Params &cfg_all){
+    Config_UB_rc old_rc = _cfg._get_cfg_ub_rc();
+    Config_UB_spe old_spe = _cfg._get_cfg_ub_spe();
     _cfg = cfg_all;
+    //the cached kernel spectra follow the kernel shape parameters; gains and
+    //binning are checked by the cache itself. Reconfiguring with the same
+    //kernels keeps them
+    Config_UB_rc rc = _cfg._get_cfg_ub_rc();
+    Config_UB_spe spe = _cfg._get_cfg_ub_spe();
+    if (rc._rc_tau_badch != old_rc._rc_tau_badch || rc._rc_tau_goodch != old_rc._rc_tau_goodch ||
+	spe._spe_p0 != old_spe._spe_p0 || spe._spe_p1 != old_spe._spe_p1)
+      _kernel_cache.invalidate();
   }
 
   void UBAlgo::SaturationCorrection(UBEventWaveform *_UB_Ev_wfm){
     //create the merger
     wcopreco::Saturation_Merger merger(*_UB_Ev_wfm , _cfg._get_cfg_saturation_merger());
-    merged_beam = merger.get_merged_beam();
-    merged_cosmic = merger.get_merged_cosmic();
+    merged_beam = std::move(merger.get_merged_beam());
+    merged_cosmic = std::move(merger.get_merged_cosmic());
     //wcopreco::UBEventWaveform UB_Ev_Merged = merger.get_merged_UB_Ev();
 
   }
-  void UBAlgo::set_merged_beam(OpWaveformCollection &ext_merged_beam){
-    merged_beam = ext_merged_beam;
+  void UBAlgo::SaturationCorrection(UBEventWaveform &&_UB_Ev_wfm){
+    wcopreco::Saturation_Merger merger(std::move(_UB_Ev_wfm), _cfg._get_cfg_saturation_merger());
+    merged_beam = std::move(merger.get_merged_beam());
+    merged_cosmic = std::move(merger.get_merged_cosmic());
   }
-  void UBAlgo::set_merged_cosmic(OpWaveformCollection &ext_merged_cosmic){
-    merged_cosmic = ext_merged_cosmic;
+  void UBAlgo::set_merged_beam(OpWaveformCollection ext_merged_beam){
+    merged_beam = std::move(ext_merged_beam);
+  }
+  void UBAlgo::set_merged_cosmic(OpWaveformCollection ext_merged_cosmic){
+    merged_cosmic = std::move(ext_merged_cosmic);
   }
   void UBAlgo::Run(std::vector<float> * op_gain,
 		   std::vector<float> * op_gainerror,
 		   std::vector<wcopreco::kernel_fourier_container> * kernel_container_v){
 
+    //the cosmic branch does not depend on the beam one, run it alongside when threads are allowed.
+    //worker 0 (beam) runs on this thread; both are done before any error is rethrown
+    bool concurrent = _cfg._get_cfg_hitfinder_beam()._get_num_threads() > 1;
+    ubutil::RunWorkers(concurrent ? 2 : 1, [&](size_t w){
+	if (w) Run_Cosmic(op_gain, op_gainerror);
+	else Run_Beam(kernel_container_v);
+      });
+    if (!concurrent) Run_Cosmic(op_gain, op_gainerror);
+    
+    //flash filtering
+    wcopreco::FlashFiltering flashesfiltered(&flashes_cosmic, &flashes_beam, _cfg._get_cfg_flashfiltering());
+    flashes = flashesfiltered.get_flashes();
+    
+  }
+
+  void UBAlgo::Run_Beam(std::vector<wcopreco::kernel_fourier_container> * kernel_container_v){
     //do beam hitfinding
-    wcopreco::HitFinder_beam hits_found_beam(merged_beam, *kernel_container_v, _cfg._get_cfg_hitfinder_beam(), _cfg._get_cfg_deconvolver());
+    wcopreco::HitFinder_beam hits_found_beam(merged_beam, *kernel_container_v, _cfg._get_cfg_hitfinder_beam(), _cfg._get_cfg_deconvolver(),
+					     &_fft_engine, &_kernel_cache);
     
     // do beam flash finding
     std::vector<double> totPE_v = hits_found_beam.get_totPE_v();
@@ -46,10 +79,14 @@ namespace wcopreco{
 					     decon_vv,
 					     beam_start_time,
 					     _cfg._get_cfg_flashesbeam(),
-					     _cfg._get_cfg_opflash());
+					     _cfg._get_cfg_opflash(),
+					     &_beam_flash_arena);
     
     flashes_beam = flashfinder_beam.get_beam_flashes();
-    
+  }
+
+  void UBAlgo::Run_Cosmic(std::vector<float> * op_gain,
+			  std::vector<float> * op_gainerror){
     // cosmics hitfinding
     wcopreco::HitFinder_cosmic hits_found(&merged_cosmic,
 					  op_gain,
@@ -59,24 +96,14 @@ namespace wcopreco{
     
     //flashes for cosmics
     std::vector<COphitSelection>  hits = hits_found.get_ophits_group();
-    wcopreco::Flashes_cosmic flashfinder_cosmic(&hits, _cfg._get_cfg_opflash());
+    wcopreco::Flashes_cosmic flashfinder_cosmic(&hits, _cfg._get_cfg_opflash(), &_cosmic_flash_arena);
     flashes_cosmic = flashfinder_cosmic.get_cosmic_flashes();
     hits_found.clear_ophits();
-    
-    //flash filtering
-    wcopreco::FlashFiltering flashesfiltered(&flashes_cosmic, &flashes_beam, _cfg._get_cfg_flashfiltering());
-    flashes = flashesfiltered.get_flashes();
-    
   }
   
   
   wcopreco::UBAlgo::~UBAlgo(){
-    for (auto it = flashes_beam.begin(); it!=flashes_beam.end(); it++){
-      delete (*it);
-    }
-    for (auto it=flashes_cosmic.begin(); it!= flashes_cosmic.end(); it++){
-      delete (*it);
-    }
+    //the flashes are owned by the arenas
     flashes_beam.clear();
     flashes_cosmic.clear();
     flashes.clear();
@@ -84,12 +111,9 @@ namespace wcopreco{
   }
 
   void wcopreco::UBAlgo::clear_flashes(){
-    for (auto it = flashes_beam.begin(); it!=flashes_beam.end(); it++){
-      delete (*it);
-    }
-    for (auto it=flashes_cosmic.begin(); it!= flashes_cosmic.end(); it++){
-      delete (*it);
-    }
+    //the flash objects stay in the arenas and are refilled by the next event
+    _beam_flash_arena.reset();
+    _cosmic_flash_arena.reset();
     flashes_beam.clear();
     flashes_cosmic.clear();
     flashes.clear();
@@ -47,8 +47,10 @@ namespace wcopreco  {
 
     void Configure(const Config_Params &cfg_all);
     void SaturationCorrection(UBEventWaveform *_UB_Ev_wfm);
-    void set_merged_beam(OpWaveformCollection &ext_merged_beam);
-    void set_merged_cosmic(OpWaveformCollection &ext_merged_cosmic);
+    //same, taking over the waveforms of the event instead of copying them
+    void SaturationCorrection(UBEventWaveform &&_UB_Ev_wfm);
+    void set_merged_beam(OpWaveformCollection ext_merged_beam);
+    void set_merged_cosmic(OpWaveformCollection ext_merged_cosmic);
     void Run(std::vector<float> * op_gain,
 	     std::vector<float> * op_gainerror,
 	     std::vector<wcopreco::kernel_fourier_container> * kernel_container_v);
@@ -56,12 +58,19 @@ namespace wcopreco  {
     OpflashSelection get_flashes_cosmic(){return flashes_cosmic;};
     OpflashSelection get_flashes_beam(){return flashes_beam;};
     OpflashSelection get_flashes(){return flashes;};
-    OpWaveformCollection get_merged_beam(){return merged_beam;};
-    OpWaveformCollection get_merged_cosmic(){return merged_cosmic;};
+    const OpWaveformCollection& get_merged_beam() const {return merged_beam;};
+    const OpWaveformCollection& get_merged_cosmic() const {return merged_cosmic;};
     std::vector< std::vector<double> > get_decon_vv(){return decon_vv;};
     void clear_flashes();
 
   protected:
+    // beam hit and flash finding, fills decon_vv and flashes_beam
+    void Run_Beam(std::vector<wcopreco::kernel_fourier_container> * kernel_container_v);
+
+    // cosmic hit and flash finding, fills flashes_cosmic
+    void Run_Cosmic(std::vector<float> * op_gain,
+		    std::vector<float> * op_gainerror);
+
     Config_Params _cfg;
     std::vector< std::vector<double> > decon_vv;
     OpflashSelection flashes_cosmic;
@@ -70,6 +79,15 @@ namespace wcopreco  {
     OpWaveformCollection merged_beam;
     OpWaveformCollection merged_cosmic;
 
+    //deconvolution caches kept across events (FFT plans and kernel spectra)
+    fft_engine _fft_engine;
+    kernel_fourier_cache _kernel_cache;
+
+    //flashes of the current event, reused by the next one after clear_flashes()
+    //(one arena per branch, beam and cosmic may run concurrently)
+    OpflashArena _beam_flash_arena;
+    OpflashArena _cosmic_flash_arena;
+
   };
 
 }
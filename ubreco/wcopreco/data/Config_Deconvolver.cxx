@@ -19,6 +19,7 @@ namespace wcopreco {
         _n_bins_end_wfm = 4 ;
         _small_content_bump = 0.01;
         _nbins_baseline_search = 20;
+        _batched = false;
 
     }
 
@@ -21,6 +21,7 @@ namespace wcopreco {
    int     _n_bins_end_wfm; //Number of bins at end of deconvolved wfm set to zero
    double  _small_content_bump; //Small offset amount added to content in wfm after deconvolution.     -
    int     _nbins_baseline_search; //Number of bins to search in order to determine modal baseline     -
+   bool    _batched; //Deconvolve all channels as one channel x tick block instead of one channel at a time
 
    void _set_num_channels(int n){_num_channels = n;}
    int _get_num_channels(){return _num_channels;}
@@ -67,6 +68,9 @@ namespace wcopreco {
    void _set_nbins_baseline_search(int n){_nbins_baseline_search = n;}
    int _get_nbins_baseline_search(){return _nbins_baseline_search;}
 
+   void _set_batched(bool b){_batched = b;}
+   bool _get_batched(){return _batched;}
+
 
   protected:
 
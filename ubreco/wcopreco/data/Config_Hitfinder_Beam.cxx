@@ -19,6 +19,9 @@ namespace wcopreco {
         _totPE_v_thresh = 0.2 ;
         _mult_v_thresh  = 1.5 ;
         _l1_mult_v_thresh  = 1.0 ;
+        _l1_exp_solver = true ;
+        _l1_warm_start = false ;
+        _num_threads = 1 ;
 
         _tick_width_us = .015625;
     }
@@ -21,6 +21,9 @@ namespace wcopreco {
      double  _totPE_v_thresh; //Minimum value in rebinned content allowed to add to total PE
      double  _mult_v_thresh; //Minimum value in rebinned content allowed in order to add +1 to multiplicity
      double  _l1_mult_v_thresh; //Hitfinder beam
+     bool    _l1_exp_solver; //Use ExpKernelLassoModel (no dense G) for the L1 fit, same result as LassoModel
+     int     _num_threads; //Number of threads for the per-channel deconvolution and L1 fits (1 = serial)
+     bool    _l1_warm_start; //Start each channel's L1 fit from the previous channel's solution (converges to a slightly different point, same objective within the fit tolerance)
 
      double _tick_width_us; //Width of original bin in microseconds
 
@@ -69,6 +72,15 @@ namespace wcopreco {
      void _set_l1_mult_v_thresh(double value) {_l1_mult_v_thresh = value;}
      double _get_l1_mult_v_thresh() {return _l1_mult_v_thresh;}
 
+     void _set_l1_exp_solver(bool value) {_l1_exp_solver = value;}
+     bool _get_l1_exp_solver() {return _l1_exp_solver;}
+
+     void _set_num_threads(int value) {_num_threads = value;}
+     int _get_num_threads() {return _num_threads;}
+
+     void _set_l1_warm_start(bool value) {_l1_warm_start = value;}
+     bool _get_l1_warm_start() {return _l1_warm_start;}
+
      void _set_tick_width_us(double value) {_tick_width_us = value;}
      double _get_tick_width_us() {return _tick_width_us;}
 
@@ -145,6 +145,10 @@ namespace wcopreco {
       _cfg_deconvolver._small_content_bump = bump ;
   }
 
+  void Config_Params::set_batched_deconvolution(bool b) {
+      _cfg_deconvolver._batched = b ;
+  }
+
   void Config_Params::set_bflash_pe_thresh(double thresh) {
       _cfg_flashesbeam._bflash_pe_thresh = thresh ;
   }
@@ -231,6 +235,18 @@ namespace wcopreco {
       _cfg_hitfinder_beam._l1_mult_v_thresh = thresh ;
   }
 
+  void Config_Params::set_l1_exp_solver(bool b) {
+      _cfg_hitfinder_beam._l1_exp_solver = b ;
+  }
+
+  void Config_Params::set_l1_warm_start(bool b) {
+      _cfg_hitfinder_beam._l1_warm_start = b ;
+  }
+
+  void Config_Params::set_num_threads(int n) {
+      _cfg_hitfinder_beam._num_threads = n ;
+  }
+
   void Config_Params::set_ophit_group_t_diff_max(double max) {
       _cfg_hitfinder_cosmic._ophit_group_t_diff_max = max ;
   }
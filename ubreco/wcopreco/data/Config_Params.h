@@ -57,6 +57,7 @@ namespace wcopreco {
       void set_n_bins_end_wfm(int n);
       void set_small_content_bump(double bump);
       void set_nbins_baseline_search(int n);
+      void set_batched_deconvolution(bool b);
       //Flashesbeam
       void set_bflash_pe_thresh(double thresh);
       void set_bflash_mult_thresh(double thresh);
@@ -82,6 +83,9 @@ namespace wcopreco {
       void set_totPE_v_thresh(double thresh);
       void set_mult_v_thresh(double thresh);
       void set_l1_mult_v_thresh(double thresh);
+      void set_l1_exp_solver(bool b);
+      void set_l1_warm_start(bool b);
+      void set_num_threads(int n);
       //Hitfinder_cosmic
       void set_ophit_group_t_diff_max(double max);
       //Opflash
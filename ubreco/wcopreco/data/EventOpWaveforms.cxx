@@ -14,7 +14,7 @@ namespace wcopreco {
   {index2type = input_map;}
 
   void EventOpWaveforms::set_wfm_v(std::vector<OpWaveformCollection> input_vector)
-  {_wfm_v = input_vector;}
+  {_wfm_v = std::move(input_vector);}
 
   void EventOpWaveforms::set_wfm_v(OpWaveformCollection input_collection)
   {
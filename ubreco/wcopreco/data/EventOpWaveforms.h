@@ -12,6 +12,10 @@ namespace wcopreco {
   public:
     EventOpWaveforms(){};
     virtual ~EventOpWaveforms() {};
+    EventOpWaveforms(const EventOpWaveforms&) = default;
+    EventOpWaveforms(EventOpWaveforms&&) = default;
+    EventOpWaveforms& operator=(const EventOpWaveforms&) = default;
+    EventOpWaveforms& operator=(EventOpWaveforms&&) = default;
 
     void set_wfm_v(std::vector<OpWaveformCollection>);
     void set_wfm_v(OpWaveformCollection);
@@ -26,7 +30,8 @@ namespace wcopreco {
     void add_entry(OpWaveformCollection, int type);
     void push_back_wfm( int type, const OpWaveform& wfm );
 
-    std::vector<OpWaveformCollection> get_wfm_v() {return _wfm_v;};
+    const std::vector<OpWaveformCollection>& get_wfm_v() const {return _wfm_v;};
+    std::vector<OpWaveformCollection>& get_wfm_v() {return _wfm_v;};
     std::map <int,int> get_index2type() {return index2type;};
     std::map <int,int> get_type2index() {return type2index;};
 
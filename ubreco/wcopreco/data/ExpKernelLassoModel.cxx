@@ -0,0 +1,156 @@
+#include "ExpKernelLassoModel.h"
+
+#include <Eigen/Dense>
+using namespace Eigen;
+
+#include <cmath>
+#include <iostream>
+using namespace std;
+
+
+/* Minimize the following problem:
+ * 1/(2) * ||Y - beta * X||_2^2 + N * lambda * ||beta||_1
+ * for the exponential response described in the header.
+ */
+
+wcopreco::ExpKernelLassoModel::ExpKernelLassoModel(double lambda, int max_iter, double TOL, bool non_negtive)
+: ElasticNetModel(lambda, 1., max_iter, TOL, non_negtive)
+, _same(1.), _amp(0.), _slope(0.)
+, flag_initial_values(false)
+{
+    name = "Lasso";
+}
+
+wcopreco::ExpKernelLassoModel::~ExpKernelLassoModel()
+{}
+
+void wcopreco::ExpKernelLassoModel::SetKernel(double same, double amp, double slope)
+{
+  _same = same;
+  _amp = amp;
+  _slope = slope;
+}
+
+void wcopreco::ExpKernelLassoModel::Set_init_values(std::vector<double> values){
+  flag_initial_values = true;
+  init_betas = values;
+}
+
+void wcopreco::ExpKernelLassoModel::SetData(const std::vector<double> &t, const std::vector<double> &y)
+{
+  int n = t.size();
+  _t = t;
+  _u.resize(n);
+  _h.resize(n);
+  _hu.resize(n);
+  _norm.resize(n);
+  _ydX.resize(n);
+
+  Eigen::VectorXd W(n);
+  for (int i=0;i!=n;i++){
+    W(i) = y.at(i) / sqrt(y.at(i));
+    _u[i] = exp(_slope*(t[i]-t[0]));
+  }
+  Sety(W);
+  _beta = VectorXd::Zero(n);
+  SetLambdaWeight(VectorXd::Constant(n,1.));
+
+  // suffix sums from the latest bin backwards
+  double R = 0; // sum_{i>b} exp(-2 slope (t_i-t_b))/y_i
+  double Q = 0; // sum_{i>b} exp(-slope (t_i-t_b))
+  for (int b=n-1;b>=0;b--){
+    if (b<n-1){
+      double e = exp(-_slope*(t[b+1]-t[b]));
+      R = e*e*(1./y[b+1] + R);
+      Q = e*(1. + Q);
+    }
+    _h[b] = _same/y[b] + _amp*R;
+    _hu[b] = _h[b]/_u[b];
+    _norm[b] = _same*_same/y[b] + _amp*_amp*R;
+    _ydX[b] = _same + _amp*Q;
+  }
+}
+
+double wcopreco::ExpKernelLassoModel::Gram(int a, int b) const
+{
+  if (a==b) return _norm[a];
+  if (a>b) std::swap(a,b);
+  return _amp * _u[a] * _hu[b];
+}
+
+void wcopreco::ExpKernelLassoModel::Fit()
+{
+  int nbeta = _t.size();
+  // initialize solution to zero
+  Eigen::VectorXd beta = VectorXd::Zero(nbeta);
+
+  if (flag_initial_values){
+    for (int i=0;i!=beta.size();i++){
+      beta(i) = init_betas.at(i);
+    }
+  }
+
+  // initialize active_beta to true
+  _active_beta = vector<bool>(nbeta, true);
+
+  std::vector<double> norm(_norm);
+  for (int j=0; j<nbeta; j++) {
+    if (norm[j] < 1e-6) {
+      cerr << "warning: the " << j << "th variable is not used, please consider removing it." << endl;
+      norm[j] = 1;
+    }
+  }
+  double tol2 = TOL*TOL*nbeta;
+
+  // correlations c = X^T X beta, kept up to date as betas change
+  std::vector<double> c(nbeta, 0);
+  auto add_to_c = [&](int r, double delta){
+    // rows below r: Gram(j,r) = amp u_j hu_r, rows above: amp u_r hu_j
+    double lo = _amp * _hu[r] * delta;
+    double hi = _amp * _u[r] * delta;
+    for (int j=0;j<r;j++) c[j] += lo * _u[j];
+    c[r] += _norm[r] * delta;
+    for (int j=r+1;j<nbeta;j++) c[j] += hi * _hu[j];
+  };
+  auto reset_c = [&](){
+    std::fill(c.begin(), c.end(), 0);
+    for (int r=0;r!=nbeta;r++){
+      if (beta(r)!=0) add_to_c(r, beta(r));
+    }
+  };
+  reset_c();
+
+  // start interation ...
+  int double_check  = 0;
+  for (int i =0; i< max_iter; i++){
+    VectorXd betalast = beta;
+
+    for (int j=0;j!=nbeta;j++){
+      if (!_active_beta[j]) {continue;}
+      double old = beta(j);
+      double value = _ydX[j] - (c[j] - _norm[j]*old);
+      beta(j) = _soft_thresholding( value/norm[j], lambda * lambda_weight(j));
+      if (beta(j)!=old) add_to_c(j, beta(j)-old);
+
+      if(fabs(beta(j)) < 1e-6) { _active_beta[j] = false; }
+    }
+    double_check++;
+    VectorXd diff = beta - betalast;
+
+    if (diff.squaredNorm()<tol2) {
+      if (double_check!=1) {
+      	double_check = 0;
+      	for (int k=0; k<nbeta; k++) {
+      	  _active_beta[k] = true;
+      	}
+        // refresh the incremental sums before the final full sweep
+        reset_c();
+      }else {
+	break;
+      }
+    }
+  }
+
+  // save results in the model
+  Setbeta(beta);
+}
@@ -0,0 +1,53 @@
+#ifndef WIRECELLRESS_EXPKERNELLASSOMODEL_H
+#define WIRECELLRESS_EXPKERNELLASSOMODEL_H
+
+#include "ElasticNetModel.h"
+
+#include <vector>
+
+namespace wcopreco {
+
+/* Lasso fit specialised for the beam L1 hit finding, where the response matrix is
+ *   G(i,k) = g(t_i - t_k) / sqrt(y_i)  for t_i >= t_k (0 otherwise)
+ *   W(i)   = y_i / sqrt(y_i)
+ * with t ascending and an exponential response
+ *   g(0) = same,  g(d) = amp * exp(-slope*d) for d > 0.
+ * The fit is the same as LassoModel::SetData(G,W); Fit(); but G is never built:
+ * the Gram matrix factorises as G^T G (a,b) = amp * exp(-slope*(t_b-t_a)) * h(b) for a < b,
+ * where h only depends on the later bin, so every Gram column and X^T y are obtained
+ * from O(n) suffix sums. The coordinate descent keeps the correlations X^T X beta up to
+ * date incrementally, so only the non-zero betas cost anything.
+ */
+class ExpKernelLassoModel: public ElasticNetModel {
+public:
+    ExpKernelLassoModel(double lambda=1., int max_iter=100000, double TOL=1e-3, bool non_negtive=true);
+    ~ExpKernelLassoModel();
+
+    void SetKernel(double same, double amp, double slope);
+    void SetData(const std::vector<double> &t, const std::vector<double> &y);
+
+    void Fit();
+    void Set_init_values(std::vector<double> values);
+
+    // Gram matrix element (X^T X)(a,b)
+    double Gram(int a, int b) const;
+
+ private:
+    double _same;
+    double _amp;
+    double _slope;
+
+    std::vector<double> _t;
+    std::vector<double> _u;    // exp(slope*(t_a-t_0))
+    std::vector<double> _h;    // same/y_b + amp * sum_{i>b} exp(-2 slope (t_i-t_b))/y_i
+    std::vector<double> _hu;   // _h/_u
+    std::vector<double> _norm; // Gram diagonal
+    std::vector<double> _ydX;  // X^T y
+
+    bool flag_initial_values;
+    std::vector<double> init_betas;
+};
+
+}
+
+#endif
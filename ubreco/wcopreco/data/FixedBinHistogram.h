@@ -0,0 +1,118 @@
+#ifndef FIXEDBINHISTOGRAM_H
+#define FIXEDBINHISTOGRAM_H
+
+#include <array>
+
+namespace wcopreco {
+
+  // Minimal fixed-bin 1D histogram living entirely on the stack.
+  // It reproduces the TH1F semantics used in the optical reconstruction
+  // (bin numbering with underflow 0 and overflow NBINS+1, first maximum bin,
+  // bin centers/edges and GetQuantiles interpolation) without allocating
+  // or registering anything with gDirectory, so it can be used per waveform
+  // and from several threads.
+  template <int NBINS, typename T = float>
+  class FixedBinHistogram {
+  public:
+    FixedBinHistogram(double xlow, double xup)
+      : _xlow(xlow), _xup(xup), _width((xup-xlow)/NBINS)
+    { Reset(); }
+
+    void Reset() {
+      _contents.fill(0);
+      _integral_valid = false;
+    }
+
+    int FindBin(double x) const {
+      if (x < _xlow) return 0;
+      if (!(x < _xup)) return NBINS+1;
+      return 1 + int(NBINS*(x-_xlow)/(_xup-_xlow));
+    }
+
+    void Fill(double x) {
+      _contents[FindBin(x)] += 1;
+      _integral_valid = false;
+    }
+
+    T GetBinContent(int bin) const {return _contents[bin];}
+    double GetBinWidth(int) const {return _width;}
+    double GetBinLowEdge(int bin) const {return _xlow + (bin-1)*_width;}
+    double GetBinUpEdge(int bin) const {return _xlow + bin*_width;}
+    double GetBinCenter(int bin) const {return _xlow + (bin-1)*_width + 0.5*_width;}
+
+    // first bin with the largest content, under/overflow excluded (bin 1 if empty)
+    int GetMaximumBin() const {
+      int locm = 1;
+      T maximum = _contents[1];
+      for (int bin=2; bin<=NBINS; bin++){
+        if (_contents[bin] > maximum) {maximum = _contents[bin]; locm = bin;}
+      }
+      return locm;
+    }
+
+    double Integral() const {
+      double sum = 0;
+      for (int bin=1; bin<=NBINS; bin++) sum += _contents[bin];
+      return sum;
+    }
+
+    // same interpolation as TH1::GetQuantiles, returns the number of quantiles computed
+    int GetQuantiles(int nprobSum, double *q, const double *probSum) {
+      if (!ComputeIntegral()) return 0;
+      for (int i=0; i<nprobSum; i++){
+        double prob = probSum[i];
+        int ibin = BinarySearch(prob);
+        if (ibin >= 0 && _integral[ibin] == prob) {
+          if (prob == 0.) {
+            for (; ibin+1 <= NBINS && _integral[ibin+1] == 0.; ++ibin) {}
+          }
+          else if (prob != 1.) {
+            for (; ibin+1 <= NBINS && _integral[ibin+1] == prob; ++ibin) {}
+          }
+          q[i] = GetBinUpEdge(ibin);
+        }
+        else {
+          q[i] = GetBinLowEdge(ibin+1);
+          const double dint = _integral[ibin+1]-_integral[ibin];
+          if (dint > 0) q[i] += GetBinWidth(ibin+1)*(prob-_integral[ibin])/dint;
+        }
+      }
+      return nprobSum;
+    }
+
+  protected:
+    // normalised cumulative content, _integral[0] = 0, _integral[NBINS] = 1
+    bool ComputeIntegral() {
+      if (_integral_valid) return true;
+      _integral[0] = 0;
+      for (int bin=1; bin<=NBINS; bin++) _integral[bin] = _integral[bin-1] + _contents[bin];
+      if (_integral[NBINS] == 0) return false;
+      double total = _integral[NBINS];
+      for (int bin=1; bin<=NBINS; bin++) _integral[bin] /= total;
+      _integral_valid = true;
+      return true;
+    }
+
+    // index of the last of the first NBINS integral entries <= value (-1 if none)
+    int BinarySearch(double value) const {
+      int lo = 0, hi = NBINS;
+      while (lo < hi) {
+        int mid = (lo+hi)/2;
+        if (_integral[mid] < value) lo = mid+1;
+        else hi = mid;
+      }
+      if (lo < NBINS && _integral[lo] == value) return lo;
+      return lo-1;
+    }
+
+    double _xlow;
+    double _xup;
+    double _width;
+    std::array<T, NBINS+2> _contents;
+    std::array<double, NBINS+1> _integral;
+    bool _integral_valid;
+  };
+
+}
+
+#endif
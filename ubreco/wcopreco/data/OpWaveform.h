@@ -11,6 +11,11 @@ namespace wcopreco {
 
     OpWaveform(int ChNum, double time_from_trig, int typ, const int nelems );
     virtual ~OpWaveform() {};
+    //the virtual destructor would otherwise turn every move of the samples into a copy
+    OpWaveform(const OpWaveform&) = default;
+    OpWaveform(OpWaveform&&) = default;
+    OpWaveform& operator=(const OpWaveform&) = default;
+    OpWaveform& operator=(OpWaveform&&) = default;
 
     int get_ChannelNum() const {return ChannelNum;};
     double get_time_from_trigger() const {return time_from_trigger;};
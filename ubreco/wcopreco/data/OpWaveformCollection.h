@@ -15,6 +15,10 @@ namespace wcopreco {
   public:
     OpWaveformCollection();
     virtual ~OpWaveformCollection() {};
+    OpWaveformCollection(const OpWaveformCollection&) = default;
+    OpWaveformCollection(OpWaveformCollection&&) = default;
+    OpWaveformCollection& operator=(const OpWaveformCollection&) = default;
+    OpWaveformCollection& operator=(OpWaveformCollection&&) = default;
 
     void set_channel2index(std::map <int,std::vector<int>>);
     void set_index2channel(std::map <int,int>);
@@ -22,7 +26,7 @@ namespace wcopreco {
     void insert_index2channel(int index, int channel) {index2channel.insert(std::pair<int,int>(index,channel));};
     int get_index2channel(int index) {return index2channel[index];};
     std::vector<int> get_channel2index(int channel) {return channel2index[channel];};
-    void add_waveform(OpWaveform wfm);
+    void add_waveform(OpWaveform wfm); //pass an rvalue to avoid copying the samples
     
     std::vector<float> get_op_gain() const {return op_gain;}
     void set_op_gain(std::vector<float> gains_v) {op_gain = gains_v;}
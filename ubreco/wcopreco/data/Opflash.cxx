@@ -5,10 +5,24 @@
 using namespace wcopreco;
 
 wcopreco::Opflash::Opflash(COphitSelection &ophits, const Config_Opflash &configOpF) //cosmic
-  : type(1)
-  , flash_id (-1)
-  , _cfgOpF(configOpF)
 {
+  Fill_cosmic(ophits, configOpF);
+}
+
+wcopreco::Opflash::Opflash(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin , const Config_Opflash &configOpF) //beam
+{
+  Fill_beam(vec_v, start_time, start_bin, end_bin, configOpF);
+}
+
+void wcopreco::Opflash::Fill_cosmic(COphitSelection &ophits, const Config_Opflash &configOpF)
+{
+  type = 1;
+  flash_id = -1;
+  _cfgOpF = configOpF;
+  fired_channels.clear();
+  l1_fired_time.clear();
+  l1_fired_pe.clear();
+
   PE.resize(_cfgOpF._num_channels);
   PEnc.resize(_cfgOpF._num_channels);
   PE_err.resize(_cfgOpF._num_channels);
@@ -39,11 +53,15 @@ wcopreco::Opflash::Opflash(COphitSelection &ophits, const Config_Opflash &config
 
 }
 
-wcopreco::Opflash::Opflash(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin , const Config_Opflash &configOpF) //beam
-  : type(2)
-  , flash_id (-1)
-  , _cfgOpF (configOpF)
+void wcopreco::Opflash::Fill_beam(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin , const Config_Opflash &configOpF)
 {
+  type = 2;
+  flash_id = -1;
+  _cfgOpF = configOpF;
+  fired_channels.clear();
+  l1_fired_time.clear();
+  l1_fired_pe.clear();
+
   PE.resize(_cfgOpF._num_channels);
   PEnc.resize(_cfgOpF._num_channels);
   PE_err.resize(_cfgOpF._num_channels);
@@ -13,6 +13,10 @@ namespace wcopreco{
     Opflash(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin, const Config_Opflash &configOpF);
     ~Opflash();
 
+    //refill an existing flash, same result as the constructors but the vectors keep their capacity
+    void Fill_cosmic(COphitSelection &ophits, const Config_Opflash &configOpF);
+    void Fill_beam(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin, const Config_Opflash &configOpF);
+
     void Add_l1info(std::vector<double>* vec1, std::vector<double> *vec2, double start_time , int start_bin, int end_bin, const Config_Opflash &configOpF);
 
     void set_flash_id(int value){flash_id = value;};
@@ -0,0 +1,25 @@
+#include "OpflashArena.h"
+
+namespace wcopreco {
+
+  Opflash* OpflashArena::make_cosmic(COphitSelection &ophits, const Config_Opflash &configOpF){
+    if (_used < _flashes.size()) {
+      _flashes[_used]->Fill_cosmic(ophits, configOpF);
+    }
+    else {
+      _flashes.emplace_back(new Opflash(ophits, configOpF));
+    }
+    return _flashes[_used++].get();
+  }
+
+  Opflash* OpflashArena::make_beam(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin, const Config_Opflash &configOpF){
+    if (_used < _flashes.size()) {
+      _flashes[_used]->Fill_beam(vec_v, start_time, start_bin, end_bin, configOpF);
+    }
+    else {
+      _flashes.emplace_back(new Opflash(vec_v, start_time, start_bin, end_bin, configOpF));
+    }
+    return _flashes[_used++].get();
+  }
+
+}
@@ -0,0 +1,39 @@
+#ifndef OPFLASHARENA_H
+#define OPFLASHARENA_H
+
+#include "Opflash.h"
+#include <vector>
+#include <memory>
+
+namespace wcopreco {
+
+  // Owns the Opflash objects of an event. reset() does not free them: the next
+  // event refills the same objects (and their PE vectors) in place, so once the
+  // arena has grown to the largest flash count no Opflash is allocated any more.
+  // Pointers handed out stay valid until reset() or the arena is destroyed and
+  // must never be deleted by the caller.
+  class OpflashArena {
+  public:
+    OpflashArena() : _used(0) {};
+    ~OpflashArena() {};
+
+    Opflash* make_cosmic(COphitSelection &ophits, const Config_Opflash &configOpF);
+    Opflash* make_beam(const std::vector<std::vector<double>> &vec_v, double start_time, int start_bin, int end_bin, const Config_Opflash &configOpF);
+
+    // gives back the last flash made (e.g. a rejected one)
+    void release_last() {if (_used > 0) _used--;}
+
+    // all flashes are free again
+    void reset() {_used = 0;}
+
+    size_t size() const {return _used;}
+
+  protected:
+    std::vector<std::unique_ptr<Opflash>> _flashes;
+    size_t _used;
+
+  };
+
+}
+
+#endif
@@ -3,9 +3,13 @@
 namespace wcopreco {
 
 
-  wcopreco::Deconvolver::Deconvolver(OpWaveformCollection &merged_beam, bool with_filters, std::vector<kernel_fourier_container> &input_k_container_v, const Config_Deconvolver & cfg)
+  wcopreco::Deconvolver::Deconvolver(OpWaveformCollection &merged_beam, bool with_filters, std::vector<kernel_fourier_container> &input_k_container_v, const Config_Deconvolver & cfg,
+                                     fft_engine *fft, kernel_fourier_cache *kernel_cache)
   :_cfg(cfg)
   {
+    _fft = fft ? fft : &_local_fft;
+    _kernel_cache = kernel_cache ? kernel_cache : &_local_kernel_cache;
+    _fft_slot = 0;
 
     //int type = merged_beam.at(0).get_type();
     op_gain = merged_beam.get_op_gain();
@@ -17,34 +21,145 @@ namespace wcopreco {
 
   OpWaveformCollection wcopreco::Deconvolver::Deconvolve_Collection(OpWaveformCollection & merged_beam)
 
+    {
+      if (_cfg._batched) return Deconvolve_Collection_Batched(merged_beam);
+      return Deconvolve_Collection_Serial(merged_beam);
+    }
+
+
+  OpWaveformCollection wcopreco::Deconvolver::Deconvolve_Collection_Serial(OpWaveformCollection & merged_beam)
+
     {
       //Process the Beam:
       //Note that the following code is supposed to only deal with beam waveforms, 32 channels and 1500 bin wfms.
-      OpWaveform wfm(0,0,0,0);
-
       for (int ch=0; ch<_cfg._num_channels; ch++){
-        wfm = merged_beam.at(ch);
-        nbins = wfm.size();
-	
-	//get the gain for this ch: need to decide whether to do deconvolution
-	float chgain = merged_beam.get_op_gain().at(ch);
-	
-	//remove baselines (baseline here are determined by the start of the waveform)
-	Remove_Baseline_Leading_Edge(wfm);
-
-	Remove_Baseline_Secondary(wfm);
-	
-	if(chgain>0){	  
-	  //Do deconvolution (need to add a way to incorporate kernels)
-	  deconvolved_collection.add_waveform(Deconvolve_One_Wfm(wfm, kernel_container_v->at(wfm.get_ChannelNum())));
-	}
-	else{
-	  deconvolved_collection.add_waveform(wfm);
-	}
+        deconvolved_collection.add_waveform(Deconvolve_Channel(merged_beam, ch));
       }
       
       return deconvolved_collection;
-    }//End of Deconvolve_Collection
+    }//End of Deconvolve_Collection_Serial
+
+
+  OpWaveform wcopreco::Deconvolver::Deconvolve_Channel(const OpWaveformCollection & merged_beam, int ch)
+
+    {
+      OpWaveform wfm = merged_beam.at(ch);
+      nbins = wfm.size();
+
+      //get the gain for this ch: need to decide whether to do deconvolution
+      float chgain = merged_beam.get_op_gain().at(ch);
+
+      //remove baselines (baseline here are determined by the start of the waveform)
+      Remove_Baseline_Leading_Edge(wfm);
+
+      Remove_Baseline_Secondary(wfm);
+
+      if(chgain>0){
+        //Do deconvolution (need to add a way to incorporate kernels)
+        return Deconvolve_One_Wfm(wfm, kernel_container_v->at(wfm.get_ChannelNum()));
+      }
+      return wfm;
+    }//End of Deconvolve_Channel
+
+
+  OpWaveformCollection wcopreco::Deconvolver::Deconvolve_Collection_Batched(OpWaveformCollection & merged_beam)
+
+    {
+      //Same as Deconvolve_Collection, but all beam channels go through Deconvolve_Block as one block
+      int nch = _cfg._num_channels;
+      std::vector<OpWaveform> block_wfms;
+      if (nch <= 0 || (int)merged_beam.size() < nch || !Deconvolve_Block(merged_beam, 0, nch, block_wfms))
+        return Deconvolve_Collection_Serial(merged_beam);
+      for (auto &wfm : block_wfms) deconvolved_collection.add_waveform(std::move(wfm));
+
+      return deconvolved_collection;
+    }//End of Deconvolve_Collection_Batched
+
+
+  bool wcopreco::Deconvolver::Deconvolve_Block(const OpWaveformCollection & merged_beam, int ch_begin, int ch_end, std::vector<OpWaveform> &out)
+
+    {
+      //Channels [ch_begin,ch_end) are packed channel-major into one contiguous channel x tick
+      //block, so the filters and the fit inputs are produced by flat loops over the whole block
+      //instead of per-channel temporaries. Arithmetic is performed in the same order as the
+      //per-channel path, so the output is identical.
+      int nch = ch_end - ch_begin;
+      if (nch <= 0) return true;
+      int nb = merged_beam.at(ch_begin).size();
+      for (int ch=ch_begin; ch<ch_end; ch++){
+        //the block needs one common binning, anything else goes through the per-channel path
+        if ((int)merged_beam.at(ch).size() != nb) return false;
+      }
+      nbins = nb;
+      const std::vector<float> chgain_v = merged_beam.get_op_gain();
+      float bin_width = (_cfg._tick_width_us*1e-6 ); // e-6 to go from microseconds to seconds
+      size_t block_size = (size_t)nch*nb;
+
+      //remove baselines, row by row
+      wfm_block.resize(block_size);
+      for (int r=0; r<nch; r++){
+        double *row = &wfm_block[(size_t)r*nb];
+        std::copy(merged_beam.at(ch_begin+r).begin(), merged_beam.at(ch_begin+r).end(), row);
+        Remove_Baseline_Leading_Edge(row, nb);
+        Remove_Baseline_Secondary(row, nb);
+      }
+
+      //forward transforms and division by the kernel spectra
+      re_block.assign(block_size, 0);
+      im_block.assign(block_size, 0);
+      re1_block.resize(block_size);
+      im1_block.resize(block_size);
+      re_v.resize(nb);
+      im_v.resize(nb);
+      for (int r=0; r<nch; r++){
+        if (!(chgain_v.at(ch_begin+r)>0)) continue;
+        int channel = merged_beam.at(ch_begin+r).get_ChannelNum();
+        float gain = (channel < (int)op_gain.size()) ? op_gain.at(channel) : 0;
+        _kernel_cache->update(channel, gain, nb, bin_width, kernel_container_v->at(channel));
+        _fft->forward(nb, &wfm_block[(size_t)r*nb], re_v.data(), im_v.data(), _fft_slot);
+        Divide_Kernels(re_v.data(), im_v.data(), nb, channel, &re_block[(size_t)r*nb], &im_block[(size_t)r*nb]);
+      }
+
+      //filters over the whole block
+      const std::vector<double> &latelight_v = get_filter_v(latelight_filter_v, nb, true);
+      const std::vector<double> &highfreq_v = get_filter_v(highfreq_filter_v, nb, false);
+      if (filter_status){
+        for (int r=0; r<nch; r++){
+          double *re = &re_block[(size_t)r*nb];
+          double *im = &im_block[(size_t)r*nb];
+          double *re1 = &re1_block[(size_t)r*nb];
+          double *im1 = &im1_block[(size_t)r*nb];
+          for (int i=0; i<nb; i++){
+            re1[i] = re[i] * highfreq_v[i];
+            im1[i] = im[i] * highfreq_v[i];
+            re[i] = re[i] * latelight_v[i];
+            im[i] = im[i] * latelight_v[i];
+          }
+        }
+      }
+      else{
+        re1_block = re_block;
+        im1_block = im_block;
+      }
+
+      //inverse transforms and baseline correction
+      out.reserve(out.size() + nch);
+      for (int r=0; r<nch; r++){
+        const OpWaveform &in_wfm = merged_beam.at(ch_begin+r);
+        OpWaveform out_wfm(in_wfm.get_ChannelNum(), in_wfm.get_time_from_trigger(), in_wfm.get_type(), nb);
+        if (chgain_v.at(ch_begin+r)>0){
+          _fft->inverse(nb, &re_block[(size_t)r*nb], &im_block[(size_t)r*nb], inverse_v, _fft_slot);
+          _fft->inverse(nb, &re1_block[(size_t)r*nb], &im1_block[(size_t)r*nb], out_wfm.data(), _fft_slot);
+          Correct_Baseline(inverse_v, out_wfm);
+        }
+        else{
+          std::copy(&wfm_block[(size_t)r*nb], &wfm_block[(size_t)r*nb]+nb, out_wfm.begin());
+        }
+        out.push_back(std::move(out_wfm));
+      }
+
+      return true;
+    }//End of Deconvolve_Block
 
 
     // void Deconvolver::add_kernel_container_entry(kernel_fourier *kernel, int channel) {
@@ -78,59 +193,66 @@ namespace wcopreco {
 
      void Deconvolver::Remove_Baseline_Leading_Edge(OpWaveform &wfm)
      {
-       int size = wfm.size();
-       double baseline = wfm.at(0);
+       Remove_Baseline_Leading_Edge(wfm.data(), wfm.size());
+     }
+
+     void Deconvolver::Remove_Baseline_Leading_Edge(double *wfm, int size)
+     {
+       double baseline = wfm[0];
        for (int i=0; i<size; i++) {
-         wfm.at(i) = wfm.at(i) - baseline;
+         wfm[i] = wfm[i] - baseline;
        }
        return;
      }
 
      void Deconvolver::Remove_Baseline_Secondary(OpWaveform &wfm)
      {
-        TH1F h1("h1","h1",200,-100,100);
+       Remove_Baseline_Secondary(wfm.data(), wfm.size());
+     }
+
+     void Deconvolver::Remove_Baseline_Secondary(double *wfm, int size)
+     {
+        FixedBinHistogram<200> h1(-100,100);
 
-        h1.Reset();
         for (int j=0;j!=_cfg._nbins_baseline_search;j++){
-            h1.Fill(wfm.at(j));
+            h1.Fill(wfm[j]);
         }
         double baseline = h1.GetMaximumBin()-(_cfg._baseline_safety_subtraction);
         if (fabs(baseline)>=_cfg._baseline_difference_max) {baseline = 0;}
-        for (size_t j=0;j!=wfm.size();j++){
-            wfm.at(j) = wfm.at(j) - baseline;
+        for (int j=0;j!=size;j++){
+            wfm[j] = wfm[j] - baseline;
         }
 
         return;
      }
 
-     std::pair<double,double> Deconvolver::cal_mean_rms(std::vector<double> wfm, int nbin)
+     std::pair<double,double> Deconvolver::cal_mean_rms(const std::vector<double> &wfm, int nbin)
      {
         //calculate the mean and rms values
-        TH1F *h4 = new TH1F("h4","h4",2000,-10,10);
+        FixedBinHistogram<2000> h4(-10,10);
         double mean, rms;
         for (int i=0;i!=nbin;i++){
           double content = wfm.at(i);
           if (fabs(content)<10)
-          h4->Fill(content);
+          h4.Fill(content);
         }
-        mean = h4->GetBinCenter(h4->GetMaximumBin()+1);
+        mean = h4.GetBinCenter(h4.GetMaximumBin()+1);
 
         double arg = _cfg._xq;
         double par[3];
 
-	if(h4->Integral() !=0.){
-	  h4->GetQuantiles(1,&par[1],&arg);
+	if(h4.Integral() !=0.){
+	  h4.GetQuantiles(1,&par[1],&arg);
 	  arg = _cfg._xq - _cfg._xq_diff;
 	  
-	  h4->GetQuantiles(1,&par[0],&arg);
+	  h4.GetQuantiles(1,&par[0],&arg);
 	  arg = _cfg._xq + _cfg._xq_diff;
 	  
-	  h4->GetQuantiles(1,&par[2],&arg);
+	  h4.GetQuantiles(1,&par[2],&arg);
 	  
 	  rms = sqrt((pow(par[0]-par[1],2)+pow(par[2]-par[1],2))/2.);
 	}
 	else{mean = rms = 0;}
-        delete h4;
         return std::make_pair(mean,rms);
      }
 
@@ -152,78 +274,11 @@ namespace wcopreco {
        return maxdiff;
      }
 
-     OpWaveform Deconvolver::Deconvolve_One_Wfm(OpWaveform & wfm, const kernel_fourier_container & kernel_container) {
-       //BEGIN DECONVOLUTION MARKER
-       std::vector<double> wfm_doubles(wfm.begin(), wfm.end());
-       float bin_width = (_cfg._tick_width_us*1e-6 ); // e-6 to go from microseconds to seconds
-       int nbins = wfm.size();
-
-       //get power spectrum of data
-       //Create Mag and Phase vectors
-       std::vector<double> mag_raw;
-       std::vector<double> phase_raw;
-       mag_raw.resize(nbins);
-       phase_raw.resize(nbins);
-
-       //Get the input to the fourier transform ready
-       std::vector<double> power_spec_d(nbins,0);
-       power_spec_d = wfm_doubles;
-       double *in = power_spec_d.data();
-       //Start the fourier transform (real to complex)
-       TVirtualFFT *fftr2c = TVirtualFFT::FFT(1, &nbins, "R2C");
-       fftr2c->SetPoints(in);
-       fftr2c->Transform();
-       double *re = new double[nbins]; //Real -> Magnitude
-       double *im = new double[nbins]; //Imaginary -> Phase
-
-       fftr2c->GetPointsComplex(re, im); //Put the values in the arrays
-
-       //Copy those array values into vectors passed in by reference.
-       // This is inefficient, but makes for an easier user interface.
-       double im_i =0;
-       double re_i = 0;
-       for (int i =0; i<nbins; i++){
-         //Calculate the phase_raw
-         im_i = im[i];
-         re_i = re[i];
-         double ph = 0;
-         if (TMath::Abs(re_i) > 1e-13){
-            ph = atan2(im_i , re_i);
-
-         }
-         phase_raw.at(i) = ph;
-
-         //End of phase_raw calc
-
-         //Calculate the mag_v
-         double magnitude = TMath::Sqrt(re[i]*re[i]+im[i]*im[i]);
-         mag_raw[i] = magnitude;
-         //End of mag_v calc
-       }
-
-
-       delete fftr2c;
-       //double max_freq_MHz = (1/_cfg._tick_width_us)*_cfg._nbins_beam*2*TMath::Pi();
-
-       double *value_re = new double[nbins];
-       double *value_im = new double[nbins];
-       double *value_re1 = new double[nbins];
-       double *value_im1 = new double[nbins];
-
-       //Set up the kernels to be deconvolved out:
-      int channel = wfm.get_ChannelNum();
-      int num_kernels = kernel_container_v->at(channel).size();
-      std::vector<std::vector<double>> mag_kernel;
-      mag_kernel.resize(num_kernels);
-      std::vector<std::vector<double>> phase_kernel;
-      phase_kernel.resize(num_kernels);
-
-
-      for (int n=0; n < num_kernels; n++ ) {
-        kernel_container_v->at(channel).at(n)->Get_pow_spec(nbins, bin_width, &mag_kernel.at(n), &phase_kernel.at(n));
-      }
-
-
+     const std::vector<double> & Deconvolver::get_filter_v(std::vector<double> &filter_v, int nbins, bool latelight)
+     {
+       //filters only depend on the bin and the configuration, evaluate them once per binning
+       if ((int)filter_v.size() == nbins) return filter_v;
+       filter_v.resize(nbins);
        for (int i=0;i<nbins;i++){
          double freq;
          if (i<=nbins/2){
@@ -232,51 +287,93 @@ namespace wcopreco {
          else{
      	     freq = (((double)nbins-(double)i)/(double)nbins*2.)*1.0;
          }
+         filter_v[i] = latelight ? LateLightFilter(freq) : HighFreqFilter(freq);
+       }
+       return filter_v;
+     }
 
-         double rho = mag_raw.at(i);
+     void Deconvolver::Divide_Kernels(const double *re, const double *im, int nbins, int channel, double *out_re, double *out_im)
+     {
+       //kernel spectra must have been brought up to date in the cache for this channel
+       const std::vector<std::vector<double>> &mag_kernel = _kernel_cache->get_mag(channel);
+       const std::vector<std::vector<double>> &phase_kernel = _kernel_cache->get_phase(channel);
+       int num_kernels = mag_kernel.size();
 
-         double phi = phase_raw.at(i);
-         for (int n=0;n<num_kernels;n++){
-           rho = rho / mag_kernel.at(n).at(i);
-           phi = phi - phase_kernel.at(n).at(i);
+       for (int i=0;i<nbins;i++){
+         double re_i = re[i];
+         double im_i = im[i];
+
+         double phi = 0;
+         if (TMath::Abs(re_i) > 1e-13){
+            phi = atan2(im_i , re_i);
          }
+         double rho = TMath::Sqrt(re_i*re_i+im_i*im_i);
 
+         for (int n=0;n<num_kernels;n++){
+           rho = rho / mag_kernel[n][i];
+           phi = phi - phase_kernel[n][i];
+         }
 
          if (i==0) rho = 0;
-         //Perform Deconv with Filters
-         if (filter_status){
-           value_re[i] = rho * (cos(phi)/nbins) * LateLightFilter(freq);
-           value_im[i] = rho * (sin(phi)/nbins) * LateLightFilter(freq);
-           value_re1[i] = rho * (cos(phi)/nbins) * HighFreqFilter(freq);
-           value_im1[i] = rho * (sin(phi)/nbins) * HighFreqFilter(freq);
-         }
-         //Perform Deconv without Filters
-         else{
-           value_re[i] = rho * (cos(phi)/nbins) ;
-           value_im[i] = rho * (sin(phi)/nbins) ;
-           value_re1[i] = rho * (cos(phi)/nbins) ;
-           value_im1[i] = rho * (sin(phi)/nbins) ;
-         }
+         out_re[i] = rho * (cos(phi)/nbins);
+         out_im[i] = rho * (sin(phi)/nbins);
+       }
+     }
+
+     OpWaveform Deconvolver::Deconvolve_One_Wfm(OpWaveform & wfm, const kernel_fourier_container & kernel_container) {
+       //BEGIN DECONVOLUTION MARKER
+       float bin_width = (_cfg._tick_width_us*1e-6 ); // e-6 to go from microseconds to seconds
+       int nbins = wfm.size();
+
+       //get power spectrum of data (plan is cached in the fft engine)
+       re_v.resize(nbins);
+       im_v.resize(nbins);
+       _fft->forward(nbins, wfm.data(), re_v.data(), im_v.data(), _fft_slot);
 
+       //Set up the kernels to be deconvolved out:
+       //their spectra are cached per channel and only recomputed when the gain changes
+       int channel = wfm.get_ChannelNum();
+       float chgain = (channel < (int)op_gain.size()) ? op_gain.at(channel) : 0;
+       _kernel_cache->update(channel, chgain, nbins, bin_width, kernel_container);
+
+       value_re.resize(nbins);
+       value_im.resize(nbins);
+       value_re1.resize(nbins);
+       value_im1.resize(nbins);
+       Divide_Kernels(re_v.data(), im_v.data(), nbins, channel, value_re.data(), value_im.data());
+
+       //Perform Deconv with Filters
+       if (filter_status){
+         const std::vector<double> &latelight_v = get_filter_v(latelight_filter_v, nbins, true);
+         const std::vector<double> &highfreq_v = get_filter_v(highfreq_filter_v, nbins, false);
+         for (int i=0;i<nbins;i++){
+           value_re1[i] = value_re[i] * highfreq_v[i];
+           value_im1[i] = value_im[i] * highfreq_v[i];
+           value_re[i] = value_re[i] * latelight_v[i];
+           value_im[i] = value_im[i] * latelight_v[i];
+         }
+       }
+       //Perform Deconv without Filters
+       else{
+         value_re1 = value_re;
+         value_im1 = value_im;
        }
 
        // ROI finding
-       TVirtualFFT *ifft = TVirtualFFT::FFT(1,&nbins,"C2R");
-       ifft->SetPointsComplex(value_re,value_im);
-       ifft->Transform();
+       _fft->inverse(nbins, value_re.data(), value_im.data(), inverse_v, _fft_slot);
 
-       double *re_inv = new double[nbins]; //Real -> Magnitude
-       double *im_inv = new double[nbins]; //Imaginary -> Phase
-
-       ifft->GetPointsComplex(re_inv, im_inv);
+       // solve for baseline
+       OpWaveform inverse_res1(channel,wfm.get_time_from_trigger(), wfm.get_type(), nbins);
+       _fft->inverse(nbins, value_re1.data(), value_im1.data(), inverse_res1.data(), _fft_slot);
 
-       std::vector<double> inverse_res;
-       inverse_res.resize(nbins);
-       for (int i = 0; i < nbins ; i++){
-         inverse_res.at(i) = re_inv[i];
+       Correct_Baseline(inverse_v, inverse_res1);
+       //END OF DECONVOLUTION
+       return inverse_res1;
+     }
 
-       };
-       delete ifft;
+     void Deconvolver::Correct_Baseline(const std::vector<double> &inverse_res, OpWaveform &inverse_res1)
+     {
+       int nbins = inverse_res.size();
 
        // calculate rms and mean
        std::pair<double,double> results = cal_mean_rms(inverse_res, nbins);
@@ -292,22 +389,6 @@ namespace wcopreco {
 	 }
        }
 
-       // solve for baseline
-       TVirtualFFT *ifft1 = TVirtualFFT::FFT(1,&nbins,"C2R");
-       ifft1->SetPointsComplex(value_re1,value_im1);
-       ifft1->Transform();
-
-       double *re_inv1 = new double[nbins]; //Real -> Magnitude
-       double *im_inv1 = new double[nbins]; //Imaginary -> Phase
-
-       ifft1->GetPointsComplex(re_inv1, im_inv1);
-
-       OpWaveform inverse_res1(channel,wfm.get_time_from_trigger(), wfm.get_type(), nbins);
-       for (int i = 0; i < nbins ; i++){
-         double value = re_inv1[i];
-         inverse_res1.at(i) = value;
-       }
-
        double A11 = 0, A12 = 0, A21=0, A22=0;
        double B1 = 0, B2 = 0;
        double a=0, b=0;
@@ -339,18 +420,6 @@ namespace wcopreco {
    	       inverse_res1.at(i) = 0;
          }
        }
-       delete[] re;
-       delete[] im;
-       delete[] re_inv;
-       delete[] im_inv;
-       delete[] re_inv1;
-       delete[] im_inv1;
-       delete[] value_re;
-       delete[] value_im;
-       delete[] value_re1;
-       delete[] value_im1;
-       //END OF DECONVOLUTION
-       return inverse_res1;
      }
 
      // void Deconvolver::clear_kernels() {
@@ -4,6 +4,8 @@
 //deconv functions
 #include "kernel_fourier.h"
 #include "kernel_fourier_container.h"
+#include "kernel_fourier_cache.h"
+#include "fft_engine.h"
 #include "LassoModel.h"
 #include "ElasticNetModel.h"
 #include "LinearModel.h"
@@ -15,6 +17,7 @@
 #include "OpWaveformCollection.h"
 #include "EventOpWaveforms.h"
 #include "Config_Deconvolver.h"
+#include "FixedBinHistogram.h"
 
 
 //c++ includes
@@ -34,7 +37,13 @@ namespace wcopreco{
 
   class Deconvolver {
   public:
-    Deconvolver(OpWaveformCollection &merged_beam, bool with_filters, std::vector<kernel_fourier_container> &input_k_container_v, const Config_Deconvolver &); //OpWaveform op_wfm, kernel_fourier_shape kernel_fourier, noise_remover noise, std::vector<short???> LL_shape
+    Deconvolver(OpWaveformCollection &merged_beam, bool with_filters, std::vector<kernel_fourier_container> &input_k_container_v, const Config_Deconvolver &,
+                fft_engine *fft = nullptr, kernel_fourier_cache *kernel_cache = nullptr); //OpWaveform op_wfm, kernel_fourier_shape kernel_fourier, noise_remover noise, std::vector<short???> LL_shape
+    /*
+    fft and kernel_cache are optional long-lived caches (owned by the caller, e.g. UBAlgo)
+    holding the FFT plans and the per-channel kernel spectra across events. If they are
+    not given the Deconvolver uses its own, which then only live as long as this object.
+    */
     ~Deconvolver() {};
 
 
@@ -46,13 +55,29 @@ namespace wcopreco{
 
 
     void set_filter_status(bool status) {filter_status = status;}
+    // Deconvolvers running concurrently on a shared fft_engine must use different slots
+    void set_fft_slot(int slot) {_fft_slot = slot;}
     OpWaveformCollection Deconvolve_Collection(OpWaveformCollection & merged_beam);
+    OpWaveformCollection Deconvolve_Collection_Serial(OpWaveformCollection & merged_beam);
+    OpWaveformCollection Deconvolve_Collection_Batched(OpWaveformCollection & merged_beam);
+    OpWaveform Deconvolve_Channel(const OpWaveformCollection & merged_beam, int ch);
+    bool Deconvolve_Block(const OpWaveformCollection & merged_beam, int ch_begin, int ch_end, std::vector<OpWaveform> &out);
+    /*
+    Deconvolve_Collection dispatches to the batched path when _cfg._batched is set. The batched
+    path packs all channels into one channel-major block and produces the same result as the
+    per-channel (serial) path.
+    Deconvolve_Block runs the batched path on channels [ch_begin,ch_end) only and appends them
+    to out; it returns false, leaving out unchanged, if they do not share one binning.
+    HitFinder_beam workers each deconvolve one such block when running with several threads.
+    */
     double HighFreqFilter(double frequency);
     double LateLightFilter(double frequency2);
     void Remove_Baseline_Leading_Edge(OpWaveform &wfm);
+    void Remove_Baseline_Leading_Edge(double *wfm, int size);
     void Remove_Baseline_Secondary(OpWaveform &wfm);
+    void Remove_Baseline_Secondary(double *wfm, int size);
     OpWaveform Deconvolve_One_Wfm(OpWaveform &wfm, const kernel_fourier_container &kernel_container);
-    std::pair<double,double> cal_mean_rms(std::vector<double> wfm, int nbin);
+    std::pair<double,double> cal_mean_rms(const std::vector<double> &wfm, int nbin);
 
 
 
@@ -71,9 +96,28 @@ namespace wcopreco{
 
     bool filter_status;
 
+    const std::vector<double> & get_filter_v(std::vector<double> &filter_v, int nbins, bool latelight);
+    void Divide_Kernels(const double *re, const double *im, int nbins, int channel, double *out_re, double *out_im);
+    void Correct_Baseline(const std::vector<double> &inverse_res, OpWaveform &inverse_res1);
+
     std::vector<float>  op_gain;
     const std::vector<kernel_fourier_container> *kernel_container_v;
     OpWaveformCollection deconvolved_collection;
+
+    fft_engine _local_fft;
+    kernel_fourier_cache _local_kernel_cache;
+    fft_engine *_fft;
+    kernel_fourier_cache *_kernel_cache;
+    int _fft_slot;
+
+    //scratch space reused between waveforms
+    std::vector<double> re_v, im_v;
+    std::vector<double> value_re, value_im, value_re1, value_im1;
+    std::vector<double> inverse_v;
+    std::vector<double> latelight_filter_v, highfreq_filter_v;
+    //channel-major (channel x tick) blocks used by the batched path
+    std::vector<double> wfm_block;
+    std::vector<double> re_block, im_block, re1_block, im1_block;
   };
 
 }
@@ -0,0 +1,72 @@
+#include "fft_engine.h"
+
+namespace wcopreco {
+
+  fft_engine::fft_engine()
+  {}
+
+  fft_engine::~fft_engine()
+  {
+    clear_plans();
+  }
+
+  std::mutex & fft_engine::planning_mutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+
+  TVirtualFFT * fft_engine::get_plan(int nbins, fft_direction dir, int slot)
+  {
+    std::lock_guard<std::mutex> lock(planning_mutex());
+    auto key = std::make_tuple(nbins, (int)dir, slot);
+    auto it = plans.find(key);
+    if (it != plans.end()) return it->second;
+
+    // "K" keeps TVirtualFFT from reusing (and later deleting) the global
+    // current transform, the plan belongs to this engine from now on
+    TVirtualFFT *plan = TVirtualFFT::FFT(1, &nbins, dir==kR2C ? "R2C K" : "C2R K");
+    plans[key] = plan;
+    return plan;
+  }
+
+  void fft_engine::forward(int nbins, const double *in, std::vector<double> &re, std::vector<double> &im, int slot)
+  {
+    re.resize(nbins);
+    im.resize(nbins);
+    forward(nbins, in, re.data(), im.data(), slot);
+  }
+
+  void fft_engine::forward(int nbins, const double *in, double *re, double *im, int slot)
+  {
+    TVirtualFFT *fftr2c = get_plan(nbins, kR2C, slot);
+    fftr2c->SetPoints(in);
+    fftr2c->Transform();
+    fftr2c->GetPointsComplex(re, im);
+  }
+
+  void fft_engine::inverse(int nbins, const double *re, const double *im, std::vector<double> &out, int slot)
+  {
+    out.resize(nbins);
+    inverse(nbins, re, im, out.data(), slot);
+  }
+
+  void fft_engine::inverse(int nbins, const double *re, const double *im, double *out, int slot)
+  {
+    TVirtualFFT *ifft = get_plan(nbins, kC2R, slot);
+    ifft->SetPointsComplex(re, im);
+    ifft->Transform();
+    // the output of a C2R transform is real, same values as the real part of GetPointsComplex
+    ifft->GetPoints(out);
+  }
+
+  void fft_engine::clear_plans()
+  {
+    std::lock_guard<std::mutex> lock(planning_mutex());
+    for (auto it = plans.begin(); it != plans.end(); it++){
+      delete it->second;
+    }
+    plans.clear();
+  }
+
+}
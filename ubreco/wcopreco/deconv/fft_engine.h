@@ -0,0 +1,49 @@
+#ifndef FFT_ENGINE_H
+#define FFT_ENGINE_H
+
+#include "TVirtualFFT.h"
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace wcopreco {
+
+  // Owns the TVirtualFFT plans used by the deconvolution so that they are
+  // built once per (nbins, direction) and reused for every waveform instead
+  // of being planned and deleted for each transform.
+  // Plans hold their own data buffers, so each concurrent user works on its
+  // own slot; planning itself goes through planning_mutex().
+  class fft_engine {
+  public:
+    enum fft_direction {kR2C=0, kC2R=1};
+
+    fft_engine();
+    ~fft_engine();
+
+    // non-copyable, the plans are owned
+    fft_engine(const fft_engine &) = delete;
+    fft_engine & operator=(const fft_engine &) = delete;
+
+    TVirtualFFT * get_plan(int nbins, fft_direction dir, int slot = 0);
+
+    // real to complex, re/im are resized to nbins
+    void forward(int nbins, const double *in, std::vector<double> &re, std::vector<double> &im, int slot = 0);
+    void forward(int nbins, const double *in, double *re, double *im, int slot = 0);
+    // complex to real (unnormalised), out is resized to nbins
+    void inverse(int nbins, const double *re, const double *im, std::vector<double> &out, int slot = 0);
+    void inverse(int nbins, const double *re, const double *im, double *out, int slot = 0);
+
+    void clear_plans();
+
+    // TVirtualFFT planning (plugin loading, FFTW planner, global transform) is not thread safe
+    static std::mutex & planning_mutex();
+
+  protected:
+    std::map<std::tuple<int,int,int>, TVirtualFFT*> plans;
+  };
+
+}
+
+#endif
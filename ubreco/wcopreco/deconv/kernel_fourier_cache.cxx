@@ -0,0 +1,41 @@
+#include "kernel_fourier_cache.h"
+#include "fft_engine.h"
+
+namespace wcopreco {
+
+  kernel_fourier_cache::kernel_fourier_cache()
+  {}
+
+  void kernel_fourier_cache::update(int channel, float gain, int nbins, float bin_width, const kernel_fourier_container &kernel_container)
+  {
+    if (channel >= (int)entries.size()) entries.resize(channel+1);
+    cache_entry &entry = entries.at(channel);
+
+    int num_kernels = kernel_container.size();
+    if (entry.valid && entry.gain == gain && entry.nbins == nbins &&
+        entry.bin_width == bin_width && (int)entry.mag.size() == num_kernels) return;
+
+    //Get_pow_spec plans its own transform
+    std::lock_guard<std::mutex> lock(fft_engine::planning_mutex());
+    entry.mag.resize(num_kernels);
+    entry.phase.resize(num_kernels);
+    for (int n=0; n < num_kernels; n++ ) {
+      kernel_container.at(n)->Get_pow_spec(nbins, bin_width, &entry.mag.at(n), &entry.phase.at(n));
+    }
+    entry.gain = gain;
+    entry.nbins = nbins;
+    entry.bin_width = bin_width;
+    entry.valid = true;
+  }
+
+  void kernel_fourier_cache::invalidate(int channel)
+  {
+    if (channel < 0) {
+      for (auto &entry : entries) entry.valid = false;
+    }
+    else if (channel < (int)entries.size()) {
+      entries.at(channel).valid = false;
+    }
+  }
+
+}
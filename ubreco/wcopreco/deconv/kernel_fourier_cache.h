@@ -0,0 +1,48 @@
+#ifndef KERNEL_FOURIER_CACHE_H
+#define KERNEL_FOURIER_CACHE_H
+
+#include "kernel_fourier_container.h"
+
+#include <vector>
+
+namespace wcopreco {
+
+  // Per-channel cache of the kernel power spectra used by the Deconvolver.
+  // Different channels may be updated concurrently once reserve_channels() was called.
+  // The spectra only depend on the kernel shapes (fixed by the configuration),
+  // the binning and the channel gain, so they are recomputed only when one of
+  // those changes instead of resynthesising and transforming every kernel for
+  // every waveform.
+  class kernel_fourier_cache {
+  public:
+    kernel_fourier_cache();
+    ~kernel_fourier_cache() {};
+
+    // makes sure the entry for this channel matches (gain, nbins, bin_width),
+    // recomputing it from the kernel container if it does not
+    void update(int channel, float gain, int nbins, float bin_width, const kernel_fourier_container &kernel_container);
+
+    // one vector per kernel, in the order of the kernel container
+    const std::vector<std::vector<double>> & get_mag(int channel) const {return entries.at(channel).mag;}
+    const std::vector<std::vector<double>> & get_phase(int channel) const {return entries.at(channel).phase;}
+
+    void invalidate(int channel = -1);
+
+    // entries must exist before channels are updated from several threads
+    void reserve_channels(int nchannels) {if (nchannels > (int)entries.size()) entries.resize(nchannels);}
+
+  protected:
+    struct cache_entry {
+      bool valid = false;
+      float gain = 0;
+      int nbins = 0;
+      float bin_width = 0;
+      std::vector<std::vector<double>> mag;
+      std::vector<std::vector<double>> phase;
+    };
+    std::vector<cache_entry> entries;
+  };
+
+}
+
+#endif